@@ -26,6 +26,8 @@ double OptimiserAPI::meanSquaredErrorProblem1(std::shared_ptr<std::vector<std::s
 	std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> optionsPtr,
 	const double& costOfCarry, const double& discountRate, const double& initialUnderlyingPrice,
 	const double& dividendTime, const double& dividendAmount, const double& jumpTime, const double& jumpMean, const int& nTimeSteps,
+	const std::shared_ptr<models::TreeCache>& treeCache, const std::shared_ptr<models::TreeTopologyCache>& treeTopologyCache, 
+	const std::shared_ptr<utilities::Arena>& arena,
 	const std::shared_ptr<std::vector<double>>& volatilitiesToOptimise, const int& D)
 {
 	if (optionsPtr->size() != optionPricesPtr->size())
@@ -34,9 +36,12 @@ double OptimiserAPI::meanSquaredErrorProblem1(std::shared_ptr<std::vector<std::s
 	// Construct the model object
 	auto blackScholesSingleNormalJumpModel = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, volatilitiesToOptimise->at(0), 
 		initialUnderlyingPrice,	UnderlyingCode::BHP, dividendTime, dividendAmount, jumpTime, jumpMean, volatilitiesToOptimise->at(1));
+	blackScholesSingleNormalJumpModel->setTreeTopologyCache(treeTopologyCache);
 
 	// Construct the pricer object
 	TreePricer treePricer(blackScholesSingleNormalJumpModel);
+	treePricer.setTreeCache(treeCache);
+	treePricer.setArena(arena);
 
 	auto meanSquareError = 0.0;
 	auto averagingFactor = 1.0 / (double)optionsPtr->size();
@@ -61,8 +66,13 @@ std::shared_ptr<std::vector<double>> OptimiserAPI::optimiseProblem1(const std::s
 	shared_ptr<vector<shared_ptr<VanillaOption>>> optionsPtr;
 	tie(optionPricesPtr, optionsPtr) = AmericanOptionJSONReader(jsonInputFilePath);
 
+	// Trees are shared by the evaluations of the objective function with the same parameters, and the topologies of the trees by all of the
+	// evaluations
+	auto treeCache = make_shared<TreeCache>(512 * 1024 * 1024);
+	auto treeTopologyCache = make_shared<TreeTopologyCache>(256 * 1024 * 1024);
+	auto arena = make_shared<utilities::Arena>(); // the scratch memory of each pricing is reused by the next
 	auto pricingFunctionPtr = bind(meanSquaredErrorProblem1, optionPricesPtr, optionsPtr, costOfCarry, discountRate, initialUnderlyingPrice,
-		dividendTime, dividendAmount, jumpTime, jumpMean, nTimeSteps, _1, _2);
+		dividendTime, dividendAmount, jumpTime, jumpMean, nTimeSteps, treeCache, treeTopologyCache, arena, _1, _2);
 
 	DifferentialEvolution optimiser(2, F, CR, lowerBounds, upperBounds, pricingFunctionPtr, Implementation::One, N, seed);
 	auto solution = optimiser.solve(tolerance);
@@ -79,6 +89,8 @@ std::shared_ptr<std::vector<double>> OptimiserAPI::optimiseProblem1(const std::s
 double OptimiserAPI::meanSquaredErrorProblem2(std::shared_ptr<std::vector<std::shared_ptr<double>>> optionPricesPtr,
 	std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> optionsPtr,
 	const double& initialUnderlyingPrice, const double& dividendTime, const double& jumpTime, const double& jumpMean, const int& nTimeSteps,
+	const std::shared_ptr<models::TreeCache>& treeCache, const std::shared_ptr<models::TreeTopologyCache>& treeTopologyCache, 
+	const std::shared_ptr<utilities::Arena>& arena,
 	const std::shared_ptr<std::vector<double>>& parametersToOptimise, const int& D)
 {
 	if (optionsPtr->size() != optionPricesPtr->size())
@@ -93,9 +105,12 @@ double OptimiserAPI::meanSquaredErrorProblem2(std::shared_ptr<std::vector<std::s
 		parametersToOptimise->at(3), 
 		jumpTime, jumpMean, 
 		parametersToOptimise->at(4));
+	blackScholesSingleNormalJumpModel->setTreeTopologyCache(treeTopologyCache);
 
 	// Construct the pricer object
 	TreePricer treePricer(blackScholesSingleNormalJumpModel);
+	treePricer.setTreeCache(treeCache);
+	treePricer.setArena(arena);
 
 	auto meanSquareError = 0.0;
 	auto averagingFactor = 1.0 / (double)optionsPtr->size();
@@ -118,8 +133,13 @@ std::shared_ptr<std::vector<double>> OptimiserAPI::optimiseProblem2(const std::s
 	shared_ptr<vector<shared_ptr<VanillaOption>>> optionsPtr;
 	tie(optionPricesPtr, optionsPtr) = AmericanOptionJSONReader(jsonInputFilePath);
 
+	// Trees are shared by the evaluations of the objective function with the same parameters, and the topologies of the trees by all of the
+	// evaluations
+	auto treeCache = make_shared<TreeCache>(512 * 1024 * 1024);
+	auto treeTopologyCache = make_shared<TreeTopologyCache>(256 * 1024 * 1024);
+	auto arena = make_shared<utilities::Arena>(); // the scratch memory of each pricing is reused by the next
 	auto pricingFunctionPtr = bind(meanSquaredErrorProblem2, optionPricesPtr, optionsPtr, initialUnderlyingPrice,
-		dividendTime, jumpTime, jumpMean, nTimeSteps, _1, _2);
+		dividendTime, jumpTime, jumpMean, nTimeSteps, treeCache, treeTopologyCache, arena, _1, _2);
 
 	DifferentialEvolution optimiser(5, F, CR, lowerBounds, upperBounds, pricingFunctionPtr, Implementation::One, N, seed);
 	auto solution = optimiser.solve(tolerance);
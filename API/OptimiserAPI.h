@@ -5,6 +5,9 @@
 #include <memory>
 #include "JSONUtilities.h"
 #include "../Instruments/VanillaOption.h"
+#include "../Models/TreeModelUtilities/TreeCache.h"
+#include "../Models/TreeModelUtilities/TreeTopologyCache.h"
+#include "../Utilities/Arena.h"
 
 
 class OptimiserAPI
@@ -23,6 +26,8 @@ public:
 		std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> optionsPtr,
 		const double& costOfCarry, const double& discountRate, const double& initialUnderlyingPrice,
 		const double& dividendTime, const double& dividendAmount, const double& jumpTime, const double& jumpMean, const int& nTimeSteps,
+		const std::shared_ptr<models::TreeCache>& treeCache, const std::shared_ptr<models::TreeTopologyCache>& treeTopologyCache, 
+		const std::shared_ptr<utilities::Arena>& arena,
 		const std::shared_ptr<std::vector<double>>& volatilitiesToOptimise, const int& D);
 
 
@@ -36,6 +41,8 @@ public:
 	static double meanSquaredErrorProblem2(std::shared_ptr<std::vector<std::shared_ptr<double>>> optionPricesPtr,
 		std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> optionsPtr,
 		const double& initialUnderlyingPrice, const double& dividendTime, const double& jumpTime, const double& jumpMean, const int& nTimeSteps,
+		const std::shared_ptr<models::TreeCache>& treeCache, const std::shared_ptr<models::TreeTopologyCache>& treeTopologyCache, 
+		const std::shared_ptr<utilities::Arena>& arena,
 		const std::shared_ptr<std::vector<double>>& parametersToOptimise, const int& D);
 
 private:
@@ -12,6 +12,9 @@ using namespace instruments;
 using namespace enumerations;
 using namespace pricers;
 
+std::shared_ptr<models::TreeCache> PricingAPI::m_treeCache = nullptr;
+std::shared_ptr<models::TreeTopologyCache> PricingAPI::m_treeTopologyCache = nullptr;
+
 // Black Scholes price for an American option. The last parameter determines the length of the time step in the tree
 double PricingAPI::price(const double & strike, const bool & is_call, const double & s_0, const double & r, const double & q, const double & T, 
 	const double & sigma, const double& timeStepSize)
@@ -53,6 +56,7 @@ double PricingAPI::price(const double & strike, const bool & is_call, const doub
 	auto underlyingCode = UnderlyingCode::BHP; // this is just a dummy
 	auto blackScholesSingleNormalJumpModel = make_shared<models::BlackScholesSingleNormalJump>(q, r, sigma, s_0, underlyingCode, t_div, div,
 		jumpTime, jumpMean, jumpVol);
+	blackScholesSingleNormalJumpModel->setTreeTopologyCache(m_treeTopologyCache);
 
 	// Construct Vanilla Option
 	auto vanillaOptionsPtr = constructVanillaOptionsPtr(strike, is_call, T);
@@ -71,6 +75,7 @@ double PricingAPI::price(const double & strike, const bool & is_call, const doub
 	auto underlyingCode = UnderlyingCode::BHP; // this is just a dummy
 	auto blackScholesDoubleNormalJumpModel = make_shared<models::BlackScholesDoubleNormalJump>(q, r, sigma, s_0, underlyingCode, t_div, div,
 		jumpTime, jumpMean1, jumpVol1, jumpMean2, jumpVol2, bernoulliProbability);
+	blackScholesDoubleNormalJumpModel->setTreeTopologyCache(m_treeTopologyCache);
 
 	// Construct Vanilla Option
 	auto vanillaOptionsPtr = constructVanillaOptionsPtr(strike, is_call, T);
@@ -102,6 +107,7 @@ double PricingAPI::constructTreePrice(const std::shared_ptr<models::ITreeModel>&
 {
 	// Construct Pricer
 	TreePricer treePricer(model);
+	treePricer.setTreeCache(m_treeCache);
 
 	// Price option
 	auto price = treePricer.priceWithRichardsonExtrapolation(timeStepSize, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
@@ -151,6 +157,9 @@ void PricingAPI::priceVanillaOptionsBlackScholesDoubleNormalJumpModel(const std:
 	// Initialise the container for the option prices
 	unordered_map<int, shared_ptr<double>> optionPrices;
 
+	// The trees of the models with the same jump time share their topologies, even if the topologies are not cached across calls
+	auto treeTopologyCache = m_treeTopologyCache != nullptr ? m_treeTopologyCache : make_shared<TreeTopologyCache>(256 * 1024 * 1024);
+
 	// For each model, price the set of options
 	for (auto it1 = options.begin(); it1 != options.end(); it1++)
 	{
@@ -211,9 +220,11 @@ void PricingAPI::priceVanillaOptionsBlackScholesDoubleNormalJumpModel(const std:
 										auto blackScholesDoubleNormalJumpModel = make_shared<models::BlackScholesDoubleNormalJump>(
 											costOfCarry, discountRate, impliedVolatility, uPrice, UnderlyingCode::BHP, dividendTime,
 											dividendAmount, jumpTime, jMean1, jVol1, jMean2, jVol2, bernoulliProbability);
+										blackScholesDoubleNormalJumpModel->setTreeTopologyCache(treeTopologyCache);
 
 										// Construct the pricer object
 										TreePricer treePricer(blackScholesDoubleNormalJumpModel);
+										treePricer.setTreeCache(m_treeCache);
 
 										vector<shared_ptr<double>> treePrices;
 										auto options10Ptr = make_shared<vector<shared_ptr<VanillaOption>>>(options10);
@@ -252,9 +263,11 @@ void PricingAPI::priceAmericanOptionsBlackScholesSingleNormalJumpModel(const std
 	// Construct the model object
 	auto blackScholesSingleNormalJumpModel = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, impliedVolatility, 
 		initialUnderlyingPrice,	UnderlyingCode::BHP, dividendTime, dividendAmount, jumpTime, jumpMean, jumpVolatility);
+	blackScholesSingleNormalJumpModel->setTreeTopologyCache(m_treeTopologyCache);
 
 	// Construct the pricer object
 	TreePricer treePricer(blackScholesSingleNormalJumpModel);
+	treePricer.setTreeCache(m_treeCache);
 
 	vector<shared_ptr<double>> treePrices;
 	auto treePricesPtr = treePricer.priceWithRichardsonExtrapolation(nTimeSteps, optionsPtr, true, Implementation::One, 6.0, -6.0);
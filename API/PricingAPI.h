@@ -6,6 +6,8 @@
 #include "JSONUtilities.h"
 #include "../Instruments/VanillaOption.h"
 #include "../Models/TreeModelUtilities/ITreeModel.h" 
+#include "../Models/TreeModelUtilities/TreeCache.h"
+#include "../Models/TreeModelUtilities/TreeTopologyCache.h"
 
 
 class PricingAPI
@@ -35,11 +37,21 @@ public:
 		const double& dividendTime, const double& dividendAmount, const double& jumpTime, const double& jumpMean, const double& jumpVolatility,
 		const int& nTimeSteps);
 
+	// Optional cache of trees shared by all of the pricing functions, so that repeated requests with identical inputs reuse their trees
+	static const std::shared_ptr<models::TreeCache> getTreeCache() { return m_treeCache; }
+	static void setTreeCache(const std::shared_ptr<models::TreeCache>& value) { m_treeCache = value; }
+
+	// Optional cache of the topologies of the jump diffusion trees shared by all of the pricing functions
+	static const std::shared_ptr<models::TreeTopologyCache> getTreeTopologyCache() { return m_treeTopologyCache; }
+	static void setTreeTopologyCache(const std::shared_ptr<models::TreeTopologyCache>& value) { m_treeTopologyCache = value; }
 
 
 private:
 	PricingAPI() {};
 
+	static std::shared_ptr<models::TreeCache> m_treeCache; // nullptr if trees are not cached
+	static std::shared_ptr<models::TreeTopologyCache> m_treeTopologyCache; // nullptr if topologies are not cached
+
 	static std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> constructVanillaOptionsPtr(const double & strike, 
 		const bool & is_call, const double & T);
 
@@ -0,0 +1,16 @@
+#ifndef __IMPLIEDVOLATILITYSTATUS_H__
+#define __IMPLIEDVOLATILITYSTATUS_H__
+
+namespace enumerations
+{
+	// Enumeration of the outcome of the inversion of an option price to its implied volatility
+	enum class ImpliedVolatilityStatus
+	{
+		converged,
+		notConverged, // the iterations ran out before the tolerance was reached, and the last iterate is returned
+		belowIntrinsic, // the price is below the intrinsic value of the option, so there is no implied volatility
+		aboveMaximum, // the price is at or above the value of the option for an infinite volatility
+	};
+}
+
+#endif // !__IMPLIEDVOLATILITYSTATUS_H__
@@ -0,0 +1,15 @@
+#ifndef __KERNELIMPLEMENTATION_H__
+#define __KERNELIMPLEMENTATION_H__
+
+namespace enumerations
+{
+	// Enumeration of the instruction sets of the vectorised kernels
+	enum class KernelImplementation
+	{
+		scalar, // portable C++, always supported
+		avx2, // x86-64 AVX2, 4 doubles per instruction
+		avx512, // x86-64 AVX-512, 8 doubles per instruction
+	};
+}
+
+#endif // !__KERNELIMPLEMENTATION_H__
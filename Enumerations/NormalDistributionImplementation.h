@@ -0,0 +1,14 @@
+#ifndef __NORMALDISTRIBUTIONIMPLEMENTATION_H__
+#define __NORMALDISTRIBUTIONIMPLEMENTATION_H__
+
+namespace enumerations
+{
+	// Enumeration of the implementation of the standard normal distribution functions used by the analytic and smoothing calculations
+	enum class NormalDistributionImplementation
+	{
+		boost, // boost::math::normal
+		fast, // utilities::NormalDistribution, which is vectorisable, with a documented maximum error
+	};
+}
+
+#endif // !__NORMALDISTRIBUTIONIMPLEMENTATION_H__
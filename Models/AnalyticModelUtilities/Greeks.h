@@ -0,0 +1,20 @@
+#ifndef __GREEKS_H__
+#define __GREEKS_H__
+
+namespace models
+{
+	// The price of an option and its sensitivities, as a flat struct so that arrays of them can be filled without allocation. The
+	// sensitivities are with respect to absolute changes, i.e. vega is per unit of volatility and rho is per unit of the discount rate, and 
+	// theta is the change in the price per year of calendar time, i.e. with the time to expiry decreasing.
+	struct Greeks
+	{
+		double price = 0.0;
+		double delta = 0.0; // first derivative with respect to the underlying price
+		double gamma = 0.0; // second derivative with respect to the underlying price
+		double vega = 0.0; // derivative with respect to the implied volatility
+		double theta = 0.0; // derivative with respect to calendar time
+		double rho = 0.0; // derivative with respect to the discount rate
+	};
+}
+
+#endif // !__GREEKS_H__
@@ -5,6 +5,8 @@
 #include "../Enumerations/OptionRight.h"
 #include "../Enumerations/UnderlyingCode.h"
 #include "../Enumerations/ExerciseType.h"
+#include "../Enumerations/NormalDistributionImplementation.h"
+#include "Greeks.h"
 
 namespace models
 {
@@ -14,7 +16,13 @@ namespace models
 		virtual ~IAnalyticModel() = default;
 		virtual const enumerations::UnderlyingCode& getUnderlyingCode() const = 0;
 		virtual const std::shared_ptr<double> calculateAnalyticSolution(const double& strike, const double& timeToExpiry,
-			const enumerations::OptionRight& optionRight, const enumerations::ExerciseType& exerciseType) = 0;
+			const enumerations::OptionRight& optionRight, const enumerations::ExerciseType& exerciseType,
+			const enumerations::NormalDistributionImplementation& normalDistributionImplementation = 
+			enumerations::NormalDistributionImplementation::boost) = 0;
+		virtual const models::Greeks calculateAnalyticGreeks(const double& strike, const double& timeToExpiry,
+			const enumerations::OptionRight& optionRight, const enumerations::ExerciseType& exerciseType,
+			const enumerations::NormalDistributionImplementation& normalDistributionImplementation = 
+			enumerations::NormalDistributionImplementation::boost) = 0; // the price and the sensitivities from a single evaluation
 	};
 }
 
@@ -1,8 +1,11 @@
 #include <cmath>
 #include <random>
+#include <algorithm>
 #include <boost/math/distributions/normal.hpp>
 #include "BlackScholes.h"
 #include "TreeModelUtilities/LogNormalDiffusionTreeHelper.h"
+#include "../Utilities/NormalDistribution.h"
+#include "../Utilities/NormalVariateGenerator.h"
 
 using namespace std;
 using namespace models;
@@ -38,7 +41,7 @@ void models::BlackScholes::setInitialUnderlyingPrice(const double& value)
 
 // Classical Black Scholes Equation for the price of a European option
 const std::shared_ptr<double> models::BlackScholes::calculateAnalyticSolution(const double& strike, const double& timeToExpiry,
-	const OptionRight& optionRight, const ExerciseType& exerciseType)
+	const OptionRight& optionRight, const ExerciseType& exerciseType, const NormalDistributionImplementation& normalDistributionImplementation)
 {
 	// Input validation
 	if (exerciseType != ExerciseType::european)
@@ -54,14 +57,62 @@ const std::shared_ptr<double> models::BlackScholes::calculateAnalyticSolution(co
 
 	// Price 
 	auto callSign = optionRight == OptionRight::call ? 1.0 : -1.0;
+	auto isFast = normalDistributionImplementation == NormalDistributionImplementation::fast;
+	auto cdfD1 = isFast ? utilities::NormalDistribution::cdf(callSign * d1) : boost::math::cdf(z, callSign * d1);
+	auto cdfD2 = isFast ? utilities::NormalDistribution::cdf(callSign * d2) : boost::math::cdf(z, callSign * d2);
 	auto price = callSign * exp(-1. * m_discountRate * timeToExpiry) * (
-		m_initialUnderlyingPrice * exp((m_discountRate - m_costOfCarry) * timeToExpiry) * boost::math::cdf(z, callSign * d1) - 
-		strike * boost::math::cdf(z, callSign * d2)
+		m_initialUnderlyingPrice * exp((m_discountRate - m_costOfCarry) * timeToExpiry) * cdfD1 - 
+		strike * cdfD2
 		);
 	auto pricePtr = make_shared<double>(move(price));
 	return pricePtr;
 }
 
+// Price and Greeks of a European option from a single evaluation of the Black Scholes equation. The Greeks share d1 and d2, the discount
+// and carry factors, and the normal distribution values with the price, which is exactly that of calculateAnalyticSolution. With q the cost
+// of carry and sign 1 for calls and -1 for puts:
+//     delta = sign exp(-qT) N(sign d1), gamma = exp(-qT) n(d1) / (S sigma sqrt(T)), vega = S exp(-qT) n(d1) sqrt(T)
+//     theta = -S exp(-qT) n(d1) sigma / (2 sqrt(T)) - sign r K exp(-rT) N(sign d2) + sign q S exp(-qT) N(sign d1)
+//     rho = sign K T exp(-rT) N(sign d2)
+const models::Greeks models::BlackScholes::calculateAnalyticGreeks(const double& strike, const double& timeToExpiry,
+	const OptionRight& optionRight, const ExerciseType& exerciseType, const NormalDistributionImplementation& normalDistributionImplementation)
+{
+	// Input validation
+	if (exerciseType != ExerciseType::european)
+		throw invalid_argument("This model only supports European vanilla options.");
+
+	// Compute d1 and d2
+	boost::math::normal z; // normal variate with mean 0 and variance 1
+	auto sqrtTimeToExpiry = sqrt(timeToExpiry);
+	auto d1 = (log(m_initialUnderlyingPrice / strike) + timeToExpiry * (m_discountRate - m_costOfCarry + pow(m_impliedVolatility, 2) / 2.0)) / 
+		(m_impliedVolatility*sqrtTimeToExpiry);
+	auto d2 = d1 - m_impliedVolatility * sqrtTimeToExpiry;
+
+	// Terms shared by the price and the Greeks
+	auto callSign = optionRight == OptionRight::call ? 1.0 : -1.0;
+	auto isFast = normalDistributionImplementation == NormalDistributionImplementation::fast;
+	auto cdfD1 = isFast ? utilities::NormalDistribution::cdf(callSign * d1) : boost::math::cdf(z, callSign * d1);
+	auto cdfD2 = isFast ? utilities::NormalDistribution::cdf(callSign * d2) : boost::math::cdf(z, callSign * d2);
+	auto pdfD1 = isFast ? utilities::NormalDistribution::pdf(d1) : boost::math::pdf(z, d1);
+	auto discountFactor = exp(-1. * m_discountRate * timeToExpiry);
+	auto carryFactor = exp((m_discountRate - m_costOfCarry) * timeToExpiry);
+	auto forwardPrice = m_initialUnderlyingPrice * carryFactor;
+	auto discountedForwardPrice = discountFactor * forwardPrice; // i.e. S exp(-qT)
+	auto discountedStrike = discountFactor * strike;
+
+	// Price and Greeks
+	Greeks greeks;
+	greeks.price = callSign * discountFactor * (forwardPrice * cdfD1 - strike * cdfD2);
+	greeks.delta = callSign * discountFactor * carryFactor * cdfD1;
+	greeks.gamma = discountFactor * carryFactor * pdfD1 / 
+		(m_initialUnderlyingPrice * m_impliedVolatility * sqrtTimeToExpiry);
+	greeks.vega = discountedForwardPrice * pdfD1 * sqrtTimeToExpiry;
+	greeks.theta = -discountedForwardPrice * pdfD1 * m_impliedVolatility / (2.0 * sqrtTimeToExpiry) 
+		- callSign * m_discountRate * discountedStrike * cdfD2 + callSign * m_costOfCarry * discountedForwardPrice * cdfD1;
+	greeks.rho = callSign * discountedStrike * timeToExpiry * cdfD2;
+	return greeks;
+}
+
 
 //// Functions for the Monte Carlo simulation of vanilla option payoffs
 // ============================================================================ 
@@ -69,28 +120,38 @@ const std::shared_ptr<double> models::BlackScholes::calculateAnalyticSolution(co
 //// Monte carlo simulation of the underlying price at a future time 
 const std::shared_ptr<vector<double>> models::BlackScholes::generateMonteCarloSimulations(const int& nPaths, const double& time, int seed)
 {
-	// Construct a standard normal distribution
 	if (seed == -1) // if the seed is equal to -1, then generate a random seed
 	{
 		random_device rd;
 		seed = rd();
 	}
 
-	mt19937 mersenneTwisterEngine(seed);
-	normal_distribution<> normalDistribution{ 0,1 };
+	vector<double> simulatedPrices(nPaths);
+	generateMonteCarloSimulations(nPaths, time, (uint32_t)seed, 0, simulatedPrices.data());
+	auto simulatedPricesPtr = make_shared<vector<double>>(move(simulatedPrices));
+	return simulatedPricesPtr;
+}
+
+
+//// Simulates the underlying price at the time for the paths from firstPath to firstPath + nPaths - 1, and writes them to simulatedPrices.
+//// Each path is drawn from the substream of the key with the index of the path, so that it does not depend on any of the other paths. The
+//// normals are generated for a chunk of paths at a time.
+void models::BlackScholes::generateMonteCarloSimulations(const int& nPaths, const double& time, const uint64_t& key, 
+	const uint64_t& firstPath, double* simulatedPrices)
+{
+	auto drift = (m_discountRate - m_costOfCarry - 0.5 * pow(m_impliedVolatility, 2)) * time;
+	auto standardDeviation = m_impliedVolatility * sqrt(time);
 
 	// Simulate normals, and calculate the underlying price
-	vector<double> simulatedPrices;
-	simulatedPrices.reserve(nPaths);
-	for (int i = 0; i < nPaths; i++)
+	utilities::NormalVariateGenerator normalVariateGenerator(key);
+	for (int first = 0; first < nPaths; first += utilities::NormalVariateGenerator::chunkSize)
 	{
-		auto simulatedNormal = normalDistribution(mersenneTwisterEngine);
-		auto simulatedPrice = m_initialUnderlyingPrice * exp((m_discountRate - m_costOfCarry - 0.5 * pow(m_impliedVolatility, 2)) * time
-			+ m_impliedVolatility * sqrt(time) * simulatedNormal);
-		simulatedPrices.push_back(simulatedPrice);
+		auto n = min(utilities::NormalVariateGenerator::chunkSize, nPaths - first);
+		normalVariateGenerator.setChunk(firstPath + first, n);
+		auto simulatedNormals = normalVariateGenerator.normals(0);
+		for (int j = 0; j < n; j++)
+			simulatedPrices[first + j] = m_initialUnderlyingPrice * exp(drift + standardDeviation * simulatedNormals[j]);
 	}
-	auto simulatedPricesPtr = make_shared<vector<double>>(move(simulatedPrices));
-	return simulatedPricesPtr;
 }
 
 
@@ -116,13 +177,44 @@ const std::shared_ptr<models::Tree> models::BlackScholes::constructTree(const in
 	// This model does not support dividends. Hence, set dividend amount to 0, and the dividend payment date to after the time to expiry
 	auto dividendTime = timeToExpiry + 1.0;
 	auto dividendAmount = 0.0;
-	auto treeNodesPtr = LogNormalDiffusionTreeHelper::constructRecombiningTree(m_initialUnderlyingPrice, nTimeSteps, timeToExpiry, m_impliedVolatility,
+	auto treePtr = LogNormalDiffusionTreeHelper::constructRecombiningTree(m_initialUnderlyingPrice, nTimeSteps, timeToExpiry, m_impliedVolatility,
 		upperLimitStandardDeviation, lowerLimitStandardDeviation, dividendTime, dividendAmount, diffusionStatesPtr, diffusionProbabilitiesPtr);
-	auto treePtr = make_shared<Tree>(treeNodesPtr, nTimeSteps, timeToExpiry);
 	return treePtr;
 }
 
 
+//// Constructs the binomial recombining tree as an implicit lattice, i.e. the underlying price at each node is calculated on the fly during
+//// pricing rather than being stored. The lattice is identical to that of constructTree, but only requires O(nTimeSteps) memory.
+const std::shared_ptr<models::RecombiningLattice> models::BlackScholes::constructRecombiningLattice(const int& nTimeSteps, 
+	const double& timeToExpiry, const enumerations::Implementation implementation, const double upperLimitStandardDeviation, 
+	const double lowerLimitStandardDeviation)
+{
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+
+	shared_ptr<vector<double>> diffusionStatesPtr, diffusionProbabilitiesPtr;
+	tie(diffusionStatesPtr, diffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateDiffusionStatesAndProbabilities(timeStepSize, 
+		m_impliedVolatility, m_discountRate, m_costOfCarry, implementation);
+
+	// This model does not support dividends. Hence, set dividend amount to 0, and the dividend payment date to after the time to expiry
+	auto dividendTime = timeToExpiry + 1.0;
+	auto dividendAmount = 0.0;
+	auto latticePtr = LogNormalDiffusionTreeHelper::constructRecombiningLattice(m_initialUnderlyingPrice, nTimeSteps, timeToExpiry, 
+		m_impliedVolatility, upperLimitStandardDeviation, lowerLimitStandardDeviation, dividendTime, dividendAmount, diffusionStatesPtr, 
+		diffusionProbabilitiesPtr);
+	return latticePtr;
+}
+
+
+//// Estimates the size of the tree from the implicit lattice, which has the same nodes as the tree, but only requires O(nTimeSteps) memory
+const models::TreeSizeEstimate models::BlackScholes::estimateTreeSize(const int& nTimeSteps, const double& timeToExpiry, 
+	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation)
+{
+	auto latticePtr = constructRecombiningLattice(nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, 
+		lowerLimitStandardDeviation);
+	return LogNormalDiffusionTreeHelper::estimateRecombiningTreeSize(latticePtr);
+}
+
+
 //// Calculates the option value at the current tree node with smoothing
 const std::shared_ptr<double> models::BlackScholes::smoothedValueAtTreeNode(const double underlyingPrice, 
 	const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize)
@@ -138,6 +230,16 @@ const std::shared_ptr<double> models::BlackScholes::smoothedValueAtTreeNode(cons
 	return valuePtr;
 }
 
+//// Calculates the option values at all of the nodes of a level with smoothing, with a single Black Scholes evaluation over the level
+void models::BlackScholes::smoothedValuesAtTreeNodes(const double* underlyingPrices, const int nNodes, 
+	const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize, double* smoothedValues,
+	const enumerations::NormalDistributionImplementation normalDistributionImplementation)
+{
+	LogNormalDiffusionTreeHelper::treeNodeEuropeanOptionValues(m_costOfCarry, m_discountRate, m_impliedVolatility, underlyingPrices, nNodes,
+		vanillaOption->getStrike(), timeStepSize, vanillaOption->getOptionRight(), smoothedValues,
+		normalDistributionImplementation);
+}
+
 const bool models::BlackScholes::supportsVanillaOptionSmoothing(const double & timeStart, const double & timeEnd)
 {
 	return m_supportsVanillaOptionSmoothing;
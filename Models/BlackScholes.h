@@ -39,17 +39,34 @@ namespace models
 
 		// Analytic Pricing functions
 		const std::shared_ptr<double> calculateAnalyticSolution(const double& strike, const double& timeToExpiry, 
-			const enumerations::OptionRight& optionRight, const enumerations::ExerciseType& exerciseType);
+			const enumerations::OptionRight& optionRight, const enumerations::ExerciseType& exerciseType,
+			const enumerations::NormalDistributionImplementation& normalDistributionImplementation = 
+			enumerations::NormalDistributionImplementation::boost);
+		const models::Greeks calculateAnalyticGreeks(const double& strike, const double& timeToExpiry, 
+			const enumerations::OptionRight& optionRight, const enumerations::ExerciseType& exerciseType,
+			const enumerations::NormalDistributionImplementation& normalDistributionImplementation = 
+			enumerations::NormalDistributionImplementation::boost);
 
 		// Monte Carlo Pricing functions
 		const std::shared_ptr<std::vector<double>> generateMonteCarloSimulations(const int& nPaths, const double& time, int seed = -1);
+		void generateMonteCarloSimulations(const int& nPaths, const double& time, const uint64_t& key, const uint64_t& firstPath, 
+			double* simulatedPrices);
 
 		// Tree Pricing functions
 		const std::shared_ptr<models::Tree> constructTree(const int& nTimeSteps, const double& timeToExpiry, 
 			const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation);
 		const std::shared_ptr<double> smoothedValueAtTreeNode(const double underlyingPrice,
 			const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize);
+		void smoothedValuesAtTreeNodes(const double* underlyingPrices, const int nNodes, 
+			const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize, double* smoothedValues,
+			const enumerations::NormalDistributionImplementation normalDistributionImplementation);
 		const bool supportsVanillaOptionSmoothing(const double& timeStart, const double & timeEnd);
+		const std::vector<double> getTreeParameters() const { return { m_costOfCarry, m_discountRate, m_impliedVolatility, m_initialUnderlyingPrice }; }
+		const bool supportsRecombiningLattice() const { return true; }
+		const std::shared_ptr<models::RecombiningLattice> constructRecombiningLattice(const int& nTimeSteps, const double& timeToExpiry,
+			const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation);
+		const models::TreeSizeEstimate estimateTreeSize(const int& nTimeSteps, const double& timeToExpiry,
+			const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation);
 
 		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
 		BlackScholes& operator = (BlackScholes const&) = delete;
@@ -4,10 +4,12 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <tuple>
 #include "AnalyticModelUtilities/IAnalyticModel.h"
 #include "MonteCarloModelUtilities/IMonteCarloModel.h"
 #include "TreeModelUtilities/ITreeModel.h"
 #include "TreeModelUtilities/Tree.h"
+#include "TreeModelUtilities/TreeTopologyCache.h"
 #include "../Enumerations/OptionRight.h"
 #include "../Enumerations/UnderlyingCode.h"
 #include "../Enumerations/ExerciseType.h"
@@ -39,6 +41,8 @@ namespace models
 		const double& getJumpMean2() const { return m_jumpMean2; }
 		const double& getJumpVolatility2() const { return m_jumpVolatility2; }
 		const double& getBernoulliProbability() const { return m_bernoulliProbability; }
+		const bool& getRecombineAfterJump() const { return m_recombineAfterJump; }
+		const std::shared_ptr<models::TreeTopologyCache> getTreeTopologyCache() const { return m_treeTopologyCache; }
 
 		// Setters
 		void setCostOfCarry(const double& value) { m_costOfCarry = value; }
@@ -54,17 +58,29 @@ namespace models
 		void setJumpMean2(const double& value) { m_jumpMean2 = value; }
 		void setJumpVolatility2(const double& value);
 		void setBernoulliProbability(const double& value);
+		void setRecombineAfterJump(const bool& value) { m_recombineAfterJump = value; } // snap the states after the jump onto a grid, keeping only their mean and variance. Tree construction throws if the grid is too coarse for the variance.
+		void setTreeTopologyCache(const std::shared_ptr<models::TreeTopologyCache>& value) { m_treeTopologyCache = value; } // nullptr to construct every topology
 
 		// Monte Carlo Pricing functions
 		const std::shared_ptr<std::vector<double>> generateMonteCarloSimulations(const int& nPaths, const double& time, int seed = -1);
+		void generateMonteCarloSimulations(const int& nPaths, const double& time, const uint64_t& key, const uint64_t& firstPath, 
+			double* simulatedPrices);
 
 		// Tree Pricing functions
 		const std::shared_ptr<models::Tree> constructTree(const int& nTimeSteps, const double& timeToExpiry, 
 			const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation);
+		const models::TreeSizeEstimate estimateTreeSize(const int& nTimeSteps, const double& timeToExpiry,
+			const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation);
 
 		const std::shared_ptr<double> smoothedValueAtTreeNode(const double underlyingPrice,
 			const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize);
+		void smoothedValuesAtTreeNodes(const double* underlyingPrices, const int nNodes, 
+			const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize, double* smoothedValues,
+			const enumerations::NormalDistributionImplementation normalDistributionImplementation);
 		const bool supportsVanillaOptionSmoothing(const double& timeStart, const double& timeEnd);
+		const std::vector<double> getTreeParameters() const { return { m_costOfCarry, m_discountRate, m_impliedVolatility, 
+			m_initialUnderlyingPrice, m_dividendTime, m_dividendAmount, m_jumpTime, m_jumpMean1, m_jumpVolatility1, m_jumpMean2, 
+			m_jumpVolatility2, m_bernoulliProbability, (double)m_recombineAfterJump }; }
 
 		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
 		BlackScholesDoubleNormalJump& operator = (BlackScholesDoubleNormalJump const&) = delete;
@@ -84,8 +100,14 @@ namespace models
 		double m_jumpMean2;
 		double m_jumpVolatility2;
 		double m_bernoulliProbability;
+		bool m_recombineAfterJump = false; // whether the tree recombines after the jump, rather than branching out from every node
+		std::shared_ptr<models::TreeTopologyCache> m_treeTopologyCache; // topologies are only shared across trees if a cache has been provided
 		const static bool m_supportsVanillaOptionSmoothing = true;
 
+		const std::tuple<std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vector<double>>, 
+			std::shared_ptr<std::vector<double>>> calculateTreeStatesAndProbabilities(const int& nTimeSteps, const double& timeToExpiry, 
+			const enumerations::Implementation implementation);
+
 	};
 }
 
@@ -1,10 +1,12 @@
 #include <cmath>
 #include <random>
+#include <algorithm>
 #include <math.h>
 #include <boost/math/distributions/normal.hpp>
 #include "BlackScholesSingleNormalJump.h"
 #include "BlackScholes.h"
 #include "TreeModelUtilities/LogNormalDiffusionTreeHelper.h"
+#include "../Utilities/NormalVariateGenerator.h"
 
 using namespace std;
 using namespace models;
@@ -77,7 +79,6 @@ void models::BlackScholesSingleNormalJump::setDividendAmount(const double& value
 const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::generateMonteCarloSimulations(const int& nPaths, const double& time, 
 	int seed)
 {
-	// Construct a standard normal distribution
 	auto modSeed = seed;
 	if (seed == -1) // if the seed is equal to -1, then generate a random seed
 	{
@@ -85,12 +86,22 @@ const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::gene
 		modSeed = rd();
 	}
 
-	mt19937 mersenneTwisterEngine(modSeed);
-	normal_distribution<> normalDistribution{ 0,1 };
+	vector<double> simulatedPrices(nPaths);
+	generateMonteCarloSimulations(nPaths, time, (uint32_t)modSeed, 0, simulatedPrices.data());
+	auto simulatedPricesPtr = make_shared<vector<double>>(move(simulatedPrices));
+	return simulatedPricesPtr;
+}
+
+
+//// Simulates the underlying price at the time for the paths from firstPath to firstPath + nPaths - 1, and writes them to simulatedPrices.
+//// Each path is drawn from the substream of the key with the index of the path, so that it does not depend on any of the other paths.
+void models::BlackScholesSingleNormalJump::generateMonteCarloSimulations(const int& nPaths, const double& time, const uint64_t& key, 
+	const uint64_t& firstPath, double* simulatedPrices)
+{
+	// Construct the generator of the normals, which are generated for a chunk of paths at a time
+	utilities::NormalVariateGenerator normalVariateGenerator(key);
 
 	// Simulate normals, and calculate the underlying price
-	vector<double> simulatedPrices;
-	simulatedPrices.reserve(nPaths);
 	vector<double> simulationInterval;
 	if (m_dividendTime < time + 0.00000001 && m_jumpTime < m_dividendTime)
 	{
@@ -106,6 +117,10 @@ const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::gene
 	vector<double> initialPrices(nPaths, m_initialUnderlyingPrice);
 	for (int i = 0; i < nPaths; i++)
 	{
+		auto chunkIndex = i % utilities::NormalVariateGenerator::chunkSize;
+		if (chunkIndex == 0)
+			normalVariateGenerator.setChunk(firstPath + i, min(utilities::NormalVariateGenerator::chunkSize, nPaths - i));
+		auto variateIndex = 0; // the index of the next variate of the path
 		auto drift = m_discountRate - m_costOfCarry - 0.5 * pow(m_impliedVolatility, 2);
 		auto simulatedJump = 0.0;
 		auto simulatedNormal = 0.0;
@@ -118,12 +133,12 @@ const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::gene
 		{
 			// Simulate at jump date
 			timeStep = m_jumpTime;
-			simulatedJump = m_jumpMean + m_jumpVolatility * normalDistribution(mersenneTwisterEngine);
-			simulatedNormal = normalDistribution(mersenneTwisterEngine);
+			simulatedJump = m_jumpMean + m_jumpVolatility * normalVariateGenerator.normals(variateIndex++)[chunkIndex];
+			simulatedNormal = normalVariateGenerator.normals(variateIndex++)[chunkIndex];
 			simulatedPrice = simulatedPrice * exp(drift * timeStep + simulatedJump + m_impliedVolatility * sqrt(timeStep) * simulatedNormal);
 			// Simulate at dividend date
 			timeStep = m_dividendTime - m_jumpTime;
-			simulatedNormal = normalDistribution(mersenneTwisterEngine);
+			simulatedNormal = normalVariateGenerator.normals(variateIndex++)[chunkIndex];
 			simulatedPrice = simulatedPrice * exp(drift * timeStep + m_impliedVolatility * sqrt(timeStep) * simulatedNormal);
 			if (simulatedPrice - m_dividendAmount < 0.00000001)
 				simulatedPrice = 0.0;
@@ -140,7 +155,7 @@ const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::gene
 			{
 				// Simulate at dividend date
 				auto timeStep = m_dividendTime;
-				simulatedNormal =normalDistribution(mersenneTwisterEngine);
+				simulatedNormal =normalVariateGenerator.normals(variateIndex++)[chunkIndex];
 				simulatedPrice = simulatedPrice * exp(drift * timeStep + m_impliedVolatility * sqrt(timeStep) * simulatedNormal);
 				if (simulatedPrice - m_dividendAmount < 0.00000001)
 					simulatedPrice = 0.0;
@@ -150,13 +165,13 @@ const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::gene
 			{
 				timeStep = time;
 			}
-			simulatedJump = m_jumpMean + m_jumpVolatility * normalDistribution(mersenneTwisterEngine);
+			simulatedJump = m_jumpMean + m_jumpVolatility * normalVariateGenerator.normals(variateIndex++)[chunkIndex];
 		}
 
 		// Simulate the price at time
-		simulatedNormal =normalDistribution(mersenneTwisterEngine);
+		simulatedNormal =normalVariateGenerator.normals(variateIndex++)[chunkIndex];
 		timeStep = time;
-		simulatedJump = m_jumpMean + m_jumpVolatility * normalDistribution(mersenneTwisterEngine);
+		simulatedJump = m_jumpMean + m_jumpVolatility * normalVariateGenerator.normals(variateIndex++)[chunkIndex];
 		simulatedPrice = simulatedPrice * exp(drift * timeStep + simulatedJump + m_impliedVolatility * sqrt(timeStep) * simulatedNormal);
 
 		// Assign the simulated price to initial prices
@@ -165,10 +180,8 @@ const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::gene
 		// Deduct the dividend if it is paid
 		if (m_dividendTime < time + 0.00000001) 
 			initialPrices.at(i) -= m_dividendAmount;
-		simulatedPrices.push_back(fmax(0.0, initialPrices.at(i)));
+		simulatedPrices[i] = fmax(0.0, initialPrices.at(i));
 	}
-	auto simulatedPricesPtr = make_shared<vector<double>>(move(simulatedPrices));
-	return simulatedPricesPtr;
 }
 
 
@@ -189,7 +202,29 @@ const std::shared_ptr<vector<double>> models::BlackScholesSingleNormalJump::gene
 const std::shared_ptr<models::Tree> models::BlackScholesSingleNormalJump::constructTree(const int& nTimeSteps, const double& timeToExpiry, 
 	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation)
 {
+	shared_ptr<vector<double>> diffusionStatesPtr, diffusionProbabilitiesPtr, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr;
+	tie(diffusionStatesPtr, diffusionProbabilitiesPtr, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr) = 
+		calculateTreeStatesAndProbabilities(nTimeSteps, timeToExpiry, implementation);
+
 
+	// Construct tree 
+	// ---------------------------------------------------------------------------
+	auto treePtr = m_recombineAfterJump
+		? LogNormalDiffusionTreeHelper::constructRecombiningJumpDiffusionTree(nTimeSteps, timeToExpiry, m_jumpTime, m_dividendTime,
+			m_dividendAmount, m_initialUnderlyingPrice, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr, diffusionStatesPtr, 
+			diffusionProbabilitiesPtr)
+		: LogNormalDiffusionTreeHelper::constructJumpDiffusionTree(nTimeSteps, timeToExpiry, m_jumpTime, m_dividendTime,
+			m_dividendAmount, m_initialUnderlyingPrice, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr, diffusionStatesPtr, 
+			diffusionProbabilitiesPtr, m_treeTopologyCache);
+	return treePtr;
+}
+
+
+//// Calculates the states and probabilities of the diffusion, and of the jump diffusion over the time step containing the jump
+const std::tuple<std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vector<double>>, 
+	std::shared_ptr<std::vector<double>>> models::BlackScholesSingleNormalJump::calculateTreeStatesAndProbabilities(const int& nTimeSteps, 
+	const double& timeToExpiry, const enumerations::Implementation implementation)
+{
 	// Calculate the state and probabilities for diffusion and jumps
 	// ---------------------------------------------------------------------------
 	// As the time steps are of the same size throughout the tree, the multipliers and probabilities are invariant with time.
@@ -206,15 +241,29 @@ const std::shared_ptr<models::Tree> models::BlackScholesSingleNormalJump::constr
 	shared_ptr<vector<double>> jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr;
 	tie(jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateJumpDiffusionStatesAndProbabilities(
 		jumpStatesPtr, diffusionStatesPtr, jumpProbabilitiesPtr, diffusionProbabilitiesPtr);
+	return { diffusionStatesPtr, diffusionProbabilitiesPtr, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr };
+}
 
 
-	// Construct tree 
-	// ---------------------------------------------------------------------------
-	auto treeNodesPtr = LogNormalDiffusionTreeHelper::constructJumpDiffusionTree(nTimeSteps, timeToExpiry, m_jumpTime, m_dividendTime,
-		m_dividendAmount, m_initialUnderlyingPrice, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr, diffusionStatesPtr, 
-		diffusionProbabilitiesPtr);
-	auto treePtr = make_shared<Tree>(treeNodesPtr, nTimeSteps, timeToExpiry);
-	return treePtr;
+//// Estimates the size of the tree without constructing it. The number of grid points reached by the jump is needed if the tree recombines
+//// after the jump, and otherwise only the number of jump diffusion states.
+const models::TreeSizeEstimate models::BlackScholesSingleNormalJump::estimateTreeSize(const int& nTimeSteps, const double& timeToExpiry, 
+	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation)
+{
+	shared_ptr<vector<double>> diffusionStatesPtr, diffusionProbabilitiesPtr, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr;
+	tie(diffusionStatesPtr, diffusionProbabilitiesPtr, jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr) = 
+		calculateTreeStatesAndProbabilities(nTimeSteps, timeToExpiry, implementation);
+
+	if (!m_recombineAfterJump)
+		return LogNormalDiffusionTreeHelper::estimateJumpDiffusionTreeSize(nTimeSteps, timeToExpiry, m_jumpTime, 
+			(int)jumpDiffusionProbabilitiesPtr->size());
+
+	int firstJumpDownMoves;
+	shared_ptr<vector<double>> jumpProbabilitiesPtr;
+	tie(firstJumpDownMoves, jumpProbabilitiesPtr) = LogNormalDiffusionTreeHelper::snapJumpDiffusionStatesToGrid(jumpDiffusionStatesPtr, 
+		jumpDiffusionProbabilitiesPtr, diffusionStatesPtr);
+	return LogNormalDiffusionTreeHelper::estimateRecombiningJumpDiffusionTreeSize(nTimeSteps, timeToExpiry, m_jumpTime, 
+		(int)jumpProbabilitiesPtr->size());
 }
 
 
@@ -232,6 +281,16 @@ const std::shared_ptr<double> models::BlackScholesSingleNormalJump::smoothedValu
 	return value;
 }
 
+//// Calculates the option values at all of the nodes of a level with smoothing, with a single Black Scholes evaluation over the level
+void models::BlackScholesSingleNormalJump::smoothedValuesAtTreeNodes(const double* underlyingPrices, const int nNodes, 
+	const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize, double* smoothedValues,
+	const enumerations::NormalDistributionImplementation normalDistributionImplementation)
+{
+	LogNormalDiffusionTreeHelper::treeNodeEuropeanOptionValues(m_costOfCarry, m_discountRate, m_impliedVolatility, underlyingPrices, nNodes,
+		vanillaOption->getStrike(), timeStepSize, vanillaOption->getOptionRight(), smoothedValues,
+		normalDistributionImplementation);
+}
+
 const bool models::BlackScholesSingleNormalJump::supportsVanillaOptionSmoothing(const double & timeStart, const double & timeEnd)
 {
 	// If the dividend or jump date falls after the second last time, but before option expiry, then no smoothing
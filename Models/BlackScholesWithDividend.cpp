@@ -5,6 +5,7 @@
 #include "BlackScholesWithDividend.h"
 #include "BlackScholes.h"
 #include "TreeModelUtilities/LogNormalDiffusionTreeHelper.h"
+#include "../Utilities/Philox.h"
 
 using namespace std;
 using namespace models;
@@ -58,7 +59,6 @@ void models::BlackScholesWithDividend::setDividendAmount(const double& value)
 const std::shared_ptr<vector<double>> models::BlackScholesWithDividend::generateMonteCarloSimulations(const int& nPaths, const double& time, 
 	int seed)
 {
-	// Construct a standard normal distribution
 	auto modSeed = seed;
 	if (seed == -1) // if the seed is equal to -1, then generate a random seed
 	{
@@ -66,12 +66,23 @@ const std::shared_ptr<vector<double>> models::BlackScholesWithDividend::generate
 		modSeed = rd();
 	}
 
-	mt19937 mersenneTwisterEngine(modSeed);
+	vector<double> simulatedPrices(nPaths);
+	generateMonteCarloSimulations(nPaths, time, (uint32_t)modSeed, 0, simulatedPrices.data());
+	auto simulatedPricesPtr = make_shared<vector<double>>(move(simulatedPrices));
+	return simulatedPricesPtr;
+}
+
+
+//// Simulates the underlying price at the time for the paths from firstPath to firstPath + nPaths - 1, and writes them to simulatedPrices.
+//// Each path is drawn from the substream of the key with the index of the path, so that it does not depend on any of the other paths.
+void models::BlackScholesWithDividend::generateMonteCarloSimulations(const int& nPaths, const double& time, const uint64_t& key, 
+	const uint64_t& firstPath, double* simulatedPrices)
+{
+	// Construct a standard normal distribution. Each path draws its normals from its own Philox substream, as the two normals of a path 
+	// come from a single Box-Muller transform, which is faster than two inverse normal distribution functions unless their loop is vectorised.
 	normal_distribution<> normalDistribution{ 0,1 };
 
 	// Simulate normals, and calculate the underlying price
-	vector<double> simulatedPrices;
-	simulatedPrices.reserve(nPaths);
 	// Need to do a two stage simulation. First at the dividend date, and then till expiry
 	vector<double> simulationInterval;
 	if (m_dividendTime < time + 0.00000001)
@@ -83,24 +94,29 @@ const std::shared_ptr<vector<double>> models::BlackScholesWithDividend::generate
 	{
 		simulationInterval.push_back(time);
 	}
-	vector<double> initialPrices(nPaths, m_initialUnderlyingPrice);
+	// The drift and standard deviation of the log price over each interval are the same for every path
+	vector<double> drifts, standardDeviations;
+	for (int j = 0; j < simulationInterval.size(); j++)
+	{
+		drifts.push_back((m_discountRate - m_costOfCarry - 0.5 * pow(m_impliedVolatility, 2)) * simulationInterval[j]);
+		standardDeviations.push_back(m_impliedVolatility * sqrt(simulationInterval[j]));
+	}
 	for (int i = 0; i < nPaths; i++)
 	{
+		utilities::Philox generator(key, firstPath + i);
+		normalDistribution.reset();
+		auto simulatedPrice = m_initialUnderlyingPrice;
 		for (int j = 0; j < simulationInterval.size(); j++)
 		{
-			auto simulatedNormal = normalDistribution(mersenneTwisterEngine);
-			auto simulatedPrice = initialPrices.at(i) * exp((m_discountRate - m_costOfCarry - 0.5 * pow(m_impliedVolatility, 2)) * simulationInterval[j]
-				+ m_impliedVolatility * sqrt(simulationInterval[j]) * simulatedNormal);
+			auto simulatedNormal = normalDistribution(generator);
+			simulatedPrice *= exp(drifts[j] + standardDeviations[j] * simulatedNormal);
 			if (j == 0 && m_dividendTime < time + 0.00000001 && simulatedPrice - m_dividendAmount < 0.00000001)
 				simulatedPrice = 0.0;
-			initialPrices.at(i) = simulatedPrice;
 		}
 		if (m_dividendTime < time + 0.00000001) // deduct the dividend at the very end
-			initialPrices.at(i) -= m_dividendAmount;
-		simulatedPrices.push_back(fmax(0.0, initialPrices.at(i)));
+			simulatedPrice -= m_dividendAmount;
+		simulatedPrices[i] = fmax(0.0, simulatedPrice);
 	}
-	auto simulatedPricesPtr = make_shared<vector<double>>(move(simulatedPrices));
-	return simulatedPricesPtr;
 }
 
 
@@ -129,13 +145,41 @@ const std::shared_ptr<models::Tree> models::BlackScholesWithDividend::constructT
 	tie(diffusionStatesPtr, diffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateDiffusionStatesAndProbabilities(timeStepSize, 
 		m_impliedVolatility, m_discountRate, m_costOfCarry, implementation);
 
-	auto treeNodesPtr = LogNormalDiffusionTreeHelper::constructRecombiningTree(m_initialUnderlyingPrice, nTimeSteps, timeToExpiry, m_impliedVolatility,
+	auto treePtr = LogNormalDiffusionTreeHelper::constructRecombiningTree(m_initialUnderlyingPrice, nTimeSteps, timeToExpiry, m_impliedVolatility,
 		upperLimitStandardDeviation, lowerLimitStandardDeviation, m_dividendTime, m_dividendAmount, diffusionStatesPtr, diffusionProbabilitiesPtr);
-	auto treePtr = make_shared<Tree>(treeNodesPtr, nTimeSteps, timeToExpiry);
 	return treePtr;
 }
 
 
+//// Constructs the binomial recombining tree as an implicit lattice, i.e. the underlying price at each node is calculated on the fly during
+//// pricing rather than being stored. The lattice is identical to that of constructTree, but only requires O(nTimeSteps) memory.
+const std::shared_ptr<models::RecombiningLattice> models::BlackScholesWithDividend::constructRecombiningLattice(const int& nTimeSteps, 
+	const double& timeToExpiry, const enumerations::Implementation implementation, const double upperLimitStandardDeviation, 
+	const double lowerLimitStandardDeviation)
+{
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+
+	shared_ptr<vector<double>> diffusionStatesPtr, diffusionProbabilitiesPtr;
+	tie(diffusionStatesPtr, diffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateDiffusionStatesAndProbabilities(timeStepSize, 
+		m_impliedVolatility, m_discountRate, m_costOfCarry, implementation);
+
+	auto latticePtr = LogNormalDiffusionTreeHelper::constructRecombiningLattice(m_initialUnderlyingPrice, nTimeSteps, timeToExpiry, 
+		m_impliedVolatility, upperLimitStandardDeviation, lowerLimitStandardDeviation, m_dividendTime, m_dividendAmount, diffusionStatesPtr, 
+		diffusionProbabilitiesPtr);
+	return latticePtr;
+}
+
+
+//// Estimates the size of the tree from the implicit lattice, which has the same nodes as the tree, but only requires O(nTimeSteps) memory
+const models::TreeSizeEstimate models::BlackScholesWithDividend::estimateTreeSize(const int& nTimeSteps, const double& timeToExpiry, 
+	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation)
+{
+	auto latticePtr = constructRecombiningLattice(nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, 
+		lowerLimitStandardDeviation);
+	return LogNormalDiffusionTreeHelper::estimateRecombiningTreeSize(latticePtr);
+}
+
+
 //// Calculates the option value at the current tree node with smoothing
 const std::shared_ptr<double> models::BlackScholesWithDividend::smoothedValueAtTreeNode(const double underlyingPrice, 
 	const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize)
@@ -155,6 +199,16 @@ const std::shared_ptr<double> models::BlackScholesWithDividend::smoothedValueAtT
 	return valuePtr;
 }
 
+//// Calculates the option values at all of the nodes of a level with smoothing, with a single Black Scholes evaluation over the level
+void models::BlackScholesWithDividend::smoothedValuesAtTreeNodes(const double* underlyingPrices, const int nNodes, 
+	const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize, double* smoothedValues,
+	const enumerations::NormalDistributionImplementation normalDistributionImplementation)
+{
+	LogNormalDiffusionTreeHelper::treeNodeEuropeanOptionValues(m_costOfCarry, m_discountRate, m_impliedVolatility, underlyingPrices, nNodes,
+		vanillaOption->getStrike(), timeStepSize, vanillaOption->getOptionRight(), smoothedValues,
+		normalDistributionImplementation);
+}
+
 const bool models::BlackScholesWithDividend::supportsVanillaOptionSmoothing(const double & timeStart, const double & timeEnd)
 {
 	// If the dividend falls after the second last time, but before option expiry, then no smoothing
@@ -3,6 +3,8 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include "../Enumerations/UnderlyingCode.h"
 
 namespace models
@@ -16,6 +18,10 @@ namespace models
 		virtual const enumerations::UnderlyingCode& getUnderlyingCode() const = 0;
 		virtual const double& getDiscountRate() const = 0;
 		virtual const std::shared_ptr<std::vector<double>> generateMonteCarloSimulations(const int& nPaths, const double& time, int seed = -1) = 0;
+		// Simulation of the paths from firstPath to firstPath + nPaths - 1, written to simulatedPrices. Each path is a function of the key and 
+		// its index only, so that any block of paths can be simulated independently of the others.
+		virtual void generateMonteCarloSimulations(const int& nPaths, const double& time, const uint64_t& key, const uint64_t& firstPath, 
+			double* simulatedPrices) = 0;
 	};
 }
 
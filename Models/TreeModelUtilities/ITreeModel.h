@@ -3,9 +3,13 @@
 
 #include <vector>
 #include <memory>
+#include <stdexcept>
 #include "Tree.h"
+#include "RecombiningLattice.h"
+#include "TreeSizeEstimate.h"
 #include "../../Enumerations/UnderlyingCode.h"
 #include "../../Enumerations/Implementation.h"
+#include "../../Enumerations/NormalDistributionImplementation.h"
 #include "../../Instruments/VanillaOption.h"
 
 namespace models
@@ -23,6 +27,36 @@ namespace models
 		virtual const std::shared_ptr<double> smoothedValueAtTreeNode(const double underlyingPrice,
 			const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize) = 0;
 		virtual const bool supportsVanillaOptionSmoothing(const double & timeStart, const double & timeEnd) = 0;
+
+		// The smoothed values of a vanilla option at the nNodes nodes of a level with the given underlying prices, written to smoothedValues.
+		// Models should override this to value the whole level at once, rather than node by node, and with the normal distribution 
+		// implementation requested by the pricer. The node by node default ignores the requested implementation.
+		virtual void smoothedValuesAtTreeNodes(const double* underlyingPrices, const int nNodes,
+			const shared_ptr<instruments::VanillaOption> vanillaOption, const double timeStepSize, double* smoothedValues,
+			const enumerations::NormalDistributionImplementation)
+		{
+			for (int j = 0; j < nNodes; j++)
+				smoothedValues[j] = *smoothedValueAtTreeNode(underlyingPrices[j], vanillaOption, timeStepSize);
+		}
+
+		// The model parameters which determine the constructed tree, used as the key for cached trees. Models which do not provide their
+		// parameters are never cached.
+		virtual const std::vector<double> getTreeParameters() const { return std::vector<double>(); }
+
+		// Models whose tree is a binomial recombining lattice can construct it implicitly, i.e. without materialising the nodes
+		virtual const bool supportsRecombiningLattice() const { return false; }
+		virtual const std::shared_ptr<models::RecombiningLattice> constructRecombiningLattice(const int&, const double&,
+			const enumerations::Implementation, const double, const double)
+		{
+			throw std::invalid_argument("The model does not support the construction of an implicit recombining lattice.");
+		}
+
+		// The size of the tree that constructTree would return, predicted without constructing it
+		virtual const models::TreeSizeEstimate estimateTreeSize(const int&, const double&, const enumerations::Implementation, const double,
+			const double)
+		{
+			throw std::invalid_argument("The model does not support the estimation of the size of its tree.");
+		}
 	private:
 		bool m_supportsVanillaOptionSmoothing; 
 	};
@@ -1,11 +1,26 @@
+#include <algorithm>
+#include <boost/math/distributions/normal.hpp>
 #include "LogNormalDiffusionTreeHelper.h"
 #include "../BlackScholes.h"
+#include "../../Utilities/NormalDistribution.h"
 #include "../../Enumerations/ExerciseType.h"
 
 using namespace std;
 using namespace models;
 using namespace enumerations;
 
+constexpr double models::LogNormalDiffusionTreeHelper::normalJumpProbabilities[];
+
+// The branchings shared by the nodes of the trees constructed by this helper. The diffusion branching uses the table of diffusion 
+// probabilities, and the jump or truncated branching uses the second table of the tree.
+namespace
+{
+	const unsigned char terminalBranchingIndex = 0; // the nodes at the last time, and the nodes whose branches have all been truncated
+	const unsigned char diffusionBranchingIndex = 1; // an up and a down move
+	const unsigned char truncatedBranchingIndex = 2; // a single move, with the other move truncated from the tree
+	const unsigned char jumpBranchingIndex = 2; // a move to each of the jump diffusion states
+}
+
 // This function calculates the up and down states, and the probabilities of hitting those states, for a binomial tree discretisation of
 // a lognormal diffusion process.
 const std::tuple<std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vector<double>>> 
@@ -67,7 +82,7 @@ const std::tuple<std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vect
 
 	auto jumpSize = jumpVolatility;
 	vector<double> jumpStates;
-	jumpStates.reserve(5);
+	jumpStates.reserve(nNormalJumpStates);
 
 	// calculate the jump diffusion states
 	for (int j = 2; j > -3; j--)
@@ -76,16 +91,8 @@ const std::tuple<std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vect
 
 	// Calculate diffusion jump probabilities 
 	// ---------------------------------------------------------------------------
-	vector<double> jumpProbabilities;
-	jumpProbabilities.reserve(5);
-
-	// These probabilities have been determined based on moment matching the first four non-central moments of the normal distribution,
-	// along with the condition that the sum of all probabilities must equal to 1.
-	jumpProbabilities.push_back(1.0 / 12.0);
-	jumpProbabilities.push_back(1.0 / 6.0);
-	jumpProbabilities.push_back(1.0 / 2.0);
-	jumpProbabilities.push_back(1.0 / 6.0);
-	jumpProbabilities.push_back(1.0 / 12.0);
+	// The probabilities do not depend on the parameters of the jump, and are held in a constant table
+	vector<double> jumpProbabilities(normalJumpProbabilities, normalJumpProbabilities + nNormalJumpStates);
 
 	auto jumpProbabilitiesPtr = make_shared<vector<double>>(move(jumpProbabilities));
 	auto jumpStatesPtr = make_shared<vector<double>>(move(jumpStates));
@@ -135,84 +142,125 @@ const std::shared_ptr<double> models::LogNormalDiffusionTreeHelper::treeNodeEuro
 }
 
 
+// Loosely coupled smoother for vanilla option, for all of the nodes of a level at once. This is the same calculation as the Black Scholes 
+// analytic solution of treeNodeEuropeanOptionValue, with the terms which do not depend on the underlying price calculated once per level.
+// With the fast normal distribution, the arguments of the normal distribution are calculated for a block of nodes at a time, so that the 
+// distribution is evaluated over arrays.
+void models::LogNormalDiffusionTreeHelper::treeNodeEuropeanOptionValues(const double costOfCarry, const double discountRate, 
+	const double impliedVolatility, const double* underlyingPrices, const int nNodes, const double strike, const double timeStepSize, 
+	const enumerations::OptionRight optionRight, double* values, const enumerations::NormalDistributionImplementation normalDistributionImplementation)
+{
+	boost::math::normal z; // normal variate with mean 0 and variance 1
+	auto drift = timeStepSize * (discountRate - costOfCarry + pow(impliedVolatility, 2) / 2.0);
+	auto standardDeviation = impliedVolatility * sqrt(timeStepSize);
+	auto callSign = optionRight == OptionRight::call ? 1.0 : -1.0;
+	auto discountFactor = exp(-1. * discountRate * timeStepSize);
+	auto growthFactor = exp((discountRate - costOfCarry) * timeStepSize);
+	if (normalDistributionImplementation == NormalDistributionImplementation::fast)
+	{
+		const int blockSize = 256;
+		double d1[blockSize], d2[blockSize];
+		for (int first = 0; first < nNodes; first += blockSize)
+		{
+			auto n = min(blockSize, nNodes - first);
+			for (int j = 0; j < n; j++)
+			{
+				d1[j] = callSign * (log(underlyingPrices[first + j] / strike) + drift) / standardDeviation;
+				d2[j] = d1[j] - callSign * standardDeviation;
+			}
+			utilities::NormalDistribution::cdf(d1, n, d1);
+			utilities::NormalDistribution::cdf(d2, n, d2);
+			for (int j = 0; j < n; j++)
+				values[first + j] = callSign * discountFactor * (underlyingPrices[first + j] * growthFactor * d1[j] - strike * d2[j]);
+		}
+		return;
+	}
+
+	for (int j = 0; j < nNodes; j++)
+	{
+		auto d1 = (log(underlyingPrices[j] / strike) + drift) / standardDeviation;
+		auto d2 = d1 - standardDeviation;
+		values[j] = callSign * discountFactor * (
+			underlyingPrices[j] * growthFactor * boost::math::cdf(z, callSign * d1) - 
+			strike * boost::math::cdf(z, callSign * d2)
+			);
+	}
+}
+
+
 // Construct the whole recombining tree
-std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>> 
-models::LogNormalDiffusionTreeHelper::constructRecombiningTree(
+std::shared_ptr<models::Tree> models::LogNormalDiffusionTreeHelper::constructRecombiningTree(
 	const double initialUnderlyingPrice, const int nTimeSteps, const double timeToExpiry, const double impliedVolatility,
 	const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation, const double dividendTime, const double dividendAmount,
 	const std::shared_ptr<std::vector<double>> diffusionStatesPtr, const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr)
 {
 	// Initialise tree
 	// ---------------------------------------------------------------------------
+	// The tree has at most (n+1)(n+2)/2 nodes. Each node has an up and a down move, unless one of them has been truncated by the limits.
 	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
-	vector<shared_ptr<vector<shared_ptr<TreeNode>>>> treeNodes;
-	treeNodes.reserve(nTimeSteps + 1); // if there are n time steps, then there will be n+1 times
+	auto nMaxNodes = (nTimeSteps + 1) * (nTimeSteps + 2) / 2;
+	vector<int> levelOffsets;
+	vector<double> values;
+	vector<int> firstForwardIndex;
+	vector<unsigned char> nodeBranchingIndex;
+	vector<TreeBranching> branchings{ TreeBranching(), TreeBranching{ 2, 0 }, TreeBranching{ 1, 1 } };
+	vector<vector<double>> branchProbabilities{ *diffusionProbabilitiesPtr, vector<double>{ 1.0 } };
+	levelOffsets.reserve(nTimeSteps + 2); // if there are n time steps, then there will be n+1 times
+	values.reserve(nMaxNodes);
+	firstForwardIndex.reserve(nMaxNodes);
+	nodeBranchingIndex.reserve(nMaxNodes);
 
 
 	// Construct the very first node
 	// ---------------------------------------------------------------------------
-	auto nFutureNodesPerCurrentNode = diffusionStatesPtr->size();
-	auto probabilitiesPtr = diffusionProbabilitiesPtr;
-	auto initialNode = LogNormalDiffusionTreeHelper::constructInitialTreeNode(initialUnderlyingPrice, nFutureNodesPerCurrentNode, probabilitiesPtr);
-	treeNodes.push_back(move(initialNode));
+	levelOffsets.push_back(0);
+	values.push_back(initialUnderlyingPrice);
+	levelOffsets.push_back(1);
 
 
 	// Construct the remaining nodes in forward time
 	// ---------------------------------------------------------------------------
+	// The underlying prices are calculated in closed form from the number of up and down moves to reach each node
 	auto oneStandardDeviationMove = initialUnderlyingPrice * exp(impliedVolatility);
+	RecombiningNodeValues nodeValues(initialUnderlyingPrice, diffusionStatesPtr->at(0), diffusionStatesPtr->at(1), nTimeSteps, 0, nTimeSteps);
+	auto firstDownMoves = 0;
 	for (int i = 1; i < nTimeSteps + 1; i++)
 	{
 		auto time = i * timeStepSize;
 		auto upperLimit = oneStandardDeviationMove * exp(upperLimitStandardDeviation * sqrt(time));
 		auto lowerLimit = fmax(0.00000001, oneStandardDeviationMove * exp(lowerLimitStandardDeviation * sqrt(time)));
 		auto isDividendPaid = dividendTime < time + 0.00000001 ? true : false;
-		auto isLastTime = i == nTimeSteps ? true : false;
-		auto treeNodesIPtr = LogNormalDiffusionTreeHelper::constructRecombiningTreeNodes(treeNodes[i-1], upperLimit, lowerLimit,
-			diffusionStatesPtr, diffusionProbabilitiesPtr, isDividendPaid, dividendAmount, isLastTime);
-		treeNodes.push_back(move(treeNodesIPtr));
+		LogNormalDiffusionTreeHelper::constructRecombiningTreeNodes(levelOffsets, values, firstForwardIndex, nodeBranchingIndex, upperLimit, 
+			lowerLimit, nodeValues, i, firstDownMoves, isDividendPaid, dividendAmount);
 	}
 
+	// The nodes at the last time do not branch out
+	firstForwardIndex.resize(values.size(), 0);
+	nodeBranchingIndex.resize(values.size(), terminalBranchingIndex);
+
 
 	// Deduct dividends from tree
 	// ---------------------------------------------------------------------------
-	auto treeNodesPtr = make_shared<vector<shared_ptr<vector<shared_ptr<TreeNode>>>>>(move(treeNodes));
-	LogNormalDiffusionTreeHelper::deductDividend(treeNodesPtr, dividendTime, dividendAmount, timeToExpiry, timeStepSize, nTimeSteps);
+	auto dividendTimeIndex = LogNormalDiffusionTreeHelper::deductDividend(values, levelOffsets, dividendTime, dividendAmount, timeToExpiry, 
+		timeStepSize, nTimeSteps);
 
-	return treeNodesPtr;
+	auto treePtr = make_shared<Tree>(nTimeSteps, timeToExpiry, move(levelOffsets), move(values), move(firstForwardIndex), 
+		move(nodeBranchingIndex), move(branchings), move(branchProbabilities));
+	treePtr->setDividendTimeIndex(dividendTimeIndex);
+	return treePtr;
 }
 
 
-// constructs the first node in a tree
-std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>> models::LogNormalDiffusionTreeHelper::constructInitialTreeNode(
-	const double initialUnderlyingPrice, const int & nFutureNodesPerCurrentNode, const std::shared_ptr<std::vector<double>>& probabilitiesPtr)
+// given the nodes at the previous time point, constructs the nodes at the current time point along with the branches from the previous nodes.
+// firstDownMoves is the number of down moves to reach the first node at the previous time, and is updated to that of the current time.
+void models::LogNormalDiffusionTreeHelper::constructRecombiningTreeNodes(std::vector<int>& levelOffsets, std::vector<double>& values, 
+	std::vector<int>& firstForwardIndex, std::vector<unsigned char>& nodeBranchingIndex, const double& upperLimit, const double& lowerLimit, 
+	const models::RecombiningNodeValues& nodeValues, const int& timeIndex, int& firstDownMoves, const bool& isDividendPaid, 
+	const double dividendAmount)
 {
-	vector<shared_ptr<TreeNode>> treeNodesI;
-	auto nMaxCurrentTimeNodes = 1; // the maximum number of nodes at the current time step
-	treeNodesI.reserve(nMaxCurrentTimeNodes);
-	vector<int> valuesIndex;
-	valuesIndex.reserve(nFutureNodesPerCurrentNode);
-	for (int k = 0; k < nFutureNodesPerCurrentNode; k++)
-		valuesIndex.push_back(k);
-	auto valuesIndexPtr = make_shared<vector<int>>(move(valuesIndex));
-
-	// Construct the node
-	auto treeNodePtr = make_shared<TreeNode>(initialUnderlyingPrice, valuesIndexPtr, probabilitiesPtr);
-	treeNodesI.push_back(move(treeNodePtr));
-	auto treeNodesIPtr = make_shared<vector<shared_ptr<TreeNode>>>(move(treeNodesI));
-	return treeNodesIPtr;
-}
-
-
-// given the previous nodes at the previous time point, constructs the nodes at the current time point
-std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>> models::LogNormalDiffusionTreeHelper::constructRecombiningTreeNodes(
-	std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>& previousNodes, const double& upperLimit, const double& lowerLimit,  
-	const std::shared_ptr<std::vector<double>> diffusionStatesPtr, const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr,
-	const bool& isDividendPaid, const double dividendAmount, const bool& isLastTime)
-{
-	vector<shared_ptr<TreeNode>> treeNodesI;
-	auto nPreviousNodes = previousNodes->size();
-	auto nMaxCurrentTimeNodes = nPreviousNodes + 1; // the maximum number of nodes at the current time step
-	treeNodesI.reserve(nMaxCurrentTimeNodes);
+	auto previousOffset = levelOffsets[levelOffsets.size() - 2];
+	auto nPreviousNodes = levelOffsets.back() - previousOffset;
+	auto previousFirstDownMoves = firstDownMoves;
 
 
 	// Add the first point 
@@ -220,106 +268,148 @@ std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>> models::LogNorma
 
 	// the first point for all other times will be an up move from the first node at the previous time step.
 	// the next point will then be a down move from the first node at the previous time step. 
+	// If the upper limit has been hit, the first node of the previous time point only branches to its down move.
 	auto nextTimeIndex = 0;
-	auto upValue = previousNodes->at(0)->getValue() * exp(diffusionStatesPtr->at(0)); 
-	// Check whether the upper limit has been hit
-	if (upValue < upperLimit)
+	auto upValue = nodeValues.getValue(timeIndex, previousFirstDownMoves);
+	auto isUpNodeAdded = upValue < upperLimit;
+	if (isUpNodeAdded)
 	{
-		vector<int> valuesIndex = { 0, 1 };
-		auto valuesIndexPtr = make_shared<vector<int>>(move(valuesIndex));
-		auto probabilitiesPtr = diffusionProbabilitiesPtr;
-		auto treeNode = isLastTime ? make_shared<TreeNode>(upValue) : make_shared<TreeNode>(upValue, valuesIndexPtr, probabilitiesPtr);
-		treeNodesI.push_back(treeNode);
+		values.push_back(upValue);
 		nextTimeIndex++;
 	}
-	else // the upper limit has been hit, so the first node of the previous time point needs to be amended such that the price always goes down
-	{
-		auto valuesIndexPtr = make_shared<vector<int>>(vector<int>{0}); // the first value at the current time will be a down move
-		auto probabilitiesPtr = make_shared<vector<double>>(vector<double>{1.0});
-		previousNodes->at(0)->setForwardValuesIndex(valuesIndexPtr);
-		previousNodes->at(0)->setForwardProbabilities(probabilitiesPtr);
-	}
+	else
+		firstDownMoves++;
 
 
 	// Add the remaining points 
 	// ---------------------------------------------------------------------------
 
+	// The up move from the jth previous node recombines with the down move from the (j-1)th previous node, so it is the last node added. 
 	for (int j = 0; j < nPreviousNodes; j++)
 	{
-		auto downValue = previousNodes->at(j)->getValue() * exp(diffusionStatesPtr->at(1));
+		auto downMoves = previousFirstDownMoves + j + 1;
+		auto downValue = nodeValues.getValue(timeIndex, downMoves);
 		// Check whether the lower bound, or the zero absorbing boundary (due to the payment of the dividend) has been hit
-		if ((isDividendPaid && (downValue - dividendAmount < 0.00000001)) || downValue < lowerLimit) // remove down move from previous node
-		{
-			auto upIndex = previousNodes->at(j)->getForwardValuesIndex()->at(0);
-			auto valuesIndexPtr = make_shared<vector<int>>(vector<int>{upIndex}); // the first value at the current time will be a down move
-			auto probabilitiesPtr = make_shared<vector<double>>(vector<double>{1.0});
-			previousNodes->at(j)->setForwardValuesIndex(valuesIndexPtr);
-			previousNodes->at(j)->setForwardProbabilities(probabilitiesPtr);
-		}
-		else
+		auto isDownNodeAdded = !((isDividendPaid && (downValue - dividendAmount < 0.00000001)) || downValue < lowerLimit);
+		auto upIndex = nextTimeIndex - 1;
+		if (isDownNodeAdded)
 		{
-			auto upIndex = nextTimeIndex;
+			values.push_back(downValue);
 			nextTimeIndex++;
-			auto downIndex = nextTimeIndex;
-			auto valuesIndexPtr = make_shared<vector<int>>(vector<int>{move(upIndex), move(downIndex)});
-			auto probabilitiesPtr = diffusionProbabilitiesPtr;
-			auto treeNode = isLastTime ? make_shared<TreeNode>(downValue) : make_shared<TreeNode>(downValue, valuesIndexPtr, probabilitiesPtr);
-			treeNodesI.push_back(treeNode);
 		}
-	}
-
 
-	// Construct the nodes
-	// ---------------------------------------------------------------------------
-
-	auto treeNodesIPtr = make_shared<vector<shared_ptr<TreeNode>>>(move(treeNodesI));
-	return treeNodesIPtr;
+		firstForwardIndex.push_back(isUpNodeAdded ? upIndex : upIndex + 1);
+		if (isUpNodeAdded && isDownNodeAdded)
+			nodeBranchingIndex.push_back(diffusionBranchingIndex);
+		else if (isUpNodeAdded || isDownNodeAdded) // remove the truncated move from the previous node
+			nodeBranchingIndex.push_back(truncatedBranchingIndex);
+		else
+			nodeBranchingIndex.push_back(terminalBranchingIndex);
+		isUpNodeAdded = isDownNodeAdded;
+	}
+	levelOffsets.push_back((int)values.size());
 }
 
 
-// Deduct dividends from the tree
-void models::LogNormalDiffusionTreeHelper::deductDividend
-	(std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>>& treePtr,
+// Deduct dividends from the tree, returning the first time index from which the dividend is deducted, or nTimeSteps + 1 if it is paid
+// after expiry
+int models::LogNormalDiffusionTreeHelper::deductDividend(std::vector<double>& values, const std::vector<int>& levelOffsets, 
 	const double& dividendTime, const double& dividendAmount, const double& timeToExpiry, const double& timeStepSize, const int& nTimeSteps)
 {
 	// Loop through each time step after the dividend payment, and the deduct the dividend from each tree node
 	if (dividendTime <= timeToExpiry + 0.00000001)
 	{
 		auto dividendPaymentTimeStep = (int)ceil(dividendTime / timeStepSize); // round up if the dividend is paid between discretisation times
-		for (int i = dividendPaymentTimeStep; i < nTimeSteps + 1; i++)
-		{
-			for (int j = 0; j < treePtr->at(i)->size(); j++)
-			{
-				auto value = fmax(0.0, treePtr->at(i)->at(j)->getValue() - dividendAmount);
-				treePtr->at(i)->at(j)->setValue(value);
-			}
-		}
+		for (int j = levelOffsets[dividendPaymentTimeStep]; j < levelOffsets[nTimeSteps + 1]; j++)
+			values[j] = fmax(0.0, values[j] - dividendAmount);
+		return dividendPaymentTimeStep;
+	}
+	return nTimeSteps + 1;
+}
+
+
+
+// Construct the implicit recombining lattice. The truncation of the nodes is identical to that in constructRecombiningTree, but only the range 
+// of nodes at each time is stored.
+std::shared_ptr<models::RecombiningLattice> models::LogNormalDiffusionTreeHelper::constructRecombiningLattice(
+	const double initialUnderlyingPrice, const int nTimeSteps, const double timeToExpiry, const double impliedVolatility,
+	const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation, const double dividendTime, const double dividendAmount,
+	const std::shared_ptr<std::vector<double>> diffusionStatesPtr, const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr)
+{
+	// Initialise lattice
+	// ---------------------------------------------------------------------------
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+	auto upState = diffusionStatesPtr->at(0);
+	auto downState = diffusionStatesPtr->at(1);
+	vector<int> firstDownMoves;
+	vector<int> lastDownMoves;
+	firstDownMoves.reserve(nTimeSteps + 1);
+	lastDownMoves.reserve(nTimeSteps + 1);
+	firstDownMoves.push_back(0);
+	lastDownMoves.push_back(0);
+
+
+	// Determine the range of the nodes in forward time
+	// ---------------------------------------------------------------------------
+
+	// The highest node is reached by an up move from the highest node at the previous time, unless the upper limit has been hit. Likewise, the 
+	// lowest node is reached by a down move from the lowest node at the previous time, unless the lower limit or the zero absorbing boundary
+	// (due to the payment of the dividend) has been hit. Dividends are deducted after the truncation, as in constructRecombiningTree.
+	auto oneStandardDeviationMove = initialUnderlyingPrice * exp(impliedVolatility);
+	RecombiningNodeValues nodeValues(initialUnderlyingPrice, upState, downState, nTimeSteps, 0, nTimeSteps);
+	for (int i = 1; i < nTimeSteps + 1; i++)
+	{
+		auto time = i * timeStepSize;
+		auto upperLimit = oneStandardDeviationMove * exp(upperLimitStandardDeviation * sqrt(time));
+		auto lowerLimit = fmax(0.00000001, oneStandardDeviationMove * exp(lowerLimitStandardDeviation * sqrt(time)));
+		auto isDividendPaid = dividendTime < time + 0.00000001 ? true : false;
+
+		auto firstDownMove = firstDownMoves[i - 1];
+		auto upValue = nodeValues.getValue(i, firstDownMove);
+		firstDownMoves.push_back(upValue < upperLimit ? firstDownMove : firstDownMove + 1);
+
+		auto lastDownMove = lastDownMoves[i - 1] + 1;
+		auto downValue = nodeValues.getValue(i, lastDownMove);
+		auto isDownNodeAdded = !((isDividendPaid && (downValue - dividendAmount < 0.00000001)) || downValue < lowerLimit);
+		lastDownMoves.push_back(isDownNodeAdded ? lastDownMove : lastDownMove - 1);
+
+		if (firstDownMoves[i] > lastDownMoves[i])
+			throw invalid_argument("The upper and lower limits have truncated all of the nodes in the lattice.");
 	}
 
+	auto latticePtr = make_shared<RecombiningLattice>(nTimeSteps, timeToExpiry, initialUnderlyingPrice, upState, downState, 
+		diffusionProbabilitiesPtr->at(0), diffusionProbabilitiesPtr->at(1), dividendTime, dividendAmount, move(firstDownMoves), 
+		move(lastDownMoves));
+	return latticePtr;
 }
 
 
 
-// Construct a jump diffusion tree
-std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>> 
-	models::LogNormalDiffusionTreeHelper::constructJumpDiffusionTree(const int nTimeSteps, const double timeToExpiry,
-		const double jumpTime,  const double dividendTime, const double dividendAmount, const double initialUnderlyingPrice,
-		const std::shared_ptr<std::vector<double>> jumpDiffusionStatesPtr,
-		const std::shared_ptr<std::vector<double>> jumpDiffusionProbabilitiesPtr,
-		const std::shared_ptr<std::vector<double>> diffusionStatesPtr,
-		const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr)
+// Construct the topology of a jump diffusion tree, i.e. the nodes and branches without their values and probabilities. The topology only 
+// depends on the number of time steps, the time to expiry, the jump time and the number of jump diffusion states.
+std::shared_ptr<const models::TreeTopology> models::LogNormalDiffusionTreeHelper::constructJumpDiffusionTreeTopology(const int nTimeSteps,
+	const double timeToExpiry, const double jumpTime, const int nJumpDiffusionStates)
 {
-	// Initialise tree
+	// Initialise topology
 	// ---------------------------------------------------------------------------
-	vector<shared_ptr<vector<shared_ptr<TreeNode>>>> treeNodes;
+	vector<int> levelOffsets;
+	vector<int> firstForwardIndex;
+	vector<unsigned char> nodeBranchingIndex;
+	vector<TreeBranching> branchings{ TreeBranching(), TreeBranching{ 2, 0 }, TreeBranching{ nJumpDiffusionStates, 1 } };
+	vector<bool> isRecombiningLevel;
+	vector<int> levelStatesIndex;
 	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
-	treeNodes.reserve(nTimeSteps + 1); // if there are two time steps, then there are a total of 3 times
+	levelOffsets.reserve(nTimeSteps + 2); // if there are two time steps, then there are a total of 3 times
+	levelOffsets.push_back(0);
+	isRecombiningLevel.reserve(nTimeSteps + 1);
+	levelStatesIndex.reserve(nTimeSteps + 1);
 
 
-	// Construct the tree in forward time
+	// Construct the topology in forward time
 	// ---------------------------------------------------------------------------
 
-	// Nodes are deducted by the amount of the dividend in the next stage of the calculation. At this stage only the $0 absorbing boundary is enforced.
+	// The first forward index and branching of each node are added along with the node. The diffusion states and probabilities are 
+	// identified by 0, and the jump diffusion states and probabilities by 1.
 
 	auto nPreviousTimeNodes = 0; // total number of nodes at the previous time step
 	auto nCurrentTimeNodes = 0; // total number of nodes at the current time steps
@@ -327,15 +417,14 @@ std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::
 	auto nCurrentNodesPerPreviousNode = 2;
 	auto currentTimeIsRecombining = true; // identifies if the tree is still in recombining phase 
 	auto nextTimeIsRecombining = true; // identifies if the tree is recombining in the next phase
+
 	for (int i = 0; i < nTimeSteps + 1; i++)
 	{
-		vector<double> states;
-		vector<double> statesProbabilities;
 		auto time = timeStepSize * (double)i;
 		// Determine if the jump has fallen within the last time step
 		if ((jumpTime > time - timeStepSize + 0.00000001) && (jumpTime <= time + 0.00000001))
 		{
-			nCurrentNodesPerPreviousNode = jumpDiffusionProbabilitiesPtr->size();
+			nCurrentNodesPerPreviousNode = nJumpDiffusionStates;
 			nCurrentTimeNodes = nPreviousTimeNodes * nCurrentNodesPerPreviousNode; // 2 diffusion states, 5 jump states
 			nFutureNodesPerCurrentNode = 2; // all subsequent times will only have diffusion 
 			currentTimeIsRecombining = false;
@@ -356,7 +445,7 @@ std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::
 			currentTimeIsRecombining = true;
 			if ((jumpTime <= time + timeStepSize + 0.00000001) && (jumpTime > time + 0.00000001)) // does the jump happen in the next time step
 			{
-				nFutureNodesPerCurrentNode = jumpDiffusionProbabilitiesPtr->size();
+				nFutureNodesPerCurrentNode = nJumpDiffusionStates;
 				nextTimeIsRecombining = false;
 			}
 			else
@@ -365,181 +454,367 @@ std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::
 				nextTimeIsRecombining = true;
 			}
 		}
+		if (i == nTimeSteps) // the nodes at the end of the tree do not branch out
+			nFutureNodesPerCurrentNode = 0;
+
+		// If the next time is recombining, then node j branches out to nodes j and j + 1. Otherwise, the future nodes are not recombining.
+		auto branchingIndex = nFutureNodesPerCurrentNode == 0 ? terminalBranchingIndex 
+			: (nFutureNodesPerCurrentNode == 2 ? diffusionBranchingIndex : jumpBranchingIndex);
+		firstForwardIndex.reserve(firstForwardIndex.size() + nCurrentTimeNodes);
+		for (int j = 0; j < nCurrentTimeNodes; j++)
+			firstForwardIndex.push_back(nextTimeIsRecombining || nFutureNodesPerCurrentNode == 0 ? j : j * nFutureNodesPerCurrentNode);
+		nodeBranchingIndex.resize(nodeBranchingIndex.size() + nCurrentTimeNodes, branchingIndex);
+		isRecombiningLevel.push_back(currentTimeIsRecombining);
+		levelStatesIndex.push_back(nCurrentNodesPerPreviousNode == 2 ? 0 : 1);
 
+		// Add the nodes at the current time step to the tree
+		levelOffsets.push_back(levelOffsets.back() + nCurrentTimeNodes);
+		nPreviousTimeNodes = nCurrentTimeNodes;
+	}
+
+	auto topologyPtr = make_shared<const TreeTopology>(nTimeSteps, move(levelOffsets), move(firstForwardIndex), move(nodeBranchingIndex),
+		move(branchings), move(isRecombiningLevel), move(levelStatesIndex));
+	return topologyPtr;
+}
 
-		vector<shared_ptr<TreeNode>> treeNodesI;
-		treeNodesI.reserve(nCurrentTimeNodes);
+
+// Construct a jump diffusion tree. The topology of the tree, which is taken from the topology cache if one is provided, is filled with the 
+// values and probabilities in forward time.
+std::shared_ptr<models::Tree> models::LogNormalDiffusionTreeHelper::constructJumpDiffusionTree(const int nTimeSteps, const double timeToExpiry,
+		const double jumpTime,  const double dividendTime, const double dividendAmount, const double initialUnderlyingPrice,
+		const std::shared_ptr<std::vector<double>> jumpDiffusionStatesPtr,
+		const std::shared_ptr<std::vector<double>> jumpDiffusionProbabilitiesPtr,
+		const std::shared_ptr<std::vector<double>> diffusionStatesPtr,
+		const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr,
+		const std::shared_ptr<models::TreeTopologyCache>& treeTopologyCache)
+{
+	auto nJumpDiffusionStates = (int)jumpDiffusionProbabilitiesPtr->size();
+	auto topologyPtr = treeTopologyCache == nullptr 
+		? constructJumpDiffusionTreeTopology(nTimeSteps, timeToExpiry, jumpTime, nJumpDiffusionStates)
+		: treeTopologyCache->getJumpDiffusionTreeTopology(nTimeSteps, timeToExpiry, jumpTime, nJumpDiffusionStates);
+	auto& levelOffsets = topologyPtr->getLevelOffsets();
+	auto& isRecombiningLevel = topologyPtr->getIsRecombiningLevel();
+	auto& levelStatesIndex = topologyPtr->getLevelStatesIndex();
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+	vector<double> values(topologyPtr->getNNodes());
+	vector<vector<double>> branchProbabilities{ *diffusionProbabilitiesPtr, *jumpDiffusionProbabilitiesPtr }; // shared by all branches
+
+	vector<double> diffusionMultipliers;
+	vector<double> jumpDiffusionMultipliers;
+	for (auto& state : *diffusionStatesPtr)
+		diffusionMultipliers.push_back(exp(state));
+	for (auto& state : *jumpDiffusionStatesPtr)
+		jumpDiffusionMultipliers.push_back(exp(state));
+
+
+	// Fill in the values in forward time
+	// ---------------------------------------------------------------------------
+
+	// Nodes are deducted by the amount of the dividend in the next stage of the calculation. At this stage only the $0 absorbing boundary is enforced.
+	values[0] = initialUnderlyingPrice;
+	for (int i = 1; i < nTimeSteps + 1; i++)
+	{
+		auto time = timeStepSize * (double)i;
+		auto previousOffset = levelOffsets[i - 1];
+		auto currentOffset = levelOffsets[i];
+		auto nCurrentTimeNodes = levelOffsets[i + 1] - currentOffset;
 
 		// Determine if the dividend falls within the current time step. This is used to enforce the 0 absorbing boundary. 
 		auto dividendDeduction = (dividendTime >= time - 0.00000001) && (dividendTime < time + timeStepSize - 0.00000001) ? dividendAmount : 0.0;
 
-		if (i == 0) // i.e. the start of the tree
+		if (isRecombiningLevel[i]) // i.e. a recombining tree
 		{
-			if (nextTimeIsRecombining == true)
+			// the first point for all other times will be an up move from the first node at the previous time step.
+			// the next point will then be a down move from the first node at the previous time step. 
+			values[currentOffset] = values[previousOffset] * diffusionMultipliers[0];
+			for (int j = 1; j < nCurrentTimeNodes; j++)
 			{
-				vector<int> futureValuesIndex = { 0, 1 };
-				auto futureValuesIndexPtr = make_shared<vector<int>>(move(futureValuesIndex));
-				auto treeNode = make_shared<TreeNode>(initialUnderlyingPrice, futureValuesIndexPtr, diffusionProbabilitiesPtr);
-				treeNodesI.push_back(treeNode);
-			}
-			else // i.e. the jump happens within the first time step
-			{
-				auto index = 0;
-				vector<int> futureValuesIndex;
-				futureValuesIndex.reserve(nFutureNodesPerCurrentNode);
-				for (int k = 0; k < nFutureNodesPerCurrentNode; k++)
-				{
-					futureValuesIndex.push_back(index);
-					index++;
-				}
-				auto futureValuesIndexPtr = make_shared<vector<int>>(move(futureValuesIndex));
-				auto treeNode = make_shared<TreeNode>(initialUnderlyingPrice, futureValuesIndexPtr, jumpDiffusionProbabilitiesPtr);
-				treeNodesI.push_back(treeNode);
+				auto downValue = fmax(0.0, values[previousOffset + j - 1] * diffusionMultipliers[1]);
+				if (downValue - dividendDeduction < 0.00000001) // although the dividend should be deducted at the end, 0.0 is an absorbing boundary
+					downValue = 0.0;
+				values[currentOffset + j] = downValue;
 			}
 		}
-
-		if (i != 0 && i != nTimeSteps) // i.e. the middle of the tree
+		else // i.e. a non-recombining tree, where node j at the previous time branches out to the nodes [j * nStates, (j + 1) * nStates)
 		{
-			if (currentTimeIsRecombining == true && nextTimeIsRecombining == true) // i.e. construct a recombining tree
+			auto& multipliers = levelStatesIndex[i] == 0 ? diffusionMultipliers : jumpDiffusionMultipliers;
+			auto nStates = (int)multipliers.size();
+			for (int j = 0; j < nCurrentTimeNodes; j++)
 			{
-				// the first point for all other times will be an up move from the first node at the previous time step.
-				// the next point will then be a down move from the first node at the previous time step. 
-				auto upValue = treeNodes[i - 1]->at(0)->getValue() * exp(diffusionStatesPtr->at(0));
-				vector<int> futureValuesIndex = { 0, 1 };
-				auto futureValuesIndexPtr = make_shared<vector<int>>(move(futureValuesIndex));
-				auto treeNode = make_shared<TreeNode>(upValue, futureValuesIndexPtr, diffusionProbabilitiesPtr);
-				treeNodesI.push_back(treeNode);
-				for (int j = 1; j < nCurrentTimeNodes; j++)
-				{
-					auto downValue = fmax(0.0, treeNodes[i - 1]->at(j - 1)->getValue() * exp(diffusionStatesPtr->at(1)));
-					if (downValue - dividendDeduction < 0.00000001) // although the dividend should be deducted at the end, 0.0 is an absorbing boundary
-						downValue = 0.0;
-					vector<int> futureValuesIndex = { j, j + 1 };
-					auto futureValuesIndexPtr = make_shared<vector<int>>(move(futureValuesIndex));
-					auto treeNode = make_shared<TreeNode>(downValue, futureValuesIndexPtr, diffusionProbabilitiesPtr);
-					treeNodesI.push_back(treeNode);
-				}
+				auto value = fmax(0.0, values[previousOffset + j / nStates] * multipliers[j % nStates]);
+				if (value - dividendDeduction < 0.00000001) // although the dividend should be deducted at the end, 0.0 is an absorbing boundary
+					value = 0.0;
+				values[currentOffset + j] = value;
 			}
+		}
+	}
 
-			if (currentTimeIsRecombining == true && nextTimeIsRecombining == false)
-			{
-				// Current node is recombining
-				// the first point will be an up move from the first node at the previous time step.
-				// the next point will then be a down move from the first node at the previous time step. 
-				auto upValue = treeNodes[i - 1]->at(0)->getValue() * exp(diffusionStatesPtr->at(0));
-				// Future nodes are not recombining
-				auto index = 0;
-				vector<int> futureValuesIndex;
-				futureValuesIndex.reserve(nFutureNodesPerCurrentNode);
-				for (int k = 0; k < nFutureNodesPerCurrentNode; k++)
-				{
-					futureValuesIndex.push_back(index);
-					index++;
-				}
-				auto futureValuesIndexPtr = make_shared<vector<int>>(move(futureValuesIndex));
-				auto treeNode = make_shared<TreeNode>(upValue, futureValuesIndexPtr, jumpDiffusionProbabilitiesPtr);
-				treeNodesI.push_back(treeNode);
 
-				// The remaining nodes at the current time will be down moves
-				for (int j = 1; j < nCurrentTimeNodes; j++)
-				{
-					// Current node is recombining
-					auto downValue = fmax(0.0, treeNodes[i - 1]->at(j - 1)->getValue() * exp(diffusionStatesPtr->at(1)));
-					if (downValue - dividendDeduction < 0.00000001) // although the dividend should be deducted at the end, 0.0 is an absorbing boundary
-						downValue = 0.0;
-					// Future nodes are not recombining
-					vector<int> futureValuesIndex;
-					futureValuesIndex.reserve(nFutureNodesPerCurrentNode);
-					for (int k = 0; k < nFutureNodesPerCurrentNode; k++)
-					{
-						futureValuesIndex.push_back(index);
-						index++;
-					}
-					auto futureValuesIndexPtr = make_shared<vector<int>>(move(futureValuesIndex));
-					auto treeNode = make_shared<TreeNode>(downValue, futureValuesIndexPtr, jumpDiffusionProbabilitiesPtr);
-					treeNodesI.push_back(treeNode);
-				}
-			}
+	// Deduct dividends from tree
+	// ---------------------------------------------------------------------------
+	auto dividendTimeIndex = LogNormalDiffusionTreeHelper::deductDividend(values, levelOffsets, dividendTime, dividendAmount, timeToExpiry, 
+		timeStepSize, nTimeSteps);
 
-			if (currentTimeIsRecombining == false) // i.e. construct a non-recombining tree
-			{
-				auto index = 0;
-				for (int j = 0; j < nPreviousTimeNodes; j++)
-				{
-					auto statePtr = nCurrentNodesPerPreviousNode == 2 ? diffusionStatesPtr : jumpDiffusionStatesPtr;
-					auto probabilitiesPtr = nFutureNodesPerCurrentNode == 2 ? diffusionProbabilitiesPtr : jumpDiffusionProbabilitiesPtr;
+	auto treePtr = make_shared<Tree>(timeToExpiry, topologyPtr, move(values), move(branchProbabilities));
+	treePtr->setDividendTimeIndex(dividendTimeIndex);
+	return treePtr;
+}
 
-					for (int k = 0; k < statePtr->size(); k++)
-					{
-						auto value = fmax(0.0, treeNodes[i - 1]->at(j)->getValue() * exp(statePtr->at(k)));
-						if (value - dividendDeduction < 0.00000001) // although the dividend should be deducted at the end, 0.0 is an absorbing boundary
-							value = 0.0;
-						// Future nodes are not recombining
-						vector<int> futureValuesIndex;
-						futureValuesIndex.reserve(nFutureNodesPerCurrentNode);
-						for (int k = 0; k < nFutureNodesPerCurrentNode; k++)
-						{
-							futureValuesIndex.push_back(index);
-							index++;
-						}
-						auto futureValuesIndexPtr = make_shared<vector<int>>(move(futureValuesIndex));
-						auto treeNode = make_shared<TreeNode>(value, futureValuesIndexPtr, probabilitiesPtr);
-						treeNodesI.push_back(treeNode);
-					}
-				}
-			}
+
+// Snaps the jump diffusion states onto the grid of a recombining tree, so that the tree continues to recombine after the jump. The grid at each
+// time is spaced by the difference between the up and down diffusion states, and a move x from a node lands (up - x) / spacing down moves 
+// from the up node of the next time. Each state is split between the two grid points either side of it, in proportion to its distance from
+// each, which preserves the mean of the state but adds variance. To keep the variance of the jump diffusion, the states are first shrunk 
+// towards their mean by the factor at which the variance after the split is equal to that of the original states, which is found by 
+// bisection. Only the mean and variance are kept: the higher moments, such as the fourth moment matched by the jump states, are lost. If 
+// the spacing of the grid is too coarse for the variance, i.e. placing all of the states at the mean and splitting it between the grid points
+// already adds more variance than that of the jump diffusion, an exception is thrown, as the variance cannot then be matched.
+// Returns the number of down moves, relative to the up node of the next time, of the first grid point, along with the probabilities of 
+// moving to each consecutive grid point.
+const std::tuple<int, std::shared_ptr<std::vector<double>>>
+	models::LogNormalDiffusionTreeHelper::snapJumpDiffusionStatesToGrid(const std::shared_ptr<std::vector<double>> jumpDiffusionStatesPtr,
+	const std::shared_ptr<std::vector<double>> jumpDiffusionProbabilitiesPtr, const std::shared_ptr<std::vector<double>> diffusionStatesPtr)
+{
+	auto nStates = (int)jumpDiffusionStatesPtr->size();
+	auto upState = diffusionStatesPtr->at(0);
+	auto gridSpacing = diffusionStatesPtr->at(0) - diffusionStatesPtr->at(1);
+	auto mean = 0.0;
+	auto variance = 0.0;
+	for (int s = 0; s < nStates; s++)
+		mean += jumpDiffusionProbabilitiesPtr->at(s) * jumpDiffusionStatesPtr->at(s);
+	for (int s = 0; s < nStates; s++)
+		variance += jumpDiffusionProbabilitiesPtr->at(s) * pow(jumpDiffusionStatesPtr->at(s) - mean, 2);
+
+	// The variance of the states after they are shrunk towards the mean and split between grid points
+	auto gridPosition = [&](const int s, const double shrinkFactor) { 
+		return (upState - (mean + shrinkFactor * (jumpDiffusionStatesPtr->at(s) - mean))) / gridSpacing; };
+	auto snappedVariance = [&](const double shrinkFactor)
+	{
+		auto value = 0.0;
+		for (int s = 0; s < nStates; s++)
+		{
+			auto fraction = gridPosition(s, shrinkFactor) - floor(gridPosition(s, shrinkFactor));
+			value += jumpDiffusionProbabilitiesPtr->at(s) * (pow(shrinkFactor * (jumpDiffusionStatesPtr->at(s) - mean), 2) 
+				+ fraction * (1.0 - fraction) * pow(gridSpacing, 2));
 		}
+		return value;
+	};
 
-		if (i == nTimeSteps) // i.e. the end of the tree (it is more efficient to split out the nTimeSteps iteration from the middle of tree 
+	if (snappedVariance(0.0) > variance)
+		throw invalid_argument("The grid is too coarse to snap the jump diffusion states onto it. Increase the number of time steps.");
+
+	auto shrinkFactor = 0.0;
+	if (snappedVariance(0.0) < variance)
+	{
+		auto lowerShrinkFactor = 0.0;
+		auto upperShrinkFactor = 1.0;
+		for (int k = 0; k < 60; k++)
 		{
-			if (currentTimeIsRecombining == true) // i.e. construct a recombining tree
-			{
-				// the first point for all other times will be an up move from the first node at the previous time step.
-				// the next point will then be a down move from the first node at the previous time step. 
-				auto upValue = treeNodes[i - 1]->at(0)->getValue() * exp(diffusionStatesPtr->at(0));
-				auto treeNode = make_shared<TreeNode>(upValue);
-				treeNodesI.push_back(treeNode);
-				for (int j = 1; j < nCurrentTimeNodes; j++)
-				{
-					auto downValue = fmax(0.0, treeNodes[i - 1]->at(j - 1)->getValue() * exp(diffusionStatesPtr->at(1)));
-					if (downValue - dividendDeduction < 0.00000001) // although the dividend should be deducted at the end, 0.0 is an absorbing boundary
-						downValue = 0.0;
-					auto treeNode = make_shared<TreeNode>(downValue);
-					treeNodesI.push_back(treeNode);
-				}
-			}
+			shrinkFactor = 0.5 * (lowerShrinkFactor + upperShrinkFactor);
+			if (snappedVariance(shrinkFactor) < variance)
+				lowerShrinkFactor = shrinkFactor;
 			else
-			{
-				for (int j = 0; j < nPreviousTimeNodes; j++)
-				{
-					auto statePtr = nCurrentNodesPerPreviousNode == 2 ? diffusionStatesPtr : jumpDiffusionStatesPtr;
-					auto probabilitiesPtr = nCurrentNodesPerPreviousNode == 2 ? diffusionProbabilitiesPtr : jumpDiffusionProbabilitiesPtr;
-
-					for (int k = 0; k < statePtr->size(); k++)
-					{
-						auto value = fmax(0.0, treeNodes[i - 1]->at(j)->getValue() * exp(statePtr->at(k)));
-						if (value - dividendDeduction < 0.00000001) // although the dividend should be deducted at the end, 0.0 is an absorbing boundary
-							value = 0.0;
-						auto treeNode = make_shared<TreeNode>(value);
-						treeNodesI.push_back(treeNode);
-					}
-				}
-			}
+				upperShrinkFactor = shrinkFactor;
 		}
+	}
+
+	// Split each state between the grid points either side of it
+	auto firstDownMoves = (int)floor(gridPosition(0, shrinkFactor));
+	auto lastDownMoves = firstDownMoves;
+	for (int s = 0; s < nStates; s++)
+	{
+		firstDownMoves = min(firstDownMoves, (int)floor(gridPosition(s, shrinkFactor)));
+		lastDownMoves = max(lastDownMoves, (int)floor(gridPosition(s, shrinkFactor)) + 1);
+	}
+	vector<double> probabilities(lastDownMoves - firstDownMoves + 1, 0.0);
+	for (int s = 0; s < nStates; s++)
+	{
+		auto position = gridPosition(s, shrinkFactor);
+		auto downMoves = (int)floor(position);
+		auto fraction = position - (double)downMoves;
+		probabilities[downMoves - firstDownMoves] += (1.0 - fraction) * jumpDiffusionProbabilitiesPtr->at(s);
+		probabilities[downMoves + 1 - firstDownMoves] += fraction * jumpDiffusionProbabilitiesPtr->at(s);
+	}
+	auto probabilitiesPtr = make_shared<vector<double>>(move(probabilities));
+	return { firstDownMoves, probabilitiesPtr };
+}
 
 
-		// Add the nodes at the current time step to the tree
-		treeNodes.push_back(make_shared<vector<shared_ptr<TreeNode>>>(treeNodesI));
-		nPreviousTimeNodes = nCurrentTimeNodes;
+// Construct a jump diffusion tree which recombines after the jump. The nodes at each time are the points of a grid in log price, with node
+// j at time i being firstDownMoves + j down moves from the top of a tree without the jump. The diffusion steps move each node to nodes j and
+// j + 1, and the jump step moves each node to a consecutive range of grid points, as determined by snapJumpDiffusionStatesToGrid. Hence, the
+// number of nodes grows linearly with the number of time steps after the jump, rather than exponentially.
+std::shared_ptr<models::Tree> models::LogNormalDiffusionTreeHelper::constructRecombiningJumpDiffusionTree(const int nTimeSteps, 
+		const double timeToExpiry, const double jumpTime, const double dividendTime, const double dividendAmount, 
+		const double initialUnderlyingPrice,
+		const std::shared_ptr<std::vector<double>> jumpDiffusionStatesPtr,
+		const std::shared_ptr<std::vector<double>> jumpDiffusionProbabilitiesPtr,
+		const std::shared_ptr<std::vector<double>> diffusionStatesPtr,
+		const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr)
+{
+	int firstJumpDownMoves;
+	shared_ptr<vector<double>> jumpProbabilitiesPtr;
+	tie(firstJumpDownMoves, jumpProbabilitiesPtr) = snapJumpDiffusionStatesToGrid(jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr,
+		diffusionStatesPtr);
+	auto nJumpBranches = (int)jumpProbabilitiesPtr->size();
+
+	// Initialise tree
+	// ---------------------------------------------------------------------------
+	vector<int> levelOffsets;
+	vector<double> values;
+	vector<int> firstForwardIndex;
+	vector<unsigned char> nodeBranchingIndex;
+	vector<TreeBranching> branchings{ TreeBranching(), TreeBranching{ 2, 0 }, TreeBranching{ nJumpBranches, 1 } };
+	vector<vector<double>> branchProbabilities{ *diffusionProbabilitiesPtr, *jumpProbabilitiesPtr };
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+	levelOffsets.reserve(nTimeSteps + 2); // if there are two time steps, then there are a total of 3 times
+	levelOffsets.push_back(0);
+
+	// The grid points reached by the jump can lie above the top of a tree without the jump, i.e. have a negative number of down moves
+	RecombiningNodeValues nodeValues(initialUnderlyingPrice, diffusionStatesPtr->at(0), diffusionStatesPtr->at(1), nTimeSteps, 
+		min(0, firstJumpDownMoves), nTimeSteps + max(0, firstJumpDownMoves) + nJumpBranches);
+
+
+	// Construct the tree in forward time
+	// ---------------------------------------------------------------------------
+	auto firstDownMoves = 0; // the number of down moves of the first node at the current time
+	auto nCurrentTimeNodes = 0;
+	for (int i = 0; i < nTimeSteps + 1; i++)
+	{
+		auto time = timeStepSize * (double)i;
+		if (i == 0)
+			nCurrentTimeNodes = 1;
+		else if ((jumpTime > time - timeStepSize + 0.00000001) && (jumpTime <= time + 0.00000001)) // the jump has fallen within the last time step
+		{
+			firstDownMoves += firstJumpDownMoves;
+			nCurrentTimeNodes += nJumpBranches - 1;
+		}
+		else
+			nCurrentTimeNodes += 1;
+		auto isJumpInNextTimeStep = (jumpTime <= time + timeStepSize + 0.00000001) && (jumpTime > time + 0.00000001);
+		auto branchingIndex = i == nTimeSteps ? terminalBranchingIndex : (isJumpInNextTimeStep ? jumpBranchingIndex : diffusionBranchingIndex);
+		values.resize(values.size() + nCurrentTimeNodes);
+		nodeValues.getValues(i, firstDownMoves, nCurrentTimeNodes, &values[values.size() - nCurrentTimeNodes]);
+		for (int j = 0; j < nCurrentTimeNodes; j++) // node j branches to the nodes starting from j at the next time
+			firstForwardIndex.push_back(j);
+		nodeBranchingIndex.resize(values.size(), branchingIndex);
+		levelOffsets.push_back((int)values.size());
 	}
 
 
 	// Deduct dividends from tree
 	// ---------------------------------------------------------------------------
-	auto treeNodesPtr = make_shared<vector<shared_ptr<vector<shared_ptr<TreeNode>>>>>(move(treeNodes));
-	LogNormalDiffusionTreeHelper::deductDividend(treeNodesPtr, dividendTime, dividendAmount, timeToExpiry, timeStepSize, nTimeSteps);
+	auto dividendTimeIndex = LogNormalDiffusionTreeHelper::deductDividend(values, levelOffsets, dividendTime, dividendAmount, timeToExpiry, 
+		timeStepSize, nTimeSteps);
+
+	auto treePtr = make_shared<Tree>(nTimeSteps, timeToExpiry, move(levelOffsets), move(values), move(firstForwardIndex),
+		move(nodeBranchingIndex), move(branchings), move(branchProbabilities));
+	treePtr->setDividendTimeIndex(dividendTimeIndex);
+	return treePtr;
+}
+
+
+// Estimate the size of a recombining tree from its implicit lattice, which holds the same range of nodes at each time as the tree. The node k
+// down moves from the top at the current time branches to nodes k and k + 1 at the next time, less those truncated from the next time.
+const models::TreeSizeEstimate models::LogNormalDiffusionTreeHelper::estimateRecombiningTreeSize(
+	const std::shared_ptr<models::RecombiningLattice> latticePtr)
+{
+	TreeSizeEstimate estimate;
+	auto nTimeSteps = latticePtr->getNTimesSteps();
+	for (int i = 0; i < nTimeSteps + 1; i++)
+	{
+		auto nBranches = 0;
+		if (i < nTimeSteps)
+		{
+			auto first = latticePtr->getFirstDownMoves(i);
+			auto last = latticePtr->getLastDownMoves(i);
+			auto nextFirst = latticePtr->getFirstDownMoves(i + 1);
+			auto nextLast = latticePtr->getLastDownMoves(i + 1);
+			nBranches += max(0, min(last, nextLast) - max(first, nextFirst) + 1); // up moves
+			nBranches += max(0, min(last + 1, nextLast) - max(first + 1, nextFirst) + 1); // down moves
+		}
+		addLevelToTreeSizeEstimate(estimate, (double)latticePtr->getNNodes(i), (double)nBranches);
+	}
+	completeTreeSizeEstimate(estimate, nTimeSteps);
+	return estimate;
+}
+
+
+// Estimate the size of a jump diffusion tree, following the same levels as constructJumpDiffusionTreeTopology. The tree is recombining up to
+// the jump, after which each node branches out to nJumpDiffusionStates nodes at the jump, and to 2 nodes at every other time.
+const models::TreeSizeEstimate models::LogNormalDiffusionTreeHelper::estimateJumpDiffusionTreeSize(const int nTimeSteps, 
+	const double timeToExpiry, const double jumpTime, const int nJumpDiffusionStates)
+{
+	TreeSizeEstimate estimate;
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+	auto nPreviousTimeNodes = 0.0;
+	for (int i = 0; i < nTimeSteps + 1; i++)
+	{
+		auto time = timeStepSize * (double)i;
+		auto nCurrentTimeNodes = 0.0;
+		auto nFutureNodesPerCurrentNode = 2;
+		if ((jumpTime > time - timeStepSize + 0.00000001) && (jumpTime <= time + 0.00000001)) // the jump has fallen within the last time step
+			nCurrentTimeNodes = nPreviousTimeNodes * (double)nJumpDiffusionStates;
+		else if (jumpTime <= time - timeStepSize + 0.00000001) // the jump has already happened
+			nCurrentTimeNodes = nPreviousTimeNodes * 2.0;
+		else // the jump has not yet happened, so we are still a recombining tree
+		{
+			nCurrentTimeNodes = (double)(i + 1);
+			if ((jumpTime <= time + timeStepSize + 0.00000001) && (jumpTime > time + 0.00000001))
+				nFutureNodesPerCurrentNode = nJumpDiffusionStates;
+		}
+		if (i == nTimeSteps) // the nodes at the end of the tree do not branch out
+			nFutureNodesPerCurrentNode = 0;
+
+		addLevelToTreeSizeEstimate(estimate, nCurrentTimeNodes, nCurrentTimeNodes * (double)nFutureNodesPerCurrentNode);
+		nPreviousTimeNodes = nCurrentTimeNodes;
+	}
+	completeTreeSizeEstimate(estimate, nTimeSteps);
+	return estimate;
+}
+
+
+// Estimate the size of a jump diffusion tree which recombines after the jump, following the same levels as 
+// constructRecombiningJumpDiffusionTree. nJumpBranches is the number of grid points reached from each node by the jump.
+const models::TreeSizeEstimate models::LogNormalDiffusionTreeHelper::estimateRecombiningJumpDiffusionTreeSize(const int nTimeSteps, 
+	const double timeToExpiry, const double jumpTime, const int nJumpBranches)
+{
+	TreeSizeEstimate estimate;
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+	auto nCurrentTimeNodes = 0.0;
+	for (int i = 0; i < nTimeSteps + 1; i++)
+	{
+		auto time = timeStepSize * (double)i;
+		if (i == 0)
+			nCurrentTimeNodes = 1.0;
+		else if ((jumpTime > time - timeStepSize + 0.00000001) && (jumpTime <= time + 0.00000001)) // the jump has fallen within the last time step
+			nCurrentTimeNodes += (double)(nJumpBranches - 1);
+		else
+			nCurrentTimeNodes += 1.0;
+		auto isJumpInNextTimeStep = (jumpTime <= time + timeStepSize + 0.00000001) && (jumpTime > time + 0.00000001);
+		auto nFutureNodesPerCurrentNode = i == nTimeSteps ? 0 : (isJumpInNextTimeStep ? nJumpBranches : 2);
+		addLevelToTreeSizeEstimate(estimate, nCurrentTimeNodes, nCurrentTimeNodes * (double)nFutureNodesPerCurrentNode);
+	}
+	completeTreeSizeEstimate(estimate, nTimeSteps);
+	return estimate;
+}
 
-	return treeNodesPtr;
+
+void models::LogNormalDiffusionTreeHelper::addLevelToTreeSizeEstimate(models::TreeSizeEstimate& estimate, const double nNodes, 
+	const double nBranches)
+{
+	estimate.nNodes += nNodes;
+	estimate.nBranches += nBranches;
+	estimate.nMaxLevelNodes = fmax(estimate.nMaxLevelNodes, nNodes);
+}
+
+
+// Each node holds its value, first forward index and branching index, as laid out in the Tree and TreeTopology. The branchings and their 
+// probability tables are shared by all nodes, and are too small to be counted.
+void models::LogNormalDiffusionTreeHelper::completeTreeSizeEstimate(models::TreeSizeEstimate& estimate, const int nTimeSteps)
+{
+	estimate.nBytes = (double)(sizeof(Tree) + sizeof(TreeTopology)) + (double)(nTimeSteps + 2) * (double)sizeof(int)
+		+ estimate.nNodes * (double)(sizeof(double) + sizeof(int) + sizeof(unsigned char));
 }
 
 
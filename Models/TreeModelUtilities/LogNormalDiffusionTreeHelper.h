@@ -8,8 +8,13 @@
 #include "../../Instruments/VanillaOption.h"
 #include "../../Enumerations/Implementation.h"
 #include "../../Enumerations/OptionRight.h"
-#include "TreeNode.h"
+#include "../../Enumerations/NormalDistributionImplementation.h"
 #include "Tree.h"
+#include "TreeTopology.h"
+#include "TreeTopologyCache.h"
+#include "RecombiningLattice.h"
+#include "RecombiningNodeValues.h"
+#include "TreeSizeEstimate.h"
 
 namespace models
 {
@@ -19,6 +24,11 @@ namespace models
 	class LogNormalDiffusionTreeHelper
 	{
 	public:
+		// The probabilities of the 5 states of a normal jump, determined by moment matching the first four non-central moments of the normal
+		// distribution, along with the condition that the sum of all probabilities must equal to 1.
+		static constexpr int nNormalJumpStates = 5;
+		static constexpr double normalJumpProbabilities[nNormalJumpStates] = { 1.0 / 12.0, 1.0 / 6.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 12.0 };
+
 		// calculation of probabilities and states
 		static const std::tuple<std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vector<double>>> 
 			calculateDiffusionStatesAndProbabilities
@@ -41,27 +51,30 @@ namespace models
 			(const double costOfCarry, const double discountRate, const double impliedVolatility, const double underlyingPrice, 
 				const enumerations::UnderlyingCode underlyingCode, const double strike, 
 				const double timeStepSize, const enumerations::OptionRight optionRight);
+
+		static void
+			treeNodeEuropeanOptionValues
+			(const double costOfCarry, const double discountRate, const double impliedVolatility, const double* underlyingPrices, 
+				const int nNodes, const double strike, const double timeStepSize, const enumerations::OptionRight optionRight, 
+				double* values, const enumerations::NormalDistributionImplementation normalDistributionImplementation);
 		
 
 		// helper functions for the deduction of dividend
-		static void 
+		static int 
 			deductDividend
-			(std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>>& treePtr, const double& dividendTime, 
-				const double& dividendAmount, const double& timeToExpiry, const double& timeStepSize, const int& nTimeSteps);
+			(std::vector<double>& values, const std::vector<int>& levelOffsets, const double& dividendTime, const double& dividendAmount, 
+				const double& timeToExpiry, const double& timeStepSize, const int& nTimeSteps);
 
 
 		// functions for the construction of recombining trees
-		static std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>> 
-			constructInitialTreeNode
-			(const double initialUnderlyingPrice, const int& nFutureNodesPerCurrentNode, const std::shared_ptr<std::vector<double>>& probabilitiesPtr);
-
-		static std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>> 
+		static void 
 			constructRecombiningTreeNodes
-			(std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>& previousNodes, const double& upperLimit, const double& lowerLimit, 
-				const std::shared_ptr<std::vector<double>> diffusionStatesPtr, const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr, 
-				const bool& isDividendPaid, const double dividendAmount = -1.0, const bool& isLastTime = false);
+			(std::vector<int>& levelOffsets, std::vector<double>& values, std::vector<int>& firstForwardIndex, 
+				std::vector<unsigned char>& nodeBranchingIndex, const double& upperLimit, const double& lowerLimit, 
+				const models::RecombiningNodeValues& nodeValues, const int& timeIndex, int& firstDownMoves, const bool& isDividendPaid, 
+				const double dividendAmount = -1.0);
 
-		static std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>>
+		static std::shared_ptr<models::Tree>
 			constructRecombiningTree
 			(const double initialUnderlyingPrice, const int nTimeSteps, const double timeToExpiry, const double impliedVolatility, 
 				const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation, const double dividendTime, 
@@ -69,17 +82,63 @@ namespace models
 				const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr);
 
 
+		// functions for the construction of implicit recombining lattices
+		static std::shared_ptr<models::RecombiningLattice>
+			constructRecombiningLattice
+			(const double initialUnderlyingPrice, const int nTimeSteps, const double timeToExpiry, const double impliedVolatility, 
+				const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation, const double dividendTime, 
+				const double dividendAmount, const std::shared_ptr<std::vector<double>> diffusionStatesPtr, 
+				const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr);
+
+
 		// functions for the construction of a jump diffusion tree
-		static std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>>
+		static std::shared_ptr<const models::TreeTopology>
+			constructJumpDiffusionTreeTopology(const int nTimeSteps, const double timeToExpiry, const double jumpTime, 
+				const int nJumpDiffusionStates);
+
+		static std::shared_ptr<models::Tree>
 			constructJumpDiffusionTree(const int nTimeSteps, const double timeToExpiry,
+				const double jumpTime, const double dividendTime, const double dividendAmount, const double initialUnderlyingPrice,
+				const std::shared_ptr<std::vector<double>> jumpDiffusionStatesPtr,
+				const std::shared_ptr<std::vector<double>> jumpDiffusionProbabilitiesPtr,
+				const std::shared_ptr<std::vector<double>> diffusionStatesPtr,
+				const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr,
+				const std::shared_ptr<models::TreeTopologyCache>& treeTopologyCache); // nullptr to construct the topology
+
+
+		// functions for the construction of a jump diffusion tree which recombines after the jump
+		static const std::tuple<int, std::shared_ptr<std::vector<double>>>
+			snapJumpDiffusionStatesToGrid
+			(const std::shared_ptr<std::vector<double>> jumpDiffusionStatesPtr, 
+				const std::shared_ptr<std::vector<double>> jumpDiffusionProbabilitiesPtr, 
+				const std::shared_ptr<std::vector<double>> diffusionStatesPtr);
+
+		static std::shared_ptr<models::Tree>
+			constructRecombiningJumpDiffusionTree(const int nTimeSteps, const double timeToExpiry,
 				const double jumpTime, const double dividendTime, const double dividendAmount, const double initialUnderlyingPrice,
 				const std::shared_ptr<std::vector<double>> jumpDiffusionStatesPtr,
 				const std::shared_ptr<std::vector<double>> jumpDiffusionProbabilitiesPtr,
 				const std::shared_ptr<std::vector<double>> diffusionStatesPtr,
 				const std::shared_ptr<std::vector<double>> diffusionProbabilitiesPtr);
 
+
+		// functions for the estimation of the size of trees, without constructing them
+		static const models::TreeSizeEstimate
+			estimateRecombiningTreeSize(const std::shared_ptr<models::RecombiningLattice> latticePtr);
+
+		static const models::TreeSizeEstimate
+			estimateJumpDiffusionTreeSize(const int nTimeSteps, const double timeToExpiry, const double jumpTime, 
+				const int nJumpDiffusionStates);
+
+		static const models::TreeSizeEstimate
+			estimateRecombiningJumpDiffusionTreeSize(const int nTimeSteps, const double timeToExpiry, const double jumpTime, 
+				const int nJumpBranches);
+
 	private:
 		LogNormalDiffusionTreeHelper() {};
+
+		static void addLevelToTreeSizeEstimate(models::TreeSizeEstimate& estimate, const double nNodes, const double nBranches);
+		static void completeTreeSizeEstimate(models::TreeSizeEstimate& estimate, const int nTimeSteps);
 	};
 }
 
@@ -0,0 +1,73 @@
+#include <cmath>
+#include "RecombiningLattice.h"
+
+using namespace std;
+
+models::RecombiningLattice::RecombiningLattice(const int& nTimeSteps, const double& timeToExpiry, const double& initialUnderlyingPrice, 
+	const double& upState, const double& downState, const double& upProbability, const double& downProbability, const double& dividendTime,
+	const double& dividendAmount, std::vector<int>&& firstDownMoves, std::vector<int>&& lastDownMoves)
+{
+	setNTimeSteps(nTimeSteps);
+	setTimeToExpiry(timeToExpiry);
+	setInitialUnderlyingPrice(initialUnderlyingPrice);
+
+	// Input Validation
+	if (firstDownMoves.size() != nTimeSteps + 1 || lastDownMoves.size() != nTimeSteps + 1)
+		throw invalid_argument("The node ranges of the lattice do not match up with the number of time steps.");
+
+	m_upState = upState;
+	m_downState = downState;
+	m_upProbability = upProbability;
+	m_downProbability = downProbability;
+	m_dividendAmount = dividendAmount;
+	m_firstDownMoves = move(firstDownMoves);
+	m_lastDownMoves = move(lastDownMoves);
+	m_nodeValues = RecombiningNodeValues(initialUnderlyingPrice, upState, downState, nTimeSteps, 0, nTimeSteps);
+
+	// The dividend is deducted from each time step after its payment (rounding up if it is paid between discretisation times), provided that 
+	// it is paid before expiry
+	auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+	if (dividendTime <= timeToExpiry + 0.00000001)
+		m_dividendTimeIndex = (int)ceil(dividendTime / timeStepSize);
+	else
+		m_dividendTimeIndex = nTimeSteps + 1;
+}
+
+//// Calculates the underlying price at the node reached after timeIndex moves, of which nDownMoves are down moves
+const double models::RecombiningLattice::getValue(const int& timeIndex, const int& nDownMoves) const
+{
+	auto value = m_nodeValues.getValue(timeIndex, nDownMoves);
+	if (timeIndex >= m_dividendTimeIndex)
+		value = fmax(0.0, value - m_dividendAmount);
+	return value;
+}
+
+//// Calculates the underlying prices at the nNodes nodes at timeIndex, starting from the node reached by firstDownMoves down moves
+void models::RecombiningLattice::getValues(const int& timeIndex, const int& firstDownMoves, const int& nNodes, double* values) const
+{
+	m_nodeValues.getValues(timeIndex, firstDownMoves, nNodes, values);
+	if (timeIndex >= m_dividendTimeIndex)
+		for (int j = 0; j < nNodes; j++)
+			values[j] = fmax(0.0, values[j] - m_dividendAmount);
+}
+
+void models::RecombiningLattice::setTimeToExpiry(const double& value)
+{
+	if (value < -0.00000001)
+		throw invalid_argument("The time to expiry for the lattice must be greater than 0.");
+	m_timeToExpiry = value;
+}
+
+void models::RecombiningLattice::setNTimeSteps(const int& value)
+{
+	if (value < 1)
+		throw invalid_argument("The number of time steps for the lattice must be greater than 0.");
+	m_nTimeSteps = value;
+}
+
+void models::RecombiningLattice::setInitialUnderlyingPrice(const double& value)
+{
+	if (value < 0.00000001)
+		throw invalid_argument("The initial underlying price for the lattice must be greater than 0.");
+	m_initialUnderlyingPrice = value;
+}
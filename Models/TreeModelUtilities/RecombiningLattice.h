@@ -0,0 +1,69 @@
+#ifndef __RECOMBININGLATTICE_H__
+#define __RECOMBININGLATTICE_H__
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include "RecombiningNodeValues.h"
+
+using namespace std;
+
+namespace models
+{
+	// An implicit binomial recombining lattice for a lognormal diffusion. Unlike the Tree, the nodes are never materialised: the underlying
+	// price at each node is calculated on the fly from the initial underlying price, the up and down log moves, and the position of the node.
+	// A node is identified by its time index i and the number of down moves k taken to reach it, i.e. its underlying price is 
+	// S0 * exp((i - k) * upState + k * downState), less any dividend that has been paid. The truncation of the lattice by the upper and lower
+	// limits (and the 0 absorbing boundary at the payment of a dividend) is captured by the range of down moves [first, last] at each time, 
+	// so that the memory required is O(nTimeSteps) rather than O(nTimeSteps^2).
+	class RecombiningLattice
+	{
+	public:
+		RecombiningLattice(const int& nTimeSteps, const double& timeToExpiry, const double& initialUnderlyingPrice, const double& upState, 
+			const double& downState, const double& upProbability, const double& downProbability, const double& dividendTime, 
+			const double& dividendAmount, std::vector<int>&& firstDownMoves, std::vector<int>&& lastDownMoves);
+		RecombiningLattice() = default;
+		~RecombiningLattice() = default;
+
+		const int& getNTimesSteps() const { return m_nTimeSteps; }
+		const double& getTimeToExpiry() const { return m_timeToExpiry; }
+		const double& getInitialUnderlyingPrice() const { return m_initialUnderlyingPrice; }
+		const double& getUpState() const { return m_upState; }
+		const double& getDownState() const { return m_downState; }
+		const double& getUpProbability() const { return m_upProbability; }
+		const double& getDownProbability() const { return m_downProbability; }
+		const int& getDividendTimeIndex() const { return m_dividendTimeIndex; }
+		const double& getDividendAmount() const { return m_dividendAmount; }
+
+		// Layout of the nodes
+		const int& getFirstDownMoves(const int& timeIndex) const { return m_firstDownMoves[timeIndex]; }
+		const int& getLastDownMoves(const int& timeIndex) const { return m_lastDownMoves[timeIndex]; }
+		const int getNNodes(const int& timeIndex) const { return m_lastDownMoves[timeIndex] - m_firstDownMoves[timeIndex] + 1; }
+		const double getValue(const int& timeIndex, const int& nDownMoves) const;
+		void getValues(const int& timeIndex, const int& firstDownMoves, const int& nNodes, double* values) const;
+
+		RecombiningLattice& operator = (RecombiningLattice const&) = delete;
+		RecombiningLattice(RecombiningLattice const&) = delete;
+
+	private:
+		int m_nTimeSteps; // the number of time steps in the lattice
+		double m_timeToExpiry; // the time to maturity for the lattice
+		double m_initialUnderlyingPrice;
+		double m_upState; // log multiplier of an up move
+		double m_downState; // log multiplier of a down move
+		double m_upProbability;
+		double m_downProbability;
+		int m_dividendTimeIndex; // the first time index from which the dividend is deducted. Set to after the expiry if no dividend is paid
+		double m_dividendAmount;
+		std::vector<int> m_firstDownMoves; // the number of down moves to reach the first (highest) node at each time
+		std::vector<int> m_lastDownMoves; // the number of down moves to reach the last (lowest) node at each time
+		models::RecombiningNodeValues m_nodeValues; // the underlying prices at the nodes, before the deduction of the dividend
+
+		// Setters
+		void setNTimeSteps(const int& value);
+		void setTimeToExpiry(const double& value);
+		void setInitialUnderlyingPrice(const double& value);
+	};
+}
+
+#endif // !__RECOMBININGLATTICE_H__
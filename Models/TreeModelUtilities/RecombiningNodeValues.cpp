@@ -0,0 +1,32 @@
+#include <cmath>
+#include <stdexcept>
+#include "RecombiningNodeValues.h"
+
+using namespace std;
+
+models::RecombiningNodeValues::RecombiningNodeValues(const double& initialUnderlyingPrice, const double& upState, const double& downState,
+	const int& nTimeSteps, const int& minDownMoves, const int& maxDownMoves)
+{
+	// Input Validation
+	if (nTimeSteps < 0)
+		throw invalid_argument("The number of time steps for the node values must be at least 0.");
+	if (maxDownMoves < minDownMoves)
+		throw invalid_argument("The maximum number of down moves must be at least the minimum number of down moves.");
+
+	m_minDownMoves = minDownMoves;
+	m_topValues.reserve(nTimeSteps + 1);
+	for (int i = 0; i < nTimeSteps + 1; i++)
+		m_topValues.push_back(initialUnderlyingPrice * exp((double)i * upState));
+	m_downMovePowers.reserve(maxDownMoves - minDownMoves + 1);
+	for (int k = minDownMoves; k < maxDownMoves + 1; k++)
+		m_downMovePowers.push_back(exp((double)k * (downState - upState)));
+}
+
+//// The nodes at a time are the price of the top node scaled by consecutive powers, so the loop is a single multiplication per node
+void models::RecombiningNodeValues::getValues(const int& timeIndex, const int& firstDownMoves, const int& nNodes, double* values) const
+{
+	auto topValue = m_topValues[timeIndex];
+	auto downMovePowers = m_downMovePowers.data() + (firstDownMoves - m_minDownMoves);
+	for (int j = 0; j < nNodes; j++)
+		values[j] = topValue * downMovePowers[j];
+}
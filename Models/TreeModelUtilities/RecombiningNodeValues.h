@@ -0,0 +1,39 @@
+#ifndef __RECOMBININGNODEVALUES_H__
+#define __RECOMBININGNODEVALUES_H__
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace models
+{
+	// Generates the underlying prices at the nodes of a recombining tree in closed form. The node at time i reached by k down moves has the 
+	// price S0 * u^(i - k) * d^k = (S0 * u^i) * (d / u)^k, with u = exp(upState) and d = exp(downState). The price of the top node at each time 
+	// and the powers of d / u are calculated once, as exp(n * state), so that each node only requires a single multiplication rather than an
+	// exp, and the rounding does not accumulate through the tree as it does when multiplying the price of the previous node. The number of 
+	// down moves can be negative for grids that extend above the top of the tree (e.g. after a jump).
+	class RecombiningNodeValues
+	{
+	public:
+		RecombiningNodeValues(const double& initialUnderlyingPrice, const double& upState, const double& downState, const int& nTimeSteps,
+			const int& minDownMoves, const int& maxDownMoves);
+		RecombiningNodeValues() = default;
+		~RecombiningNodeValues() = default;
+
+		const double getValue(const int& timeIndex, const int& nDownMoves) const 
+		{ 
+			return m_topValues[timeIndex] * m_downMovePowers[nDownMoves - m_minDownMoves]; 
+		}
+
+		// the prices of the nNodes nodes at timeIndex, starting from the node reached by firstDownMoves down moves
+		void getValues(const int& timeIndex, const int& firstDownMoves, const int& nNodes, double* values) const;
+
+	private:
+		int m_minDownMoves; // the number of down moves of the first power
+		std::vector<double> m_topValues; // S0 * exp(i * upState) for each time i
+		std::vector<double> m_downMovePowers; // exp(k * (downState - upState)) for k in [minDownMoves, maxDownMoves]
+	};
+}
+
+#endif // !__RECOMBININGNODEVALUES_H__
@@ -2,13 +2,67 @@
 
 using namespace std;
 
-models::Tree::Tree(const std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>>& treeNodes, 
-	const int& nTimeSteps, 
-	const double& timeToExpiry)
+models::Tree::Tree(const int& nTimeSteps, const double& timeToExpiry, std::vector<int>&& levelOffsets, std::vector<double>&& values,
+	std::vector<int>&& firstForwardIndex, std::vector<unsigned char>&& nodeBranchingIndex, std::vector<models::TreeBranching>&& branchings,
+	std::vector<std::vector<double>>&& branchProbabilities)
+	: Tree(timeToExpiry, make_shared<const TreeTopology>(nTimeSteps, move(levelOffsets), move(firstForwardIndex), move(nodeBranchingIndex),
+		move(branchings)), move(values), move(branchProbabilities))
 {
-	setTreeNodes(treeNodes);
-	setNTimeSteps(nTimeSteps);
+}
+
+models::Tree::Tree(const double& timeToExpiry, const std::shared_ptr<const models::TreeTopology>& topology, std::vector<double>&& values,
+	std::vector<std::vector<double>>&& branchProbabilities)
+{
+	setNTimeSteps(topology->getNTimesSteps());
 	setTimeToExpiry(timeToExpiry);
+
+	// Input Validation
+	if (topology->getNNodes() != values.size())
+		throw invalid_argument("The level offsets of the tree do not match up with the number of time steps and nodes.");
+	for (auto& branching : topology->getBranchings())
+		if (branching.nBranches > 0 && (branching.probabilitiesIndex < 0 || branching.probabilitiesIndex >= branchProbabilities.size()
+			|| branchProbabilities[branching.probabilitiesIndex].size() != branching.nBranches))
+			throw invalid_argument("The branch probabilities must have the same size as the branchings which refer to them.");
+
+	m_topology = topology;
+	m_values = move(values);
+	m_branchProbabilities = move(branchProbabilities);
+	m_dividendTimeIndex = m_nTimeSteps + 1;
+	identifyLevelBranchings();
+}
+
+//// Identifies the times at which all nodes share the same branching, which allows the backward induction on these levels to be specialised
+//// on the number of branches. Also flags the times from which every node j branches to nodes j and j + 1 at the next time with the same 
+//// branching, which allows the backward induction on these levels to be done without loading the forward index and branching of each node.
+void models::Tree::identifyLevelBranchings()
+{
+	auto& levelOffsets = getLevelOffsets();
+	auto& firstForwardIndex = getFirstForwardIndex();
+	auto& nodeBranchingIndex = getNodeBranchingIndex();
+	m_isBinomialLevel.assign(m_nTimeSteps + 1, false); // the nodes at the last time do not branch out
+	m_levelBranchingIndex.assign(m_nTimeSteps + 1, -1);
+	for (int i = 0; i < m_nTimeSteps + 1; i++)
+	{
+		auto firstNode = levelOffsets[i];
+		auto isSharedBranching = levelOffsets[i + 1] > firstNode;
+		auto isBinomialLevel = isSharedBranching && i < m_nTimeSteps && getBranching(firstNode).nBranches == 2;
+		for (int j = 0; j < levelOffsets[i + 1] - firstNode && isSharedBranching; j++)
+		{
+			isSharedBranching = nodeBranchingIndex[firstNode + j] == nodeBranchingIndex[firstNode];
+			isBinomialLevel = isBinomialLevel && isSharedBranching && firstForwardIndex[firstNode + j] == j;
+		}
+		m_isBinomialLevel[i] = isBinomialLevel;
+		m_levelBranchingIndex[i] = isSharedBranching ? nodeBranchingIndex[firstNode] : -1;
+	}
+}
+
+const size_t models::Tree::getNBytes() const
+{
+	auto nBytes = sizeof(Tree) + m_topology->getNBytes() + m_values.capacity() * sizeof(double) + m_isBinomialLevel.capacity() / 8
+		+ m_levelBranchingIndex.capacity() * sizeof(int);
+	for (auto& probabilities : m_branchProbabilities)
+		nBytes += sizeof(probabilities) + probabilities.capacity() * sizeof(double);
+	return nBytes;
 }
 
 void models::Tree::setTimeToExpiry(const double& value)
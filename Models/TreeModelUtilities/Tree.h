@@ -1,41 +1,81 @@
-#ifndef __TREE_H__ 
+#ifndef __TREE_H__
 #define __TREE_H__
 
 #include <iostream>
 #include <vector>
 #include <memory>
-#include "TreeNode.h"
+#include "TreeTopology.h"
 
 using namespace std;
 
 namespace models
 {
+	// The tree is stored as a flat structure of arrays. The nodes of all times are laid out contiguously in m_values, with m_levelOffsets
+	// giving the index of the first node at each time. The branches of node n go to consecutive nodes at the next time, starting from its
+	// first forward index relative to the first node of the next time, and are described by one of a few shared branchings. The probabilities
+	// of the branches are held once per branching in m_branchProbabilities, rather than once per branch. The offsets, forward indices and
+	// branchings are held in an immutable TreeTopology, which can be shared by trees with the same structure.
 	class Tree
 	{
 	public:
-		Tree(const std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>>& treeNodes, const int& nTimeSteps, 
-			const double& timeToExpiry);
+		Tree(const int& nTimeSteps, const double& timeToExpiry, std::vector<int>&& levelOffsets, std::vector<double>&& values,
+			std::vector<int>&& firstForwardIndex, std::vector<unsigned char>&& nodeBranchingIndex, 
+			std::vector<models::TreeBranching>&& branchings, std::vector<std::vector<double>>&& branchProbabilities);
+		Tree(const double& timeToExpiry, const std::shared_ptr<const models::TreeTopology>& topology, std::vector<double>&& values,
+			std::vector<std::vector<double>>&& branchProbabilities);
 		Tree() = default;
 		~Tree() = default;
 
-		const std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>> getTreeNodes() const { return m_treeNodes; }
 		const int& getNTimesSteps() const { return m_nTimeSteps; }
 		const double& getTimeToExpiry() const { return m_timeToExpiry; }
 
+		// Layout of the nodes
+		const std::shared_ptr<const models::TreeTopology>& getTopology() const { return m_topology; }
+		const std::vector<int>& getLevelOffsets() const { return m_topology->getLevelOffsets(); }
+		const std::vector<double>& getValues() const { return m_values; }
+		const int getNNodes() const { return (int)m_values.size(); }
+		const int getNNodes(const int& timeIndex) const { return getLevelOffsets()[timeIndex + 1] - getLevelOffsets()[timeIndex]; }
+		const double& getValue(const int& timeIndex, const int& nodeIndex) const { return m_values[getLevelOffsets()[timeIndex] + nodeIndex]; }
+
+		// Layout of the branches
+		const std::vector<int>& getFirstForwardIndex() const { return m_topology->getFirstForwardIndex(); }
+		const std::vector<unsigned char>& getNodeBranchingIndex() const { return m_topology->getNodeBranchingIndex(); }
+		const std::vector<models::TreeBranching>& getBranchings() const { return m_topology->getBranchings(); }
+		const models::TreeBranching& getBranching(const int& node) const { return m_topology->getBranching(node); }
+		const int& getNBranches() const { return m_topology->getNBranches(); }
+		const std::vector<std::vector<double>>& getBranchProbabilities() const { return m_branchProbabilities; }
+
+		// A regular binomial level is one where node j branches to nodes j and j + 1 at the next time, with the same probabilities for all nodes
+		const bool isBinomialLevel(const int& timeIndex) const { return m_isBinomialLevel[timeIndex]; }
+
+		// The index of the branching shared by all nodes at a time, or -1 if the nodes have different branchings
+		const int& getLevelBranchingIndex(const int& timeIndex) const { return m_levelBranchingIndex[timeIndex]; }
+
+		// The first time index from whose nodes a dividend has been deducted, or after the expiry if no dividend is paid
+		const int& getDividendTimeIndex() const { return m_dividendTimeIndex; }
+		void setDividendTimeIndex(const int& value) { m_dividendTimeIndex = value; }
+
+		const size_t getNBytes() const; // the memory held by the tree, including its topology
+
 		Tree& operator = (Tree const&) = delete;
 		Tree(Tree const&) = delete;
 
 	private:
-		std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>> m_treeNodes; // the actual tree
 		int m_nTimeSteps; // the number of time steps in the tree
 		double m_timeToExpiry; // the time to maturity for the tree
+		std::shared_ptr<const models::TreeTopology> m_topology; // the offsets of the levels, the forward indices and the branchings
+		std::vector<double> m_values; // the underlying price at each node
+		std::vector<std::vector<double>> m_branchProbabilities; // the tables of branch probabilities referred to by the branchings
+		std::vector<bool> m_isBinomialLevel; // whether the branching from each time is a regular binomial step
+		std::vector<int> m_levelBranchingIndex; // the branching shared by all nodes at each time, or -1
+		int m_dividendTimeIndex; // the first time index from which the dividend is deducted. Set to after the expiry if no dividend is paid
+
+		void identifyLevelBranchings();
 
 		// Setters
-		void setTreeNodes(const std::shared_ptr<std::vector<std::shared_ptr<std::vector<std::shared_ptr<models::TreeNode>>>>>& value) 
-		{ m_treeNodes = value; }
 		void setNTimeSteps(const int& value);
 		void setTimeToExpiry(const double& value);
 	};
 }
 
-#endif // !__TREE_H__ 
+#endif // !__TREE_H__
@@ -0,0 +1,18 @@
+#ifndef __TREEBRANCHING_H__
+#define __TREEBRANCHING_H__
+
+#include <iostream>
+
+namespace models
+{
+	// The branching out of a node to the nodes at the next time. The branches go to consecutive nodes at the next time, starting from the
+	// first forward index of the node, and their probabilities are the table of the tree identified by probabilitiesIndex. A tree only has a
+	// handful of distinct branchings, which are shared by all of its nodes.
+	struct TreeBranching
+	{
+		int nBranches = 0; // the number of branches, which is 0 for the nodes at the last time
+		int probabilitiesIndex = -1; // the index of the table of branch probabilities, or -1 if there are no branches
+	};
+}
+
+#endif // !__TREEBRANCHING_H__
@@ -0,0 +1,118 @@
+#include <functional>
+#include "TreeCache.h"
+
+using namespace std;
+using namespace enumerations;
+
+models::TreeCache::TreeCache(const size_t& maxBytes)
+{
+	setMaxBytes(maxBytes);
+}
+
+const size_t models::TreeCache::getNBytes()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_nBytes;
+}
+
+const int models::TreeCache::getNTrees()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (int)m_entries.size();
+}
+
+const int models::TreeCache::getNHits()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_nHits;
+}
+
+const int models::TreeCache::getNMisses()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_nMisses;
+}
+
+void models::TreeCache::setMaxBytes(const size_t& value)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_maxBytes = value;
+	evict(m_maxBytes);
+}
+
+//// Looks up the tree by its key, moving it to the front of the recently used list if it is found. Otherwise the tree is constructed outside
+//// of the lock, so that other pricers are not blocked while a large tree is built, and inserted if it fits in the cache.
+const std::shared_ptr<models::Tree> models::TreeCache::getTree(const std::shared_ptr<models::ITreeModel>& model, const int& nTimeSteps,
+	const double& timeToExpiry, const enumerations::Implementation implementation, const double upperLimitStandardDeviation,
+	const double lowerLimitStandardDeviation)
+{
+	auto treeParameters = model->getTreeParameters();
+	if (treeParameters.empty())
+		return model->constructTree(nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, lowerLimitStandardDeviation);
+
+	Key key{ type_index(typeid(*model)), move(treeParameters), nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation,
+		lowerLimitStandardDeviation };
+	{
+		lock_guard<mutex> lock(m_mutex);
+		auto entry = m_index.find(key);
+		if (entry != m_index.end())
+		{
+			m_nHits++;
+			m_entries.splice(m_entries.begin(), m_entries, entry->second);
+			return entry->second->second;
+		}
+		m_nMisses++;
+	}
+
+	auto tree = model->constructTree(nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, lowerLimitStandardDeviation);
+	auto nBytes = tree->getNBytes();
+
+	lock_guard<mutex> lock(m_mutex);
+	if (nBytes > m_maxBytes || m_index.find(key) != m_index.end()) // too large to cache, or cached by another pricer in the meantime
+		return tree;
+	evict(m_maxBytes - nBytes);
+	m_entries.emplace_front(key, tree);
+	m_index.emplace(move(key), m_entries.begin());
+	m_nBytes += nBytes;
+	return tree;
+}
+
+void models::TreeCache::clear()
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_index.clear();
+	m_entries.clear();
+	m_nBytes = 0;
+}
+
+//// Removes the least recently used trees until the total size of the cached trees is at most maxBytes. The caller must hold the lock.
+void models::TreeCache::evict(const size_t& maxBytes)
+{
+	while (m_nBytes > maxBytes && !m_entries.empty())
+	{
+		m_nBytes -= m_entries.back().second->getNBytes();
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+}
+
+bool models::TreeCache::Key::operator == (Key const& other) const
+{
+	return modelType == other.modelType && treeParameters == other.treeParameters && nTimeSteps == other.nTimeSteps 
+		&& timeToExpiry == other.timeToExpiry && implementation == other.implementation 
+		&& upperLimitStandardDeviation == other.upperLimitStandardDeviation && lowerLimitStandardDeviation == other.lowerLimitStandardDeviation;
+}
+
+size_t models::TreeCache::KeyHash::operator () (Key const& key) const
+{
+	auto seed = key.modelType.hash_code();
+	auto combine = [&seed](const size_t& value) { seed ^= value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2); };
+	for (auto& treeParameter : key.treeParameters)
+		combine(hash<double>()(treeParameter));
+	combine(hash<int>()(key.nTimeSteps));
+	combine(hash<double>()(key.timeToExpiry));
+	combine(hash<int>()((int)key.implementation));
+	combine(hash<double>()(key.upperLimitStandardDeviation));
+	combine(hash<double>()(key.lowerLimitStandardDeviation));
+	return seed;
+}
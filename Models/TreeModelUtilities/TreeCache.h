@@ -0,0 +1,80 @@
+#ifndef __TREECACHE_H__
+#define __TREECACHE_H__
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <typeindex>
+#include "ITreeModel.h"
+#include "Tree.h"
+#include "../../Enumerations/Implementation.h"
+
+namespace models
+{
+	// A size bounded, least recently used cache of constructed trees, which can be shared across pricers and calls. Trees are keyed by the
+	// type and tree parameters of the model, together with the number of time steps, time to expiry, implementation and truncation limits 
+	// used to construct them. Repeated pricing with unchanged inputs then reuses the tree rather than constructing it again. The cached trees
+	// are immutable, so a tree returned by the cache can be used by several pricers at once.
+	class TreeCache
+	{
+	public:
+		TreeCache(const size_t& maxBytes);
+		TreeCache() = default;
+		~TreeCache() = default;
+
+		// Getters
+		const size_t& getMaxBytes() const { return m_maxBytes; }
+		const size_t getNBytes();
+		const int getNTrees();
+		const int getNHits();
+		const int getNMisses();
+
+		// Setters
+		void setMaxBytes(const size_t& value); // evicts the least recently used trees until the cache is within the new size
+
+		// Returns the tree of the model from the cache, or constructs the tree with the model and caches it if it is not present. Trees of 
+		// models which do not provide their tree parameters are never cached.
+		const std::shared_ptr<models::Tree> getTree(const std::shared_ptr<models::ITreeModel>& model, const int& nTimeSteps, 
+			const double& timeToExpiry, const enumerations::Implementation implementation, const double upperLimitStandardDeviation, 
+			const double lowerLimitStandardDeviation);
+		void clear();
+
+		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
+		TreeCache& operator = (TreeCache const&) = delete;
+		TreeCache(TreeCache const&) = delete;
+
+	private:
+		struct Key
+		{
+			std::type_index modelType;
+			std::vector<double> treeParameters;
+			int nTimeSteps;
+			double timeToExpiry;
+			enumerations::Implementation implementation;
+			double upperLimitStandardDeviation;
+			double lowerLimitStandardDeviation;
+
+			bool operator == (Key const& other) const;
+		};
+		struct KeyHash
+		{
+			size_t operator () (Key const& key) const;
+		};
+		typedef std::list<std::pair<Key, std::shared_ptr<models::Tree>>> Entries;
+
+		size_t m_maxBytes = 256 * 1024 * 1024; // the maximum total size of the cached trees
+		size_t m_nBytes = 0; // the total size of the cached trees
+		int m_nHits = 0;
+		int m_nMisses = 0;
+		Entries m_entries; // the cached trees, from the most to the least recently used
+		std::unordered_map<Key, Entries::iterator, KeyHash> m_index;
+		std::mutex m_mutex;
+
+		void evict(const size_t& maxBytes);
+	};
+}
+
+#endif // !__TREECACHE_H__
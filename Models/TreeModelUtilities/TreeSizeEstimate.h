@@ -0,0 +1,20 @@
+#ifndef __TREESIZEESTIMATE_H__
+#define __TREESIZEESTIMATE_H__
+
+#include <iostream>
+
+namespace models
+{
+	// The predicted size of a tree, calculated from its structure without constructing it. The counts are held as doubles, as the number of
+	// nodes in a tree which branches out after a jump can exceed the range of an integer long before the tree could ever be constructed.
+	// The bytes are those of the node and branch arrays of the tree, i.e. the memory which is allocated on construction.
+	struct TreeSizeEstimate
+	{
+		double nNodes = 0.0; // the total number of nodes at all times
+		double nBranches = 0.0; // the total number of branches from all nodes
+		double nMaxLevelNodes = 0.0; // the largest number of nodes at any one time
+		double nBytes = 0.0;
+	};
+}
+
+#endif // !__TREESIZEESTIMATE_H__
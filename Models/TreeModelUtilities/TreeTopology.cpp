@@ -0,0 +1,59 @@
+#include "TreeTopology.h"
+
+using namespace std;
+
+models::TreeTopology::TreeTopology(const int& nTimeSteps, std::vector<int>&& levelOffsets, std::vector<int>&& firstForwardIndex,
+	std::vector<unsigned char>&& nodeBranchingIndex, std::vector<models::TreeBranching>&& branchings)
+	: TreeTopology(nTimeSteps, move(levelOffsets), move(firstForwardIndex), move(nodeBranchingIndex), move(branchings), vector<bool>(),
+		vector<int>())
+{
+}
+
+models::TreeTopology::TreeTopology(const int& nTimeSteps, std::vector<int>&& levelOffsets, std::vector<int>&& firstForwardIndex,
+	std::vector<unsigned char>&& nodeBranchingIndex, std::vector<models::TreeBranching>&& branchings, std::vector<bool>&& isRecombiningLevel,
+	std::vector<int>&& levelStatesIndex)
+{
+	// Input Validation
+	if (nTimeSteps < 0)
+		throw invalid_argument("The number of time steps for the tree must be greater than 0.");
+	if (levelOffsets.size() != nTimeSteps + 2 || firstForwardIndex.size() != levelOffsets.back()
+		|| nodeBranchingIndex.size() != levelOffsets.back())
+		throw invalid_argument("The level offsets of the tree do not match up with the number of time steps and nodes.");
+	if (branchings.empty() || branchings.size() > 256) // the branching of each node is identified by a single byte
+		throw invalid_argument("The tree must have between 1 and 256 distinct branchings.");
+	if ((!isRecombiningLevel.empty() && isRecombiningLevel.size() != nTimeSteps + 1)
+		|| (!levelStatesIndex.empty() && levelStatesIndex.size() != nTimeSteps + 1))
+		throw invalid_argument("The generation of the levels of the tree does not match up with the number of time steps.");
+
+	// The branches of each node must hit nodes at the next time, and the nodes at the last time must not branch out
+	auto nBranches = 0;
+	for (int i = 0; i < nTimeSteps + 1; i++)
+	{
+		auto nNextNodes = i < nTimeSteps ? levelOffsets[i + 2] - levelOffsets[i + 1] : 0;
+		for (int n = levelOffsets[i]; n < levelOffsets[i + 1]; n++)
+		{
+			if (nodeBranchingIndex[n] >= branchings.size())
+				throw invalid_argument("The branching of a node of the tree does not exist.");
+			auto& branching = branchings[nodeBranchingIndex[n]];
+			if (branching.nBranches > 0 && (firstForwardIndex[n] < 0 || firstForwardIndex[n] + branching.nBranches > nNextNodes))
+				throw invalid_argument("The branches of a node of the tree do not hit the nodes at the next time.");
+			nBranches += branching.nBranches;
+		}
+	}
+
+	m_nTimeSteps = nTimeSteps;
+	m_nBranches = nBranches;
+	m_levelOffsets = move(levelOffsets);
+	m_firstForwardIndex = move(firstForwardIndex);
+	m_nodeBranchingIndex = move(nodeBranchingIndex);
+	m_branchings = move(branchings);
+	m_isRecombiningLevel = move(isRecombiningLevel);
+	m_levelStatesIndex = move(levelStatesIndex);
+}
+
+const size_t models::TreeTopology::getNBytes() const
+{
+	return sizeof(TreeTopology) + (m_levelOffsets.capacity() + m_firstForwardIndex.capacity() + m_levelStatesIndex.capacity()) * sizeof(int)
+		+ m_nodeBranchingIndex.capacity() * sizeof(unsigned char) + m_branchings.capacity() * sizeof(TreeBranching)
+		+ m_isRecombiningLevel.capacity() / 8;
+}
@@ -0,0 +1,67 @@
+#ifndef __TREETOPOLOGY_H__
+#define __TREETOPOLOGY_H__
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include "TreeBranching.h"
+
+using namespace std;
+
+namespace models
+{
+	// The branching structure of a tree, i.e. everything about the tree except for the underlying prices at the nodes and the probabilities of
+	// the branches. The layout is the same as that of the Tree: m_levelOffsets gives the index of the first node at each time. The branches of
+	// node n go to the consecutive nodes at the next time starting from m_firstForwardIndex[n], relative to the first node of the next time,
+	// and are described by the shared branching m_branchings[m_nodeBranchingIndex[n]]. Hence, each node holds an offset and a small index 
+	// rather than a forward index and probability for each of its branches. The topology is immutable, so a single topology can be shared by
+	// all trees with the same structure, with only the values and probability tables filled in for each tree.
+	//
+	// The topology can also describe how the values of each level are generated. The nodes of a recombining level are an up move from the 
+	// first node at the previous time followed by a down move from each node at the previous time. The nodes of any other level branch out
+	// from each node at the previous time, in order of the states. m_levelStatesIndex identifies the set of states used to generate the nodes
+	// of each level.
+	class TreeTopology
+	{
+	public:
+		TreeTopology(const int& nTimeSteps, std::vector<int>&& levelOffsets, std::vector<int>&& firstForwardIndex, 
+			std::vector<unsigned char>&& nodeBranchingIndex, std::vector<models::TreeBranching>&& branchings);
+		TreeTopology(const int& nTimeSteps, std::vector<int>&& levelOffsets, std::vector<int>&& firstForwardIndex, 
+			std::vector<unsigned char>&& nodeBranchingIndex, std::vector<models::TreeBranching>&& branchings, 
+			std::vector<bool>&& isRecombiningLevel, std::vector<int>&& levelStatesIndex);
+		TreeTopology() = default;
+		~TreeTopology() = default;
+
+		const int& getNTimesSteps() const { return m_nTimeSteps; }
+
+		// Layout of the nodes and branches
+		const std::vector<int>& getLevelOffsets() const { return m_levelOffsets; }
+		const std::vector<int>& getFirstForwardIndex() const { return m_firstForwardIndex; }
+		const std::vector<unsigned char>& getNodeBranchingIndex() const { return m_nodeBranchingIndex; }
+		const std::vector<models::TreeBranching>& getBranchings() const { return m_branchings; }
+		const models::TreeBranching& getBranching(const int& node) const { return m_branchings[m_nodeBranchingIndex[node]]; }
+		const int getNNodes() const { return m_levelOffsets.back(); }
+		const int& getNBranches() const { return m_nBranches; }
+
+		// Generation of the values of each level. These are empty if the topology does not describe the generation.
+		const std::vector<bool>& getIsRecombiningLevel() const { return m_isRecombiningLevel; }
+		const std::vector<int>& getLevelStatesIndex() const { return m_levelStatesIndex; }
+
+		const size_t getNBytes() const; // the memory held by the topology
+
+		TreeTopology& operator = (TreeTopology const&) = delete;
+		TreeTopology(TreeTopology const&) = delete;
+
+	private:
+		int m_nTimeSteps; // the number of time steps in the tree
+		int m_nBranches; // the total number of branches from all nodes
+		std::vector<int> m_levelOffsets; // the index of the first node at each time, with a final entry equal to the total number of nodes
+		std::vector<int> m_firstForwardIndex; // the index of the node at the next time hit by the first branch of each node
+		std::vector<unsigned char> m_nodeBranchingIndex; // the index of the branching of each node
+		std::vector<models::TreeBranching> m_branchings; // the distinct branchings of the nodes
+		std::vector<bool> m_isRecombiningLevel; // whether the nodes at each time are generated as a recombining level
+		std::vector<int> m_levelStatesIndex; // the set of states which generates the nodes at each time from the nodes at the previous time
+	};
+}
+
+#endif // !__TREETOPOLOGY_H__
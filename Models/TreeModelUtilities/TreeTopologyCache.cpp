@@ -0,0 +1,115 @@
+#include <functional>
+#include "TreeTopologyCache.h"
+#include "LogNormalDiffusionTreeHelper.h"
+
+using namespace std;
+
+models::TreeTopologyCache::TreeTopologyCache(const size_t& maxBytes)
+{
+	setMaxBytes(maxBytes);
+}
+
+const size_t models::TreeTopologyCache::getNBytes()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_nBytes;
+}
+
+const int models::TreeTopologyCache::getNTopologies()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (int)m_entries.size();
+}
+
+const int models::TreeTopologyCache::getNHits()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_nHits;
+}
+
+const int models::TreeTopologyCache::getNMisses()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_nMisses;
+}
+
+void models::TreeTopologyCache::setMaxBytes(const size_t& value)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_maxBytes = value;
+	evict(m_maxBytes);
+}
+
+//// Looks up the topology by its key, moving it to the front of the recently used list if it is found. Otherwise the topology is constructed
+//// outside of the lock, so that other models are not blocked while a large topology is built, and inserted if it fits in the cache and has
+//// not been inserted by another model in the meantime.
+const std::shared_ptr<const models::TreeTopology> models::TreeTopologyCache::getJumpDiffusionTreeTopology(const int& nTimeSteps, 
+	const double& timeToExpiry, const double& jumpTime, const int& nJumpDiffusionStates)
+{
+	Key key{ nTimeSteps, timeToExpiry, jumpTime, nJumpDiffusionStates };
+	{
+		lock_guard<mutex> lock(m_mutex);
+		auto entry = m_index.find(key);
+		if (entry != m_index.end())
+		{
+			m_nHits++;
+			m_entries.splice(m_entries.begin(), m_entries, entry->second);
+			return entry->second->second;
+		}
+		m_nMisses++;
+	}
+
+	auto topology = LogNormalDiffusionTreeHelper::constructJumpDiffusionTreeTopology(nTimeSteps, timeToExpiry, jumpTime, nJumpDiffusionStates);
+	auto nBytes = topology->getNBytes();
+
+	lock_guard<mutex> lock(m_mutex);
+	auto entry = m_index.find(key);
+	if (entry != m_index.end()) // cached by another model in the meantime, which is returned so that the trees share a single topology
+	{
+		m_entries.splice(m_entries.begin(), m_entries, entry->second);
+		return entry->second->second;
+	}
+	if (nBytes > m_maxBytes) // too large to cache
+		return topology;
+	evict(m_maxBytes - nBytes);
+	m_entries.emplace_front(key, topology);
+	m_index.emplace(key, m_entries.begin());
+	m_nBytes += nBytes;
+	return topology;
+}
+
+void models::TreeTopologyCache::clear()
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_index.clear();
+	m_entries.clear();
+	m_nBytes = 0;
+}
+
+//// Removes the least recently used topologies until the total size of the cached topologies is at most maxBytes. The caller must hold the 
+//// lock.
+void models::TreeTopologyCache::evict(const size_t& maxBytes)
+{
+	while (m_nBytes > maxBytes && !m_entries.empty())
+	{
+		m_nBytes -= m_entries.back().second->getNBytes();
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+}
+
+bool models::TreeTopologyCache::Key::operator == (Key const& other) const
+{
+	return nTimeSteps == other.nTimeSteps && timeToExpiry == other.timeToExpiry && jumpTime == other.jumpTime 
+		&& nJumpDiffusionStates == other.nJumpDiffusionStates;
+}
+
+size_t models::TreeTopologyCache::KeyHash::operator () (Key const& key) const
+{
+	auto seed = hash<int>()(key.nTimeSteps);
+	auto combine = [&seed](const size_t& value) { seed ^= value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2); };
+	combine(hash<double>()(key.timeToExpiry));
+	combine(hash<double>()(key.jumpTime));
+	combine(hash<int>()(key.nJumpDiffusionStates));
+	return seed;
+}
@@ -0,0 +1,71 @@
+#ifndef __TREETOPOLOGYCACHE_H__
+#define __TREETOPOLOGYCACHE_H__
+
+#include <iostream>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include "TreeTopology.h"
+
+namespace models
+{
+	// A size bounded, least recently used cache of the topologies of jump diffusion trees, which can be shared across models. Topologies are
+	// keyed by the number of time steps, the time to expiry, the jump time and the number of jump diffusion states, which determine the 
+	// structure of the tree. Hence, the trees constructed during a recalibration, in which only the volatilities change, share a single
+	// topology. The cached topologies are immutable, so a topology returned by the cache can be used by several trees at once.
+	class TreeTopologyCache
+	{
+	public:
+		TreeTopologyCache(const size_t& maxBytes);
+		TreeTopologyCache() = default;
+		~TreeTopologyCache() = default;
+
+		// Getters
+		const size_t& getMaxBytes() const { return m_maxBytes; }
+		const size_t getNBytes();
+		const int getNTopologies();
+		const int getNHits();
+		const int getNMisses();
+
+		// Setters
+		void setMaxBytes(const size_t& value); // evicts the least recently used topologies until the cache is within the new size
+
+		// Returns the topology of a jump diffusion tree from the cache, or constructs the topology and caches it if it is not present
+		const std::shared_ptr<const models::TreeTopology> getJumpDiffusionTreeTopology(const int& nTimeSteps, const double& timeToExpiry, 
+			const double& jumpTime, const int& nJumpDiffusionStates);
+		void clear();
+
+		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
+		TreeTopologyCache& operator = (TreeTopologyCache const&) = delete;
+		TreeTopologyCache(TreeTopologyCache const&) = delete;
+
+	private:
+		struct Key
+		{
+			int nTimeSteps;
+			double timeToExpiry;
+			double jumpTime;
+			int nJumpDiffusionStates;
+
+			bool operator == (Key const& other) const;
+		};
+		struct KeyHash
+		{
+			size_t operator () (Key const& key) const;
+		};
+		typedef std::list<std::pair<Key, std::shared_ptr<const models::TreeTopology>>> Entries;
+
+		size_t m_maxBytes = 256 * 1024 * 1024; // the maximum total size of the cached topologies
+		size_t m_nBytes = 0; // the total size of the cached topologies
+		int m_nHits = 0;
+		int m_nMisses = 0;
+		Entries m_entries; // the cached topologies, from the most to the least recently used
+		std::unordered_map<Key, Entries::iterator, KeyHash> m_index;
+		std::mutex m_mutex;
+
+		void evict(const size_t& maxBytes);
+	};
+}
+
+#endif // !__TREETOPOLOGYCACHE_H__
@@ -7,6 +7,15 @@ using namespace std;
 using namespace enumerations;
 using namespace std::chrono;
 
+namespace
+{
+	// The stages of a generation which draw random numbers, each of which has its own substream for every candidate
+	const int initialisationStage = 0;
+	const int mutationStage = 1;
+	const int crossoverStage = 2;
+	const int nStages = 3;
+}
+
 optimisers::DifferentialEvolution::DifferentialEvolution(const int & D, const double & F, const double & CR, 
 	const std::shared_ptr<std::vector<double>>& lowerBounds, const std::shared_ptr<std::vector<double>>& upperBounds, 
 	const std::function<double(const std::shared_ptr<std::vector<double>>&, const int&)>& functionToOptimise, 
@@ -14,7 +23,7 @@ optimisers::DifferentialEvolution::DifferentialEvolution(const int & D, const do
 {
 	setD(D);
 	setNAndImplementation(implementation, initialPopulationParameter);
-	setCR(CR);
+	setF(F);
 	setCR(CR);
 	setLowerBounds(lowerBounds);
 	setUpperBounds(upperBounds);
@@ -90,7 +99,14 @@ void optimisers::DifferentialEvolution::setSeed(int value)
 	{
 		m_seed = value;
 	}
-	std::mt19937 m_generator(m_seed); // initialise the Mersenne Twister generator to be used in the optimisation
+}
+
+//// The random numbers for each candidate in each stage of a generation are drawn from their own substream of the seed, so that any candidate
+//// can be generated independently of the others, and in any order
+utilities::Philox optimisers::DifferentialEvolution::candidateGenerator(const int& stage, const int& candidate) const
+{
+	auto substream = ((uint64_t)m_iteration * nStages + stage) * m_N + candidate;
+	return utilities::Philox((uint32_t)m_seed, substream);
 }
 
 // This function performs the Differential Evolution method. It is assumed that the minimum of the function provided for optimisation is 0
@@ -100,6 +116,7 @@ const std::shared_ptr<std::vector<double>> optimisers::DifferentialEvolution::so
 	solution.reserve(m_D);
 
 	// Construct the initial the target vectors
+	m_iteration = 0;
 	constructInitialTargetVectors();
 	auto minDiff = 10000.0;
 	auto currentIteration = 0;
@@ -125,6 +142,7 @@ const std::shared_ptr<std::vector<double>> optimisers::DifferentialEvolution::so
 		}
 
 		currentIteration++;
+		m_iteration++;
 		minDiff = *minSolutionIterator;
 
 	}
@@ -150,13 +168,14 @@ void optimisers::DifferentialEvolution::constructInitialTargetVectors()
 	switch (m_implementation)
 	{
 	case Implementation::One: // Sample from the state space using psuedo random randoms
-		for (int j = 0; j < m_D; j++)
+		for (int i = 0; i < m_N; i++)
 		{
-			// Construct uniform distribution for the current parameter
-			uniform_real_distribution<double> uniformDistribution(m_lowerBounds->at(j), m_upperBounds->at(j));
-			for (int i = 0; i < m_N; i++)
+			auto generator = candidateGenerator(initialisationStage, i);
+			for (int j = 0; j < m_D; j++)
 			{
-				auto simulatedValue = uniformDistribution(m_generator);
+				// Construct uniform distribution for the current parameter
+				uniform_real_distribution<double> uniformDistribution(m_lowerBounds->at(j), m_upperBounds->at(j));
+				auto simulatedValue = uniformDistribution(generator);
 				targetVectors.at(i).push_back(move(simulatedValue));
 			}
 		}
@@ -220,9 +239,10 @@ void optimisers::DifferentialEvolution::constructDonorVectors()
 		uniform_int_distribution<int> uniformIntegerDistribution3(3, m_N - 1);
 
 		// Generate samples
-		auto randomIndex1 = uniformIntegerDistribution1(m_generator);
-		auto randomIndex2 = uniformIntegerDistribution2(m_generator);
-		auto randomIndex3 = uniformIntegerDistribution3(m_generator);
+		auto generator = candidateGenerator(mutationStage, i);
+		auto randomIndex1 = uniformIntegerDistribution1(generator);
+		auto randomIndex2 = uniformIntegerDistribution2(generator);
+		auto randomIndex3 = uniformIntegerDistribution3(generator);
 
 		// Start the swaping
 		swap(initialIndex[0], initialIndex[i]);
@@ -261,15 +281,16 @@ void optimisers::DifferentialEvolution::constructTrialVectors()
 	for (int i = 0; i < m_N; i++)
 	{
 		// Randomly simulate the index of one of the parameters
+		auto generator = candidateGenerator(crossoverStage, i);
 		uniform_int_distribution<int> uniformIntegerDistribution(0, m_D - 1);
-		auto randomIndex = uniformIntegerDistribution(m_generator);
+		auto randomIndex = uniformIntegerDistribution(generator);
 
 		// Recombine the target and donor vectors
 		for (int j = 0; j < m_D; j++)
 		{
 			// Simulate standard uniform for comparision to CR
 			uniform_real_distribution<double> uniformRealDistribution(0, 1);
-			auto randomCriterion = uniformRealDistribution(m_generator);
+			auto randomCriterion = uniformRealDistribution(generator);
 
 			auto tempValue = (randomCriterion <= m_CR || j == randomIndex) ? m_donorVectors.at(i).at(j) : m_targetVectors.at(i).at(j);
 			trialVectors.at(i).push_back(tempValue);
@@ -7,6 +7,7 @@
 #include <random>
 #include <functional>
 #include "../Enumerations/Implementation.h"
+#include "../Utilities/Philox.h"
 
 namespace optimisers 
 {
@@ -34,10 +35,10 @@ namespace optimisers
 		double m_CR;
 		std::shared_ptr<std::vector<double>> m_lowerBounds;
 		std::shared_ptr<std::vector<double>> m_upperBounds;
-		std::mt19937 m_generator;
 		std::function<double(const std::shared_ptr<std::vector<double>>&, const int&)> m_functionToOptimise;
 		std::vector<double> m_functionValues;
 		int m_seed;
+		int m_iteration; // the index of the current generation of target vectors
 		enumerations::Implementation m_implementation;
 
 		// Setters
@@ -57,6 +58,7 @@ namespace optimisers
 		std::vector<std::vector<double>> m_trialVectors;
 
 		// Functions for vector construction
+		utilities::Philox candidateGenerator(const int& stage, const int& candidate) const;
 		void constructInitialTargetVectors();
 		void constructDonorVectors();
 		void constructTrialVectors();
@@ -38,7 +38,36 @@ const std::shared_ptr<double> pricers::AnalyticPricer::price(const std::shared_p
 		vanillaOption->getStrike(),
 		vanillaOption->getTimeToExpiry(),
 		vanillaOption->getOptionRight(),
-		vanillaOption->getExerciseType());
+		vanillaOption->getExerciseType(),
+		m_normalDistributionImplementation);
 	return pricePtr;
 }
 
+
+
+// Returns the prices and Greeks of the vanilla options
+const std::vector<models::Greeks> pricers::AnalyticPricer::priceWithGreeks(
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions)
+{
+	vector<models::Greeks> greeks;
+	greeks.reserve(vanillaOptions->size());
+	for (auto& vanillaOption : *vanillaOptions)
+		greeks.push_back(priceWithGreeks(vanillaOption));
+	return greeks;
+}
+
+
+//// Calculate the analytic price and Greeks for a single vanilla option
+const models::Greeks pricers::AnalyticPricer::priceWithGreeks(const std::shared_ptr<instruments::VanillaOption>& vanillaOption)
+{
+	// Input validation. Check that the model and vanilla option have the same underlying
+	if (m_model->getUnderlyingCode() != vanillaOption->getUnderlyingCode())
+		throw invalid_argument("The vanilla option doesn not have the same undelrying as the pricing model.");
+
+	return m_model->calculateAnalyticGreeks(
+		vanillaOption->getStrike(),
+		vanillaOption->getTimeToExpiry(),
+		vanillaOption->getOptionRight(),
+		vanillaOption->getExerciseType(),
+		m_normalDistributionImplementation);
+}
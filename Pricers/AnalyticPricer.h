@@ -6,6 +6,7 @@
 #include <vector>
 #include "../Models/AnalyticModelUtilities/IAnalyticModel.h"
 #include "../Instruments/VanillaOption.h"
+#include "../Enumerations/NormalDistributionImplementation.h"
 
 namespace pricers
 {
@@ -19,9 +20,17 @@ namespace pricers
 
 		// Getters
 		const std::shared_ptr<models::IAnalyticModel> getModel() const { return m_model; }
+		const enumerations::NormalDistributionImplementation& getNormalDistributionImplementation() const 
+		{ 
+			return m_normalDistributionImplementation; 
+		}
 
 		// Setters
 		void setModel(const std::shared_ptr<models::IAnalyticModel>& value) { m_model = value; }
+		void setNormalDistributionImplementation(const enumerations::NormalDistributionImplementation& value) 
+		{ 
+			m_normalDistributionImplementation = value; 
+		}
 
 		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
 		AnalyticPricer& operator = (AnalyticPricer const&) = delete;
@@ -31,9 +40,13 @@ namespace pricers
 		const std::shared_ptr<std::vector<std::shared_ptr<double>>> price( 
 			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions);
 		const std::shared_ptr<double> price(const std::shared_ptr<instruments::VanillaOption>& vanillaOption);
+		const std::vector<models::Greeks> priceWithGreeks(
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions);
+		const models::Greeks priceWithGreeks(const std::shared_ptr<instruments::VanillaOption>& vanillaOption);
 
 	private:
 		std::shared_ptr<models::IAnalyticModel> m_model;
+		enumerations::NormalDistributionImplementation m_normalDistributionImplementation = enumerations::NormalDistributionImplementation::boost;
 	};
 }
 
@@ -0,0 +1,340 @@
+#include <cmath>
+#include <stdexcept>
+#include "BackwardInductionKernel.h"
+
+// The vectorised kernels are built for x86-64 with both GCC (on Linux) and MSVC. GCC only emits AVX2 and AVX-512 instructions in functions
+// that are marked with their target, whereas MSVC emits them for the intrinsics without any marking. In both cases the rest of the code is 
+// built for the baseline instruction set, and the kernel is only selected if the CPU supports it.
+#if defined(__linux__) && defined(__x86_64__)
+#define BACKWARDINDUCTIONKERNEL_X86_64
+#define BACKWARDINDUCTIONKERNEL_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#include <immintrin.h>
+#include <cpuid.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define BACKWARDINDUCTIONKERNEL_X86_64
+#define BACKWARDINDUCTIONKERNEL_TARGET(instructionSet)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+// The multiplications and additions must not be contracted into fused multiply-adds, otherwise the scalar tails would differ from the
+// vectorised blocks
+#if defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract (off)
+#endif
+
+using namespace std;
+using namespace enumerations;
+
+namespace
+{
+	typedef void(*StepOverNodesFunction)(double*, const double*, const double*, const int, const double, const double, const double, 
+		const double, const double, const double);
+	typedef void(*StepOverOptionsFunction)(double*, const double*, const double*, const double, const int, const double, const double, 
+		const double, const double*, const double*, const double*);
+
+
+	//// Scalar implementation
+	// ============================================================================ 
+
+	void stepOverNodesScalar(double* currentValues, const double* futureValues, const double* underlyingPrices, const int nNodes,
+		const double upProbability, const double downProbability, const double discountFactor, const double strike, 
+		const double exerciseSign, const double americanMask)
+	{
+		if (americanMask > 0.5)
+		{
+			for (int j = 0; j < nNodes; j++)
+			{
+				auto value = (upProbability * futureValues[j] + downProbability * futureValues[j + 1]) * discountFactor;
+				auto intrinsicValue = exerciseSign * (underlyingPrices[j] - strike);
+				intrinsicValue = intrinsicValue > 0.0 ? intrinsicValue : 0.0;
+				currentValues[j] = value > intrinsicValue ? value : intrinsicValue;
+			}
+		}
+		else
+		{
+			for (int j = 0; j < nNodes; j++)
+				currentValues[j] = (upProbability * futureValues[j] + downProbability * futureValues[j + 1]) * discountFactor;
+		}
+	}
+
+	void stepOverOptionsScalar(double* currentValues, const double* upValues, const double* downValues, const double underlyingPrice,
+		const int nOptions, const double upProbability, const double downProbability, const double discountFactor, const double* strikes,
+		const double* exerciseSigns, const double* americanMasks)
+	{
+		for (int o = 0; o < nOptions; o++)
+		{
+			auto value = (upProbability * upValues[o] + downProbability * downValues[o]) * discountFactor;
+			auto intrinsicValue = exerciseSigns[o] * (underlyingPrice - strikes[o]);
+			intrinsicValue = americanMasks[o] * (intrinsicValue > 0.0 ? intrinsicValue : 0.0);
+			currentValues[o] = value > intrinsicValue ? value : intrinsicValue;
+		}
+	}
+
+
+#ifdef BACKWARDINDUCTIONKERNEL_X86_64
+	//// AVX2 implementation
+	// ============================================================================ 
+
+	// Each block of values is loaded before it is stored, and the blocks are processed in ascending order, so updating in place is safe.
+	BACKWARDINDUCTIONKERNEL_TARGET("avx2")
+	void stepOverNodesAvx2(double* currentValues, const double* futureValues, const double* underlyingPrices, const int nNodes,
+		const double upProbability, const double downProbability, const double discountFactor, const double strike, 
+		const double exerciseSign, const double americanMask)
+	{
+		auto up = _mm256_set1_pd(upProbability);
+		auto down = _mm256_set1_pd(downProbability);
+		auto discount = _mm256_set1_pd(discountFactor);
+		auto k = _mm256_set1_pd(strike);
+		auto sign = _mm256_set1_pd(exerciseSign);
+		auto zero = _mm256_setzero_pd();
+		auto isAmerican = americanMask > 0.5;
+		int j = 0;
+		for (; j + 4 <= nNodes; j += 4)
+		{
+			auto value = _mm256_add_pd(_mm256_mul_pd(up, _mm256_loadu_pd(futureValues + j)), 
+				_mm256_mul_pd(down, _mm256_loadu_pd(futureValues + j + 1)));
+			value = _mm256_mul_pd(value, discount);
+			if (isAmerican)
+			{
+				auto intrinsicValue = _mm256_mul_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(underlyingPrices + j), k));
+				intrinsicValue = _mm256_max_pd(intrinsicValue, zero);
+				value = _mm256_max_pd(value, intrinsicValue);
+			}
+			_mm256_storeu_pd(currentValues + j, value);
+		}
+		stepOverNodesScalar(currentValues + j, futureValues + j, underlyingPrices == nullptr ? nullptr : underlyingPrices + j, nNodes - j, 
+			upProbability, downProbability, discountFactor, strike, exerciseSign, americanMask);
+	}
+
+	BACKWARDINDUCTIONKERNEL_TARGET("avx2")
+	void stepOverOptionsAvx2(double* currentValues, const double* upValues, const double* downValues, const double underlyingPrice,
+		const int nOptions, const double upProbability, const double downProbability, const double discountFactor, const double* strikes,
+		const double* exerciseSigns, const double* americanMasks)
+	{
+		auto up = _mm256_set1_pd(upProbability);
+		auto down = _mm256_set1_pd(downProbability);
+		auto discount = _mm256_set1_pd(discountFactor);
+		auto s = _mm256_set1_pd(underlyingPrice);
+		auto zero = _mm256_setzero_pd();
+		int o = 0;
+		for (; o + 4 <= nOptions; o += 4)
+		{
+			auto value = _mm256_add_pd(_mm256_mul_pd(up, _mm256_loadu_pd(upValues + o)), _mm256_mul_pd(down, _mm256_loadu_pd(downValues + o)));
+			value = _mm256_mul_pd(value, discount);
+			auto intrinsicValue = _mm256_mul_pd(_mm256_loadu_pd(exerciseSigns + o), _mm256_sub_pd(s, _mm256_loadu_pd(strikes + o)));
+			intrinsicValue = _mm256_mul_pd(_mm256_loadu_pd(americanMasks + o), _mm256_max_pd(intrinsicValue, zero));
+			_mm256_storeu_pd(currentValues + o, _mm256_max_pd(value, intrinsicValue));
+		}
+		stepOverOptionsScalar(currentValues + o, upValues + o, downValues + o, underlyingPrice, nOptions - o, upProbability, downProbability,
+			discountFactor, strikes + o, exerciseSigns + o, americanMasks + o);
+	}
+
+
+	//// AVX-512 implementation
+	// ============================================================================ 
+
+	BACKWARDINDUCTIONKERNEL_TARGET("avx512f")
+	void stepOverNodesAvx512(double* currentValues, const double* futureValues, const double* underlyingPrices, const int nNodes,
+		const double upProbability, const double downProbability, const double discountFactor, const double strike, 
+		const double exerciseSign, const double americanMask)
+	{
+		auto up = _mm512_set1_pd(upProbability);
+		auto down = _mm512_set1_pd(downProbability);
+		auto discount = _mm512_set1_pd(discountFactor);
+		auto k = _mm512_set1_pd(strike);
+		auto sign = _mm512_set1_pd(exerciseSign);
+		auto zero = _mm512_setzero_pd();
+		auto isAmerican = americanMask > 0.5;
+		int j = 0;
+		for (; j + 8 <= nNodes; j += 8)
+		{
+			auto value = _mm512_add_pd(_mm512_mul_pd(up, _mm512_loadu_pd(futureValues + j)), 
+				_mm512_mul_pd(down, _mm512_loadu_pd(futureValues + j + 1)));
+			value = _mm512_mul_pd(value, discount);
+			if (isAmerican)
+			{
+				auto intrinsicValue = _mm512_mul_pd(sign, _mm512_sub_pd(_mm512_loadu_pd(underlyingPrices + j), k));
+				intrinsicValue = _mm512_max_pd(intrinsicValue, zero);
+				value = _mm512_max_pd(value, intrinsicValue);
+			}
+			_mm512_storeu_pd(currentValues + j, value);
+		}
+		stepOverNodesScalar(currentValues + j, futureValues + j, underlyingPrices == nullptr ? nullptr : underlyingPrices + j, nNodes - j, 
+			upProbability, downProbability, discountFactor, strike, exerciseSign, americanMask);
+	}
+
+	BACKWARDINDUCTIONKERNEL_TARGET("avx512f")
+	void stepOverOptionsAvx512(double* currentValues, const double* upValues, const double* downValues, const double underlyingPrice,
+		const int nOptions, const double upProbability, const double downProbability, const double discountFactor, const double* strikes,
+		const double* exerciseSigns, const double* americanMasks)
+	{
+		auto up = _mm512_set1_pd(upProbability);
+		auto down = _mm512_set1_pd(downProbability);
+		auto discount = _mm512_set1_pd(discountFactor);
+		auto s = _mm512_set1_pd(underlyingPrice);
+		auto zero = _mm512_setzero_pd();
+		int o = 0;
+		for (; o + 8 <= nOptions; o += 8)
+		{
+			auto value = _mm512_add_pd(_mm512_mul_pd(up, _mm512_loadu_pd(upValues + o)), _mm512_mul_pd(down, _mm512_loadu_pd(downValues + o)));
+			value = _mm512_mul_pd(value, discount);
+			auto intrinsicValue = _mm512_mul_pd(_mm512_loadu_pd(exerciseSigns + o), _mm512_sub_pd(s, _mm512_loadu_pd(strikes + o)));
+			intrinsicValue = _mm512_mul_pd(_mm512_loadu_pd(americanMasks + o), _mm512_max_pd(intrinsicValue, zero));
+			_mm512_storeu_pd(currentValues + o, _mm512_max_pd(value, intrinsicValue));
+		}
+		stepOverOptionsScalar(currentValues + o, upValues + o, downValues + o, underlyingPrice, nOptions - o, upProbability, downProbability,
+			discountFactor, strikes + o, exerciseSigns + o, americanMasks + o);
+	}
+#endif
+
+
+	//// Run time dispatch
+	// ============================================================================ 
+
+	struct KernelSelection
+	{
+		StepOverNodesFunction stepOverNodes;
+		StepOverOptionsFunction stepOverOptions;
+		KernelImplementation implementation;
+		const char* name;
+	};
+
+#ifdef BACKWARDINDUCTIONKERNEL_X86_64
+	//// The registers eax, ebx, ecx and edx returned by the cpuid instruction for the leaf and subleaf
+	void cpuid(unsigned int (&registers)[4], const unsigned int leaf, const unsigned int subleaf)
+	{
+#ifdef _MSC_VER
+		int values[4];
+		__cpuidex(values, (int)leaf, (int)subleaf);
+		for (int r = 0; r < 4; r++)
+			registers[r] = (unsigned int)values[r];
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+	}
+
+	//// The register XCR0, which flags the registers whose state is saved by the operating system on a context switch
+	unsigned long long xcr0()
+	{
+#ifdef _MSC_VER
+		return _xgetbv(0);
+#else
+		unsigned int eax, edx;
+		__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((unsigned long long)edx << 32) | eax;
+#endif
+	}
+
+	//// An instruction set can only be used if the CPU supports it and the operating system saves its registers, i.e. the ymm registers for
+	//// AVX2, and in addition the zmm registers and the opmask registers for AVX-512
+	bool isCpuSupported(const KernelImplementation& implementation)
+	{
+		unsigned int registers[4];
+		cpuid(registers, 0, 0);
+		auto maxLeaf = registers[0];
+		cpuid(registers, 1, 0);
+		auto isOsxsaveSupported = (registers[2] & (1u << 27)) != 0;
+		auto isAvxSupported = (registers[2] & (1u << 28)) != 0;
+		if (maxLeaf < 7 || !isOsxsaveSupported || !isAvxSupported)
+			return false;
+		cpuid(registers, 7, 0);
+		auto savedRegisters = xcr0();
+		if (implementation == KernelImplementation::avx2)
+			return (registers[1] & (1u << 5)) != 0 && (savedRegisters & 0x6) == 0x6;
+		if (implementation == KernelImplementation::avx512)
+			return (registers[1] & (1u << 16)) != 0 && (savedRegisters & 0xe6) == 0xe6;
+		return false;
+	}
+#endif
+
+	bool isKernelSupported(const KernelImplementation& implementation)
+	{
+		if (implementation == KernelImplementation::scalar)
+			return true;
+#ifdef BACKWARDINDUCTIONKERNEL_X86_64
+		return isCpuSupported(implementation);
+#else
+		return false;
+#endif
+	}
+
+	KernelSelection getKernel(const KernelImplementation& implementation)
+	{
+		if (!isKernelSupported(implementation))
+			throw invalid_argument("The kernel implementation is not supported by this CPU.");
+#ifdef BACKWARDINDUCTIONKERNEL_X86_64
+		if (implementation == KernelImplementation::avx512)
+			return { stepOverNodesAvx512, stepOverOptionsAvx512, implementation, "avx512" };
+		if (implementation == KernelImplementation::avx2)
+			return { stepOverNodesAvx2, stepOverOptionsAvx2, implementation, "avx2" };
+#endif
+		return { stepOverNodesScalar, stepOverOptionsScalar, KernelImplementation::scalar, "scalar" };
+	}
+
+	KernelSelection selectKernel()
+	{
+		for (auto implementation : { KernelImplementation::avx512, KernelImplementation::avx2 })
+		{
+			if (isKernelSupported(implementation))
+				return getKernel(implementation);
+		}
+		return getKernel(KernelImplementation::scalar);
+	}
+
+	const KernelSelection& getKernel()
+	{
+		static const KernelSelection kernel = selectKernel(); // selected once, on first use
+		return kernel;
+	}
+}
+
+
+void pricers::BackwardInductionKernel::stepOverNodes(double* currentValues, const double* futureValues, const double* underlyingPrices, 
+	const int nNodes, const double upProbability, const double downProbability, const double discountFactor, const double strike, 
+	const double exerciseSign, const double americanMask)
+{
+	getKernel().stepOverNodes(currentValues, futureValues, underlyingPrices, nNodes, upProbability, downProbability, discountFactor, strike,
+		exerciseSign, americanMask);
+}
+
+void pricers::BackwardInductionKernel::stepOverOptions(double* currentValues, const double* upValues, const double* downValues, 
+	const double underlyingPrice, const int nOptions, const double upProbability, const double downProbability, const double discountFactor,
+	const double* strikes, const double* exerciseSigns, const double* americanMasks)
+{
+	getKernel().stepOverOptions(currentValues, upValues, downValues, underlyingPrice, nOptions, upProbability, downProbability, 
+		discountFactor, strikes, exerciseSigns, americanMasks);
+}
+
+void pricers::BackwardInductionKernel::stepOverNodes(const enumerations::KernelImplementation& implementation, double* currentValues, 
+	const double* futureValues, const double* underlyingPrices, const int nNodes, const double upProbability, const double downProbability, 
+	const double discountFactor, const double strike, const double exerciseSign, const double americanMask)
+{
+	getKernel(implementation).stepOverNodes(currentValues, futureValues, underlyingPrices, nNodes, upProbability, downProbability, 
+		discountFactor, strike, exerciseSign, americanMask);
+}
+
+void pricers::BackwardInductionKernel::stepOverOptions(const enumerations::KernelImplementation& implementation, double* currentValues, 
+	const double* upValues, const double* downValues, const double underlyingPrice, const int nOptions, const double upProbability, 
+	const double downProbability, const double discountFactor, const double* strikes, const double* exerciseSigns, const double* americanMasks)
+{
+	getKernel(implementation).stepOverOptions(currentValues, upValues, downValues, underlyingPrice, nOptions, upProbability, downProbability,
+		discountFactor, strikes, exerciseSigns, americanMasks);
+}
+
+bool pricers::BackwardInductionKernel::isSupported(const enumerations::KernelImplementation& implementation)
+{
+	return isKernelSupported(implementation);
+}
+
+const enumerations::KernelImplementation& pricers::BackwardInductionKernel::getImplementation()
+{
+	return getKernel().implementation;
+}
+
+const char* pricers::BackwardInductionKernel::getImplementationName()
+{
+	return getKernel().name;
+}
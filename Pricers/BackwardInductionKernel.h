@@ -0,0 +1,53 @@
+#ifndef __BACKWARDINDUCTIONKERNEL_H__
+#define __BACKWARDINDUCTIONKERNEL_H__
+
+#include "../Enumerations/KernelImplementation.h"
+
+namespace pricers
+{
+	//// Kernels for a single step of backward induction on the regular binomial levels of a tree, i.e. levels where node j branches to nodes
+	//// j and j + 1 at the next time with the same up and down probabilities. Each kernel fuses the expectation, the discounting and the 
+	//// early exercise condition:
+	////     value = max(discountFactor * (upProbability * upValue + downProbability * downValue), americanMask * max(0, sign * (S - K)))
+	//// where the american mask is 1 for American options and 0 for European options.
+	//// On x86-64, built with either MSVC or GCC on Linux, an AVX-512 or AVX2 implementation is selected at run time based on the capabilities
+	//// of the CPU and the operating system, and a scalar implementation is used otherwise. The multiplications and additions are never fused, so that all implementations return exactly the 
+	//// same values.
+	class BackwardInductionKernel
+	{
+	public:
+		// Vectorised over the nodes of a level, for a single option. currentValues[j] depends on futureValues[j] and futureValues[j + 1], so
+		// the values may be updated in place (i.e. currentValues == futureValues). underlyingPrices is only read for American options.
+		static void stepOverNodes(double* currentValues, const double* futureValues, const double* underlyingPrices, const int nNodes,
+			const double upProbability, const double downProbability, const double discountFactor, const double strike, 
+			const double exerciseSign, const double americanMask);
+
+		// Vectorised over a set of options, for a single node. The option values of the up and down nodes at the next time are held in
+		// upValues and downValues. The values may be updated in place (i.e. currentValues == upValues).
+		static void stepOverOptions(double* currentValues, const double* upValues, const double* downValues, const double underlyingPrice,
+			const int nOptions, const double upProbability, const double downProbability, const double discountFactor, const double* strikes,
+			const double* exerciseSigns, const double* americanMasks);
+
+		// As above, with the given implementation rather than the selected one, e.g. to compare the implementations. Throws if the 
+		// implementation is not supported by the CPU.
+		static void stepOverNodes(const enumerations::KernelImplementation& implementation, double* currentValues, const double* futureValues,
+			const double* underlyingPrices, const int nNodes, const double upProbability, const double downProbability, 
+			const double discountFactor, const double strike, const double exerciseSign, const double americanMask);
+		static void stepOverOptions(const enumerations::KernelImplementation& implementation, double* currentValues, const double* upValues,
+			const double* downValues, const double underlyingPrice, const int nOptions, const double upProbability, 
+			const double downProbability, const double discountFactor, const double* strikes, const double* exerciseSigns, 
+			const double* americanMasks);
+
+		// Whether the implementation can be run on this CPU
+		static bool isSupported(const enumerations::KernelImplementation& implementation);
+
+		// The selected implementation, which is the widest supported one, and its name, i.e. "avx512", "avx2" or "scalar"
+		static const enumerations::KernelImplementation& getImplementation();
+		static const char* getImplementationName();
+
+	private:
+		BackwardInductionKernel() {};
+	};
+}
+
+#endif // !__BACKWARDINDUCTIONKERNEL_H__
@@ -0,0 +1,163 @@
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <boost/math/distributions/normal.hpp>
+#include "BlackScholesBatchPricer.h"
+#include "../Utilities/NormalDistribution.h"
+
+using namespace std;
+using namespace enumerations;
+
+namespace
+{
+	const int blockSize = 256; // the number of quotes priced together, chosen so that the intermediate arrays of a block stay in cache
+
+	void validateQuotes(const int nOptions, const double* underlyingPrices, const double* strikes, const double* timesToExpiry, 
+		const double* impliedVolatilities)
+	{
+		if (nOptions < 0)
+			throw invalid_argument("The number of options must not be negative.");
+		auto isValid = true;
+		for (int i = 0; i < nOptions; i++)
+			isValid = isValid & (impliedVolatilities[i] >= 0.00000001) & (timesToExpiry[i] > 0.0) & (underlyingPrices[i] > -0.00000001) 
+				& (strikes[i] > 0.0);
+		if (!isValid)
+			throw invalid_argument("The implied volatilities, times to expiry and strikes must be positive, and the underlying prices must not be negative.");
+	}
+}
+
+//// Black Scholes prices of a batch of European options. This is the same calculation as models::BlackScholes::calculateAnalyticSolution,
+//// with each stage calculated for a block of quotes at a time:
+////     d1 = (log(S / K) + T (r - q + sigma^2 / 2)) / (sigma sqrt(T)), d2 = d1 - sigma sqrt(T)
+////     price = sign exp(-r T) (S exp((r - q) T) N(sign d1) - K N(sign d2))
+//// where the sign is 1 for calls and -1 for puts.
+void pricers::BlackScholesBatchPricer::price(const int nOptions, const double* underlyingPrices, const double* strikes, 
+	const double* timesToExpiry, const double* discountRates, const double* costsOfCarry, const double* impliedVolatilities,
+	const enumerations::OptionRight* optionRights, double* prices, 
+	const enumerations::NormalDistributionImplementation normalDistributionImplementation)
+{
+	// Input validation
+	validateQuotes(nOptions, underlyingPrices, strikes, timesToExpiry, impliedVolatilities);
+
+	boost::math::normal z; // normal variate with mean 0 and variance 1
+	auto isFast = normalDistributionImplementation == NormalDistributionImplementation::fast;
+	double signs[blockSize], discountFactors[blockSize], forwardPrices[blockSize], cdfD1[blockSize], cdfD2[blockSize];
+	for (int first = 0; first < nOptions; first += blockSize)
+	{
+		auto n = min(blockSize, nOptions - first);
+		auto S = &underlyingPrices[first];
+		auto K = &strikes[first];
+		auto T = &timesToExpiry[first];
+		auto r = &discountRates[first];
+		auto q = &costsOfCarry[first];
+		auto sigma = &impliedVolatilities[first];
+
+		// The arguments of the normal distribution, and the discounting and forward terms
+		for (int j = 0; j < n; j++)
+		{
+			signs[j] = optionRights[first + j] == OptionRight::call ? 1.0 : -1.0;
+			auto standardDeviation = sigma[j] * sqrt(T[j]);
+			auto d1 = (log(S[j] / K[j]) + T[j] * (r[j] - q[j] + sigma[j] * sigma[j] / 2.0)) / standardDeviation;
+			auto d2 = d1 - standardDeviation;
+			cdfD1[j] = signs[j] * d1;
+			cdfD2[j] = signs[j] * d2;
+			discountFactors[j] = exp(-1. * r[j] * T[j]);
+			forwardPrices[j] = S[j] * exp((r[j] - q[j]) * T[j]);
+		}
+
+		// The normal distribution, evaluated in place
+		if (isFast)
+		{
+			utilities::NormalDistribution::cdf(cdfD1, n, cdfD1);
+			utilities::NormalDistribution::cdf(cdfD2, n, cdfD2);
+		}
+		else
+		{
+			for (int j = 0; j < n; j++)
+			{
+				cdfD1[j] = boost::math::cdf(z, cdfD1[j]);
+				cdfD2[j] = boost::math::cdf(z, cdfD2[j]);
+			}
+		}
+
+		// Prices
+		for (int j = 0; j < n; j++)
+			prices[first + j] = signs[j] * discountFactors[j] * (forwardPrices[j] * cdfD1[j] - K[j] * cdfD2[j]);
+	}
+}
+
+
+//// Black Scholes prices and Greeks of a batch of European options, calculated in blocks in the same way as the prices. The Greeks share d1 
+//// and d2, the discount and carry factors, and the normal distribution values with the price, as in 
+//// models::BlackScholes::calculateAnalyticGreeks.
+void pricers::BlackScholesBatchPricer::priceWithGreeks(const int nOptions, const double* underlyingPrices, const double* strikes, 
+	const double* timesToExpiry, const double* discountRates, const double* costsOfCarry, const double* impliedVolatilities,
+	const enumerations::OptionRight* optionRights, models::Greeks* greeks, 
+	const enumerations::NormalDistributionImplementation normalDistributionImplementation)
+{
+	// Input validation
+	validateQuotes(nOptions, underlyingPrices, strikes, timesToExpiry, impliedVolatilities);
+
+	boost::math::normal z; // normal variate with mean 0 and variance 1
+	auto isFast = normalDistributionImplementation == NormalDistributionImplementation::fast;
+	double signs[blockSize], sqrtTimesToExpiry[blockSize], discountFactors[blockSize], carryFactors[blockSize];
+	double cdfD1[blockSize], cdfD2[blockSize], pdfD1[blockSize];
+	for (int first = 0; first < nOptions; first += blockSize)
+	{
+		auto n = min(blockSize, nOptions - first);
+		auto S = &underlyingPrices[first];
+		auto K = &strikes[first];
+		auto T = &timesToExpiry[first];
+		auto r = &discountRates[first];
+		auto q = &costsOfCarry[first];
+		auto sigma = &impliedVolatilities[first];
+
+		// The arguments of the normal distribution, and the discounting and carry terms
+		for (int j = 0; j < n; j++)
+		{
+			signs[j] = optionRights[first + j] == OptionRight::call ? 1.0 : -1.0;
+			sqrtTimesToExpiry[j] = sqrt(T[j]);
+			auto standardDeviation = sigma[j] * sqrtTimesToExpiry[j];
+			auto d1 = (log(S[j] / K[j]) + T[j] * (r[j] - q[j] + sigma[j] * sigma[j] / 2.0)) / standardDeviation;
+			auto d2 = d1 - standardDeviation;
+			cdfD1[j] = signs[j] * d1;
+			cdfD2[j] = signs[j] * d2;
+			pdfD1[j] = d1;
+			discountFactors[j] = exp(-1. * r[j] * T[j]);
+			carryFactors[j] = exp((r[j] - q[j]) * T[j]);
+		}
+
+		// The normal distribution, evaluated in place
+		if (isFast)
+		{
+			utilities::NormalDistribution::cdf(cdfD1, n, cdfD1);
+			utilities::NormalDistribution::cdf(cdfD2, n, cdfD2);
+			utilities::NormalDistribution::pdf(pdfD1, n, pdfD1);
+		}
+		else
+		{
+			for (int j = 0; j < n; j++)
+			{
+				cdfD1[j] = boost::math::cdf(z, cdfD1[j]);
+				cdfD2[j] = boost::math::cdf(z, cdfD2[j]);
+				pdfD1[j] = boost::math::pdf(z, pdfD1[j]);
+			}
+		}
+
+		// Prices and Greeks
+		for (int j = 0; j < n; j++)
+		{
+			auto forwardPrice = S[j] * carryFactors[j];
+			auto discountedForwardPrice = discountFactors[j] * forwardPrice;
+			auto discountedStrike = discountFactors[j] * K[j];
+			auto& greek = greeks[first + j];
+			greek.price = signs[j] * discountFactors[j] * (forwardPrice * cdfD1[j] - K[j] * cdfD2[j]);
+			greek.delta = signs[j] * discountFactors[j] * carryFactors[j] * cdfD1[j];
+			greek.gamma = discountFactors[j] * carryFactors[j] * pdfD1[j] / (S[j] * sigma[j] * sqrtTimesToExpiry[j]);
+			greek.vega = discountedForwardPrice * pdfD1[j] * sqrtTimesToExpiry[j];
+			greek.theta = -discountedForwardPrice * pdfD1[j] * sigma[j] / (2.0 * sqrtTimesToExpiry[j])
+				- signs[j] * r[j] * discountedStrike * cdfD2[j] + signs[j] * q[j] * discountedForwardPrice * cdfD1[j];
+			greek.rho = signs[j] * discountedStrike * T[j] * cdfD2[j];
+		}
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef __BLACKSCHOLESBATCHPRICER_H__
+#define __BLACKSCHOLESBATCHPRICER_H__
+
+#include "../Enumerations/OptionRight.h"
+#include "../Enumerations/NormalDistributionImplementation.h"
+#include "../Models/AnalyticModelUtilities/Greeks.h"
+
+namespace pricers
+{
+	//// Black Scholes prices of batches of European options, for repricing large sets of quotes, e.g. when recalculating reference surfaces.
+	//// Each quote has its own market data, and the inputs are held as structure of arrays, i.e. the i-th quote has the underlying price 
+	//// underlyingPrices[i], the strike strikes[i], and so on. The prices are written to a buffer provided by the caller.
+	//// The quotes are priced in blocks. The loops over each block have no branches, and the normal distribution is evaluated over arrays, so
+	//// that they can be vectorised by the compiler. With the boost normal distribution, the prices are exactly those of the analytic solution
+	//// of models::BlackScholes.
+	class BlackScholesBatchPricer
+	{
+	public:
+		// The cost of carry q is the continuous yield of the underlying, so that the forward price is S exp((r - q) T)
+		static void price(const int nOptions, const double* underlyingPrices, const double* strikes, const double* timesToExpiry, 
+			const double* discountRates, const double* costsOfCarry, const double* impliedVolatilities, 
+			const enumerations::OptionRight* optionRights, double* prices, 
+			const enumerations::NormalDistributionImplementation normalDistributionImplementation = 
+			enumerations::NormalDistributionImplementation::fast);
+
+		// The prices and Greeks, from the same evaluation, which are exactly those of models::BlackScholes::calculateAnalyticGreeks with the
+		// boost normal distribution
+		static void priceWithGreeks(const int nOptions, const double* underlyingPrices, const double* strikes, const double* timesToExpiry, 
+			const double* discountRates, const double* costsOfCarry, const double* impliedVolatilities, 
+			const enumerations::OptionRight* optionRights, models::Greeks* greeks, 
+			const enumerations::NormalDistributionImplementation normalDistributionImplementation = 
+			enumerations::NormalDistributionImplementation::fast);
+
+	private:
+		BlackScholesBatchPricer() {};
+	};
+}
+
+#endif // !__BLACKSCHOLESBATCHPRICER_H__
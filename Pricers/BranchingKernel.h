@@ -0,0 +1,82 @@
+#ifndef __BRANCHINGKERNEL_H__
+#define __BRANCHINGKERNEL_H__
+
+#include <cmath>
+
+namespace pricers
+{
+	// The expectation over nBranches consecutive future values, which are stride apart, unrolled at compile time. The branches are summed in
+	// order, i.e. ((p0 * f0 + p1 * f1) + p2 * f2) + ..., but the compiler may contract the unrolled sum into fused multiply adds differently
+	// from a loop over the branches, so the two agree only to rounding.
+	template <int nBranches>
+	struct BranchingExpectation
+	{
+		static double calculate(const double* futureValues, const int stride, const double* probabilities)
+		{
+			return BranchingExpectation<nBranches - 1>::calculate(futureValues, stride, probabilities)
+				+ probabilities[nBranches - 1] * futureValues[(nBranches - 1) * stride];
+		}
+	};
+
+	template <>
+	struct BranchingExpectation<1>
+	{
+		static double calculate(const double* futureValues, const int, const double* probabilities)
+		{
+			return probabilities[0] * futureValues[0];
+		}
+	};
+
+
+	// A step of backward induction over the nodes of a level of a tree in which every node has the same branching, with nBranches branches
+	// to consecutive nodes at the next time. Node j of the level branches out to the nodes starting from firstForwardIndex[j]. The option
+	// values are stored node-major, i.e. the value of option o at node j is held at j * nOptions + o. Specialising on the number of branches
+	// allows the expectation to be fully unrolled for the binomial diffusion steps (2), and for the jump steps of the single (10) and double
+	// (20) normal jump models.
+	template <int nBranches>
+	class BranchingKernel
+	{
+	public:
+		static void stepOverNodes(double* currentValues, const double* futureValues, const double* underlyingPrices,
+			const int* firstForwardIndex, const int nNodes, const int nOptions, const double* probabilities, const double discountFactor,
+			const double* strikes, const double* exerciseSigns, const double* americanMasks)
+		{
+			if (nOptions == 1)
+			{
+				for (int j = 0; j < nNodes; j++)
+				{
+					auto value = BranchingExpectation<nBranches>::calculate(&futureValues[firstForwardIndex[j]], 1, probabilities) 
+						* discountFactor;
+					currentValues[j] = fmax(value, americanMasks[0] * fmax(0.0, exerciseSigns[0] * (underlyingPrices[j] - strikes[0])));
+				}
+				return;
+			}
+
+			// The rows of option values of the forward nodes are accumulated in turn, so that the options are read contiguously
+			for (int j = 0; j < nNodes; j++)
+			{
+				auto currentRow = &currentValues[j * nOptions];
+				auto futureRow = &futureValues[firstForwardIndex[j] * nOptions];
+				for (int o = 0; o < nOptions; o++)
+					currentRow[o] = probabilities[0] * futureRow[o];
+				for (int k = 1; k < nBranches; k++)
+				{
+					futureRow += nOptions;
+					auto probability = probabilities[k];
+					for (int o = 0; o < nOptions; o++)
+						currentRow[o] += probability * futureRow[o];
+				}
+				for (int o = 0; o < nOptions; o++)
+				{
+					auto value = currentRow[o] * discountFactor;
+					currentRow[o] = fmax(value, americanMasks[o] * fmax(0.0, exerciseSigns[o] * (underlyingPrices[j] - strikes[o])));
+				}
+			}
+		}
+
+	private:
+		BranchingKernel() {};
+	};
+}
+
+#endif // !__BRANCHINGKERNEL_H__
@@ -0,0 +1,175 @@
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <boost/math/distributions/normal.hpp>
+#include "ImpliedVolatilitySolver.h"
+#include "../Utilities/NormalDistribution.h"
+
+using namespace std;
+using namespace enumerations;
+
+namespace
+{
+	const int blockSize = 256; // the number of quotes solved together, chosen so that the intermediate arrays of a block stay in cache
+	const double maxInitialStandardDeviation = 10.0;
+	const double minInitialStandardDeviation = 0.0001;
+
+	void validateQuotes(const int nOptions, const double* prices, const double* underlyingPrices, const double* strikes, 
+		const double* timesToExpiry)
+	{
+		if (nOptions < 0)
+			throw invalid_argument("The number of options must not be negative.");
+		auto isValid = true;
+		for (int i = 0; i < nOptions; i++)
+			isValid = isValid & (prices[i] >= 0.0) & (timesToExpiry[i] > 0.0) & (underlyingPrices[i] > 0.0) & (strikes[i] > 0.0);
+		if (!isValid)
+			throw invalid_argument("The underlying prices, strikes and times to expiry must be positive, and the prices must not be negative.");
+	}
+}
+
+//// Implied volatilities of a batch of European options. With the forward price F, the undiscounted time value c of the option, and the 
+//// total standard deviation s = sigma sqrt(T), the time value normalised by sqrt(F K) is the same for the call and the put, and is
+////     b(s) = theta (exp(x / 2) N(theta d1) - exp(-x / 2) N(theta d2)), x = log(F / K), d1 = x / s + s / 2, d2 = x / s - s / 2
+//// where theta is 1 if the call is out of the money, and -1 if the put is. b is increasing in s, with
+////     b'(s) = exp(x / 2) n(d1), b''(s) = b'(s) d1 d2 / s
+//// and the Halley steps solve log(b(s)) = log(beta) for the normalised time value beta of the quote.
+void pricers::ImpliedVolatilitySolver::solve(const int nOptions, const double* prices, const double* underlyingPrices, 
+	const double* strikes, const double* timesToExpiry, const double* discountRates, const double* costsOfCarry, 
+	const enumerations::OptionRight* optionRights, double* impliedVolatilities, enumerations::ImpliedVolatilityStatus* statuses,
+	const enumerations::NormalDistributionImplementation normalDistributionImplementation)
+{
+	// Input validation
+	validateQuotes(nOptions, prices, underlyingPrices, strikes, timesToExpiry);
+
+	const double pi = 3.14159265358979323846;
+	const double infinity = numeric_limits<double>::infinity();
+	boost::math::normal z; // normal variate with mean 0 and variance 1
+	auto isFast = normalDistributionImplementation == NormalDistributionImplementation::fast;
+	double thetas[blockSize], logMoneyness[blockSize], halfMoneyness[blockSize], logTargets[blockSize], targets[blockSize];
+	double standardDeviations[blockSize], lowerBounds[blockSize], upperBounds[blockSize];
+	double cdfD1[blockSize], cdfD2[blockSize], pdfD1[blockSize];
+	bool isActive[blockSize];
+	for (int first = 0; first < nOptions; first += blockSize)
+	{
+		auto n = min(blockSize, nOptions - first);
+		auto S = &underlyingPrices[first];
+		auto K = &strikes[first];
+		auto T = &timesToExpiry[first];
+		auto r = &discountRates[first];
+		auto q = &costsOfCarry[first];
+		auto status = &statuses[first];
+
+		// The normalised time values, the bounds on the prices, and the initial guesses
+		for (int j = 0; j < n; j++)
+		{
+			auto isCall = optionRights[first + j] == OptionRight::call;
+			auto forwardPrice = S[j] * exp((r[j] - q[j]) * T[j]);
+			auto undiscountedPrice = prices[first + j] * exp(r[j] * T[j]);
+			auto intrinsicValue = isCall ? max(forwardPrice - K[j], 0.0) : max(K[j] - forwardPrice, 0.0);
+			auto maximumPrice = isCall ? forwardPrice : K[j];
+			auto timeValue = undiscountedPrice - intrinsicValue;
+			auto normalisation = sqrt(forwardPrice * K[j]);
+
+			thetas[j] = K[j] >= forwardPrice ? 1.0 : -1.0;
+			logMoneyness[j] = log(forwardPrice / K[j]);
+			halfMoneyness[j] = exp(0.5 * logMoneyness[j]);
+			targets[j] = timeValue / normalisation;
+			logTargets[j] = log(targets[j]);
+
+			// Corrado Miller, on the undiscounted call price. The square root has no real value in the far wings, where the normalised price
+			// is instead approximately exp(-x^2 / (2 s^2)).
+			auto callPrice = timeValue + max(forwardPrice - K[j], 0.0);
+			auto halfMoneyValue = callPrice - 0.5 * (forwardPrice - K[j]);
+			auto discriminant = halfMoneyValue * halfMoneyValue - (forwardPrice - K[j]) * (forwardPrice - K[j]) / pi;
+			auto corradoMiller = sqrt(2.0 * pi) / (forwardPrice + K[j]) * (halfMoneyValue + sqrt(max(discriminant, 0.0)));
+			auto asymptotic = fabs(logMoneyness[j]) / sqrt(max(-2.0 * logTargets[j], 1.0e-300));
+			auto initialGuess = discriminant > 0.0 ? corradoMiller : asymptotic;
+			standardDeviations[j] = min(max(initialGuess, minInitialStandardDeviation), maxInitialStandardDeviation);
+			lowerBounds[j] = 0.0;
+			upperBounds[j] = infinity;
+
+			isActive[j] = (timeValue > 0.0) & (undiscountedPrice < maximumPrice);
+			status[j] = undiscountedPrice >= maximumPrice ? ImpliedVolatilityStatus::aboveMaximum
+				: (timeValue < 0.0 ? ImpliedVolatilityStatus::belowIntrinsic 
+				: (timeValue == 0.0 ? ImpliedVolatilityStatus::converged : ImpliedVolatilityStatus::notConverged));
+			if (timeValue == 0.0)
+				standardDeviations[j] = 0.0;
+		}
+
+		for (int iteration = 0; iteration < maxIterations; iteration++)
+		{
+			auto nActive = 0;
+			for (int j = 0; j < n; j++)
+				nActive += isActive[j];
+			if (nActive == 0)
+				break;
+
+			// The arguments of the normal distribution. Quotes which are no longer active are carried along with an argument of 0.
+			for (int j = 0; j < n; j++)
+			{
+				auto s = isActive[j] ? standardDeviations[j] : 1.0;
+				auto x = isActive[j] ? logMoneyness[j] : 0.0;
+				auto d1 = x / s + 0.5 * s;
+				auto d2 = d1 - s;
+				cdfD1[j] = thetas[j] * d1;
+				cdfD2[j] = thetas[j] * d2;
+				pdfD1[j] = d1;
+			}
+
+			// The normal distribution, evaluated in place
+			if (isFast)
+			{
+				utilities::NormalDistribution::cdf(cdfD1, n, cdfD1);
+				utilities::NormalDistribution::cdf(cdfD2, n, cdfD2);
+				utilities::NormalDistribution::pdf(pdfD1, n, pdfD1);
+			}
+			else
+			{
+				for (int j = 0; j < n; j++)
+				{
+					cdfD1[j] = boost::math::cdf(z, cdfD1[j]);
+					cdfD2[j] = boost::math::cdf(z, cdfD2[j]);
+					pdfD1[j] = boost::math::pdf(z, pdfD1[j]);
+				}
+			}
+
+			// Halley steps on log(b), kept within the bracket of the root
+			for (int j = 0; j < n; j++)
+			{
+				auto s = standardDeviations[j];
+				auto x = logMoneyness[j];
+				auto d1 = x / s + 0.5 * s;
+				auto d2 = d1 - s;
+				auto b = thetas[j] * (halfMoneyness[j] * cdfD1[j] - cdfD2[j] / halfMoneyness[j]);
+				auto vega = halfMoneyness[j] * pdfD1[j];
+				auto isAbove = b > targets[j];
+				auto lowerBound = isAbove ? lowerBounds[j] : s;
+				auto upperBound = isAbove ? s : upperBounds[j];
+
+				auto objective = log(b) - logTargets[j];
+				auto slope = vega / b;
+				auto curvature = vega * d1 * d2 / (s * b) - slope * slope;
+				auto newtonStep = -objective / slope;
+				auto halleyStep = newtonStep / (1.0 + 0.5 * newtonStep * curvature / slope);
+				auto next = s + halleyStep;
+				auto bisection = upperBound < infinity ? 0.5 * (lowerBound + upperBound) : 2.0 * s;
+				next = (next >= lowerBound) & (next <= upperBound) ? next : bisection; // false for a NaN step, if b has underflowed
+				auto isConverged = fabs(next - s) <= tolerance * next;
+
+				standardDeviations[j] = isActive[j] ? next : s;
+				lowerBounds[j] = isActive[j] ? lowerBound : lowerBounds[j];
+				upperBounds[j] = isActive[j] ? upperBound : upperBounds[j];
+				status[j] = isActive[j] & isConverged ? ImpliedVolatilityStatus::converged : status[j];
+				isActive[j] = isActive[j] & !isConverged;
+			}
+		}
+
+		// Implied volatilities, which are not defined for prices outside the bounds
+		for (int j = 0; j < n; j++)
+		{
+			auto isDefined = (status[j] == ImpliedVolatilityStatus::converged) | (status[j] == ImpliedVolatilityStatus::notConverged);
+			impliedVolatilities[first + j] = isDefined ? standardDeviations[j] / sqrt(T[j]) : numeric_limits<double>::quiet_NaN();
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef __IMPLIEDVOLATILITYSOLVER_H__
+#define __IMPLIEDVOLATILITYSOLVER_H__
+
+#include "../Enumerations/OptionRight.h"
+#include "../Enumerations/ImpliedVolatilityStatus.h"
+#include "../Enumerations/NormalDistributionImplementation.h"
+
+namespace pricers
+{
+	//// Inversion of the Black Scholes prices of batches of European options to their implied volatilities. The quotes are held as structure 
+	//// of arrays in the same way as for BlackScholesBatchPricer, and the implied volatilities and the status of each inversion are written to
+	//// buffers provided by the caller.
+	//// Each price is reduced to the time value of the out of the money option, normalised by the forward price and the strike, so that the 
+	//// wings are solved from their time value rather than from a price dominated by the intrinsic value. The iterations start from the 
+	//// Corrado Miller approximation (or from the asymptotic of the normalised price in the far wings), and are Halley steps on the logarithm
+	//// of the normalised price, which keeps the steps well scaled where the price is tiny. Each step is kept within a bracket of the root, and
+	//// falls back to bisection if it leaves it. The quotes are solved in blocks, with every iteration applied to all of the quotes of a block
+	//// which have not converged, so that the loops can be vectorised by the compiler.
+	class ImpliedVolatilitySolver
+	{
+	public:
+		static constexpr double tolerance = 1.0e-10; // the relative change in the volatility at which an inversion has converged
+		static constexpr int maxIterations = 40;
+
+		static void solve(const int nOptions, const double* prices, const double* underlyingPrices, const double* strikes, 
+			const double* timesToExpiry, const double* discountRates, const double* costsOfCarry, const enumerations::OptionRight* optionRights, 
+			double* impliedVolatilities, enumerations::ImpliedVolatilityStatus* statuses,
+			const enumerations::NormalDistributionImplementation normalDistributionImplementation = 
+			enumerations::NormalDistributionImplementation::fast);
+
+	private:
+		ImpliedVolatilitySolver() {};
+	};
+}
+
+#endif // !__IMPLIEDVOLATILITYSOLVER_H__
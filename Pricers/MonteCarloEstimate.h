@@ -0,0 +1,19 @@
+#ifndef __MONTECARLOESTIMATE_H__
+#define __MONTECARLOESTIMATE_H__
+
+namespace pricers
+{
+	// The Monte Carlo price of an option with its statistical error, as a flat struct so that arrays of them can be filled without
+	// allocation. The standard error is that of the discounted average payoff, and the confidence interval is the price plus or minus the
+	// standard error times the normal quantile of the confidence level.
+	struct MonteCarloEstimate
+	{
+		double price = 0.0;
+		double standardError = 0.0;
+		double lowerBound = 0.0; // lower end of the confidence interval
+		double upperBound = 0.0; // upper end of the confidence interval
+		int nPaths = 0; // the number of paths the estimate is based on
+	};
+}
+
+#endif // !__MONTECARLOESTIMATE_H__
@@ -2,12 +2,22 @@
 #include <vector>
 #include <numeric>
 #include <random>
+#include <algorithm>
+#include <boost/math/distributions/normal.hpp>
 #include "MonteCarloPricer.h"
 #include "../Enumerations/ExerciseType.h"
+#include "../Enumerations/OptionRight.h"
 
 using namespace std;
 using namespace enumerations;
 
+namespace
+{
+	const int chunkSize = 4096; // the number of paths simulated into a buffer at a time, chosen so that the buffer stays in cache
+	const int chunksPerBatch = 64; // the number of chunks split across the threads at a time, which bounds the memory for the sums of the chunks
+	const int pathsPerAdaptiveBatch = chunkSize * chunksPerBatch; // the number of paths simulated between checks of the standard errors
+}
+
 pricers::MonteCarloPricer::MonteCarloPricer(const std::shared_ptr<models::IMonteCarloModel>& model)
 {
 	setModel(model);
@@ -16,6 +26,61 @@ pricers::MonteCarloPricer::MonteCarloPricer(const std::shared_ptr<models::IMonte
 // Returns the price of the vanilla options
 const std::shared_ptr<std::vector<std::shared_ptr<double>>> pricers::MonteCarloPricer::price(const int& nPaths,
 	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, int seed)
+{
+	auto estimates = estimate(nPaths, vanillaOptions, seed);
+	vector<shared_ptr<double>> prices;
+	prices.reserve(estimates->size());
+	for (auto& estimate : *estimates)
+		prices.push_back(make_shared<double>(estimate.price));
+	auto pricesPtr = make_shared<vector<shared_ptr<double>>>(move(prices));
+	return pricesPtr;
+}
+
+
+// Returns the price of the vanilla options with its standard error and confidence interval, from nPaths paths to each time to expiry
+const std::shared_ptr<std::vector<pricers::MonteCarloEstimate>> pricers::MonteCarloPricer::estimate(const int& nPaths,
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, int seed)
+{
+	// Input validation
+	if (nPaths < 1)
+		throw invalid_argument("The number of paths must be positive.");
+
+	return estimateInBatches(nPaths, nPaths, 0.0, 0.0, vanillaOptions, seed);
+}
+
+
+//// Returns the price of the vanilla options with its standard error and confidence interval. The paths to each time to expiry are simulated
+//// in batches, until the standard error of each of its options is at most the target absolute error, or at most the target relative error
+//// times the price, or until maxPaths paths have been simulated. A target of 0 is never reached, unless the payoff is the same on every path.
+const std::shared_ptr<std::vector<pricers::MonteCarloEstimate>> pricers::MonteCarloPricer::estimate(const double& targetAbsoluteError, 
+	const double& targetRelativeError, const int& maxPaths, 
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, int seed)
+{
+	// Input validation
+	if (maxPaths < 1)
+		throw invalid_argument("The maximum number of paths must be positive.");
+	if (targetAbsoluteError < 0.0 || targetRelativeError < 0.0)
+		throw invalid_argument("The target errors must not be negative.");
+
+	return estimateInBatches(maxPaths, pathsPerAdaptiveBatch, targetAbsoluteError, targetRelativeError, vanillaOptions, seed);
+}
+
+
+void pricers::MonteCarloPricer::setConfidenceLevel(const double& value)
+{
+	if (value <= 0.0 || value >= 1.0)
+		throw invalid_argument("The confidence level must be between 0 and 1.");
+
+	m_confidenceLevel = value;
+}
+
+
+//// Simulates the paths to each time to expiry in batches of nPathsPerBatch paths, until the standard errors of all of its options are within
+//// the targets or maxPaths paths have been simulated. The batches follow on from each other, so the estimates only depend on the total 
+//// number of paths, and not on how they were batched, provided that nPathsPerBatch is a multiple of pathsPerAdaptiveBatch.
+const std::shared_ptr<std::vector<pricers::MonteCarloEstimate>> pricers::MonteCarloPricer::estimateInBatches(const int& maxPaths, 
+	const int& nPathsPerBatch, const double& targetAbsoluteError, const double& targetRelativeError,
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, int seed)
 {
 	// Input validation
 	// Check that the model and vanilla options have the same underlying
@@ -28,30 +93,119 @@ const std::shared_ptr<std::vector<std::shared_ptr<double>>> pricers::MonteCarloP
 			throw invalid_argument("The vanilla options are not on the same undelrying as the pricing model.");
 	}
 
-	// Simulate the underlying values based on the unique times to expiry in the vanilla options vector
-	map<double, shared_ptr<vector<double>>> simulationsByTimeToExpiry;
+	// Draw the seed here rather than in the model, as the chunks of paths simulated on each thread are all seeded from it
+	if (seed == -1)
+	{
+		random_device rd;
+		seed = rd();
+	}
+
+	// Group the options by their time to expiry, as the paths to each time to expiry are simulated once for all of its options
+	map<double, vector<int>> optionIndicesByTimeToExpiry;
 	for (int i = 0; i < nValillaOptions; i++)
 	{
-		auto timeToExpiry = vanillaOptions->at(i)->getTimeToExpiry();
-		if (simulationsByTimeToExpiry.count(timeToExpiry) == 0) // simulation for the current option's time to expiry has not been done.
+		if (vanillaOptions->at(i)->getExerciseType() != ExerciseType::european)
+			throw invalid_argument("Monte carlo pricing is currently only supported for European options.");
+		optionIndicesByTimeToExpiry[vanillaOptions->at(i)->getTimeToExpiry()].push_back(i);
+	}
+
+	// Calculate the price for each vanilla option, as the discounted arithmetic average of its payoffs, with the standard error from the
+	// sample variance of the payoffs
+	boost::math::normal z; // normal variate with mean 0 and variance 1
+	auto quantile = boost::math::quantile(z, 0.5 + 0.5 * m_confidenceLevel);
+	vector<MonteCarloEstimate> estimates(nValillaOptions);
+	for (auto& timeToExpiryOptionIndices : optionIndicesByTimeToExpiry)
+	{
+		auto timeToExpiry = timeToExpiryOptionIndices.first;
+		auto& optionIndices = timeToExpiryOptionIndices.second;
+		vector<double> strikes, exerciseSigns;
+		for (auto i : optionIndices)
 		{
-			auto simulation = m_model->generateMonteCarloSimulations(nPaths, timeToExpiry, seed);
-			simulationsByTimeToExpiry.insert({ timeToExpiry, simulation });
+			strikes.push_back(vanillaOptions->at(i)->getStrike());
+			exerciseSigns.push_back(vanillaOptions->at(i)->getOptionRight() == OptionRight::call ? 1.0 : -1.0);
+		}
+		vector<double> sums(optionIndices.size(), 0.0), sumsOfSquares(optionIndices.size(), 0.0);
+		auto discountFactor = exp(-m_model->getDiscountRate() * timeToExpiry);
+		auto nSimulatedPaths = 0;
+		auto isWithinTargets = false;
+		while (nSimulatedPaths < maxPaths && !isWithinTargets)
+		{
+			auto nBatchPaths = min(nPathsPerBatch, maxPaths - nSimulatedPaths);
+			accumulatePayoffs(nSimulatedPaths, nBatchPaths, timeToExpiry, seed, strikes, exerciseSigns, sums, sumsOfSquares);
+			nSimulatedPaths += nBatchPaths;
+
+			isWithinTargets = true;
+			for (int j = 0; j < optionIndices.size(); j++)
+			{
+				auto& estimate = estimates[optionIndices[j]];
+				auto mean = sums[j] / nSimulatedPaths;
+				auto variance = nSimulatedPaths > 1 ? (sumsOfSquares[j] / nSimulatedPaths - mean * mean) * nSimulatedPaths / (nSimulatedPaths - 1) : 0.0;
+				estimate.price = discountFactor * mean;
+				estimate.standardError = discountFactor * sqrt(fmax(0.0, variance) / nSimulatedPaths);
+				estimate.lowerBound = estimate.price - quantile * estimate.standardError;
+				estimate.upperBound = estimate.price + quantile * estimate.standardError;
+				estimate.nPaths = nSimulatedPaths;
+				isWithinTargets = isWithinTargets && (estimate.standardError <= targetAbsoluteError 
+					|| estimate.standardError <= targetRelativeError * estimate.price);
+			}
 		}
-		else
-			continue;
 	}
+	auto estimatesPtr = make_shared<vector<MonteCarloEstimate>>(move(estimates));
+	return estimatesPtr;
+}
 
-	// Calculate the price for each vanilla option
-	vector<shared_ptr<double>> prices;
-	prices.reserve(nValillaOptions);
-	for (int i = 0; i < nValillaOptions; i++)
+
+//// Adds the payoffs of the paths from firstPath to firstPath + nPaths - 1 to the sums, and their squares to the sums of squares, for options
+//// with the same time to expiry. The paths are simulated a chunk at a time into a buffer which is reused, and the payoffs of all of the 
+//// options are summed over the chunk straight away, so that the memory used does not depend on the number of paths. With a thread pool the 
+//// chunks of each batch are split across the threads, and the sums of the chunks are then added in order, so that the sums are the same 
+//// whatever the number of threads.
+void pricers::MonteCarloPricer::accumulatePayoffs(const int& firstPath, const int& nPaths, const double& timeToExpiry, const int& seed,
+	const std::vector<double>& strikes, const std::vector<double>& exerciseSigns, std::vector<double>& sums, std::vector<double>& sumsOfSquares)
+{
+	auto nOptions = (int)strikes.size();
+	auto nChunks = (nPaths + chunkSize - 1) / chunkSize;
+	vector<double> chunkSums(chunksPerBatch * nOptions), chunkSumsOfSquares(chunksPerBatch * nOptions);
+	for (int firstChunk = 0; firstChunk < nChunks; firstChunk += chunksPerBatch)
 	{
-		auto timeToExpiry = vanillaOptions->at(i)->getTimeToExpiry();
-		prices.push_back(pricers::MonteCarloPricer::price(m_model->getDiscountRate(), simulationsByTimeToExpiry[timeToExpiry], vanillaOptions->at(i)));
+		auto accumulateChunks = [&](const int begin, const int end)
+		{
+			double simulatedPrices[chunkSize];
+			for (int c = begin; c < end; c++)
+			{
+				auto chunkFirstPath = (firstChunk + c) * chunkSize;
+				auto nChunkPaths = min(chunkSize, nPaths - chunkFirstPath);
+				m_model->generateMonteCarloSimulations(nChunkPaths, timeToExpiry, (uint32_t)seed, firstPath + chunkFirstPath, simulatedPrices);
+				for (int o = 0; o < nOptions; o++)
+				{
+					auto sum = 0.0;
+					auto sumOfSquares = 0.0;
+					for (int i = 0; i < nChunkPaths; i++)
+					{
+						auto payoff = exerciseSigns[o] * (simulatedPrices[i] - strikes[o]);
+						payoff = payoff > 0.0 ? payoff : 0.0;
+						sum += payoff;
+						sumOfSquares += payoff * payoff;
+					}
+					chunkSums[c * nOptions + o] = sum;
+					chunkSumsOfSquares[c * nOptions + o] = sumOfSquares;
+				}
+			}
+		};
+		auto nBatchChunks = min(chunksPerBatch, nChunks - firstChunk);
+		if (m_threadPool == nullptr)
+			accumulateChunks(0, nBatchChunks);
+		else
+			m_threadPool->parallelFor(0, nBatchChunks, accumulateChunks);
+		for (int c = 0; c < nBatchChunks; c++)
+		{
+			for (int o = 0; o < nOptions; o++)
+			{
+				sums[o] += chunkSums[c * nOptions + o];
+				sumsOfSquares[o] += chunkSumsOfSquares[c * nOptions + o];
+			}
+		}
 	}
-	auto pricesPtr = make_shared<vector<shared_ptr<double>>>(move(prices));
-	return pricesPtr;
 }
 
 
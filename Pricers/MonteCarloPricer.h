@@ -6,6 +6,8 @@
 #include <vector>
 #include "../Models/MonteCarloModelUtilities/IMonteCarloModel.h"
 #include "../Instruments/VanillaOption.h"
+#include "../Utilities/ThreadPool.h"
+#include "MonteCarloEstimate.h"
 
 namespace pricers
 {
@@ -19,9 +21,13 @@ namespace pricers
 
 		// Getters
 		const std::shared_ptr<models::IMonteCarloModel> getModel() const { return m_model; }
+		const std::shared_ptr<utilities::ThreadPool> getThreadPool() const { return m_threadPool; }
+		const double& getConfidenceLevel() const { return m_confidenceLevel; }
 
 		// Setters
 		void setModel(const std::shared_ptr<models::IMonteCarloModel>& value) { m_model = value; }
+		void setThreadPool(const std::shared_ptr<utilities::ThreadPool>& value) { m_threadPool = value; } // nullptr for serial simulation
+		void setConfidenceLevel(const double& value);
 
 		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
 		MonteCarloPricer& operator = (MonteCarloPricer const&) = delete;
@@ -33,8 +39,26 @@ namespace pricers
 		static const std::shared_ptr<double> price(const double& discountRate, const std::shared_ptr<std::vector<double>>& simulatedUnderlyingPrice,
 			const std::shared_ptr<instruments::VanillaOption>& vanillaOption);
 
+		// Prices with their standard errors and confidence intervals, from nPaths paths to each time to expiry
+		const std::shared_ptr<std::vector<MonteCarloEstimate>> estimate(const int& nPaths,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, int seed = -1);
+		// As above, with the paths to each time to expiry simulated in batches until the standard errors of all of its options are within 
+		// the target absolute error or the target relative error, or maxPaths paths have been simulated
+		const std::shared_ptr<std::vector<MonteCarloEstimate>> estimate(const double& targetAbsoluteError, const double& targetRelativeError,
+			const int& maxPaths, const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, 
+			int seed = -1);
+
 	private:
 		std::shared_ptr<models::IMonteCarloModel> m_model;
+		std::shared_ptr<utilities::ThreadPool> m_threadPool; // paths are only split across threads if a thread pool has been provided
+		double m_confidenceLevel = 0.95; // the probability of the price being within the confidence interval
+
+		const std::shared_ptr<std::vector<MonteCarloEstimate>> estimateInBatches(const int& maxPaths, const int& nPathsPerBatch, 
+			const double& targetAbsoluteError, const double& targetRelativeError,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, int seed);
+		void accumulatePayoffs(const int& firstPath, const int& nPaths, const double& timeToExpiry, const int& seed, 
+			const std::vector<double>& strikes, const std::vector<double>& exerciseSigns, std::vector<double>& sums, 
+			std::vector<double>& sumsOfSquares);
 	};
 }
 
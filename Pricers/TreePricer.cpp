@@ -1,14 +1,115 @@
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <numeric>
+#include <limits>
 #include "TreePricer.h"
+#include "BackwardInductionKernel.h"
+#include "BranchingKernel.h"
 #include "../Enumerations/ExerciseType.h"
-#include "../Models/TreeModelUtilities/TreeNode.h"
+#include "../Enumerations/OptionRight.h"
+#include "../Utilities/ArenaAllocator.h"
 
 using namespace std;
 using namespace enumerations;
 using namespace models;
 
+typedef vector<double, utilities::ArenaAllocator<double>> ScratchVector; // scratch memory, allocated from the arena of the pricer if provided
+
+namespace
+{
+	//// Applies the exercise conditions to the smoothed values of an option at the nodes of a level, writing them to the option values of the
+	//// nodes, which are stride apart. As in VanillaOption::valueAtTreeNode, the smoothed value of a European option is kept as it is.
+	void applySmoothedValueExercise(double* values, const int stride, const double* smoothedValues, const double* underlyingPrices, 
+		const int nNodes, const double strike, const double exerciseSign, const double americanMask)
+	{
+		for (int j = 0; j < nNodes; j++)
+			values[j * stride] = americanMask > 0.5 ? fmax(smoothedValues[j], fmax(0.0, exerciseSign * (underlyingPrices[j] - strike))) 
+				: smoothedValues[j];
+	}
+
+	//// The price, delta, gamma and theta of option o, read off the first three times of a tree. underlyingPrices[i] and optionValues[i] hold
+	//// the underlying prices and the option values (node-major) at the nodes of time i. Delta is the slope of the least squares line through
+	//// the option values at time 1. Gamma is the curvature of the least squares quadratic in S - S0 through the option values at time 2, and 
+	//// the value of the quadratic at S0 gives theta over the two time steps. For binomial trees these are the usual finite differences, e.g.
+	//// (V_u - V_d) / (S_u - S_d) for delta, and (V_ud - V_0) / (2 dt) for theta when the middle node at time 2 is S0. Vega and rho would 
+	//// require the tree to be constructed again with bumped model parameters, and are NaN. The nodes at times 1 and 2 must not have been 
+	//// truncated by the standard deviation limits of the tree, nor shifted by the deduction of a dividend.
+	models::Greeks calculateTreeGreeks(const vector<double>(&underlyingPrices)[3], const vector<double>(&optionValues)[3], const int nOptions, 
+		const int o, const double timeStepSize)
+	{
+		models::Greeks greeks;
+		auto initialUnderlyingPrice = underlyingPrices[0][0];
+		greeks.price = optionValues[0][o];
+		greeks.vega = numeric_limits<double>::quiet_NaN();
+		greeks.rho = numeric_limits<double>::quiet_NaN();
+		if (underlyingPrices[1].size() < 2 || underlyingPrices[2].size() < 3)
+			throw invalid_argument("The first times of the tree have been truncated, so the Greeks cannot be read off it. Widen the limits.");
+
+		// Delta
+		auto nNodes = (int)underlyingPrices[1].size();
+		auto meanUnderlyingPrice = 0.0;
+		auto meanOptionValue = 0.0;
+		for (int j = 0; j < nNodes; j++)
+		{
+			meanUnderlyingPrice += underlyingPrices[1][j] / (double)nNodes;
+			meanOptionValue += optionValues[1][j * nOptions + o] / (double)nNodes;
+		}
+		auto sumSquares = 0.0;
+		auto sumProducts = 0.0;
+		for (int j = 0; j < nNodes; j++)
+		{
+			auto difference = underlyingPrices[1][j] - meanUnderlyingPrice;
+			sumSquares += difference * difference;
+			sumProducts += difference * (optionValues[1][j * nOptions + o] - meanOptionValue);
+		}
+		greeks.delta = sumProducts / sumSquares;
+
+		// Gamma and theta, from the normal equations of V = a + b u + c u^2, with u = (S - S0) / scale for the conditioning of the equations
+		nNodes = (int)underlyingPrices[2].size();
+		auto scale = 0.0;
+		for (int j = 0; j < nNodes; j++)
+			scale = fmax(scale, abs(underlyingPrices[2][j] - initialUnderlyingPrice));
+		double equations[3][4] = {};
+		for (int j = 0; j < nNodes; j++)
+		{
+			auto u = (underlyingPrices[2][j] - initialUnderlyingPrice) / scale;
+			double powers[3] = { 1.0, u, u * u };
+			for (int r = 0; r < 3; r++)
+			{
+				for (int c = 0; c < 3; c++)
+					equations[r][c] += powers[r] * powers[c];
+				equations[r][3] += powers[r] * optionValues[2][j * nOptions + o];
+			}
+		}
+		for (int r = 0; r < 3; r++) // Gaussian elimination with partial pivoting
+		{
+			auto pivot = r;
+			for (int k = r + 1; k < 3; k++)
+				if (abs(equations[k][r]) > abs(equations[pivot][r]))
+					pivot = k;
+			swap(equations[r], equations[pivot]);
+			for (int k = r + 1; k < 3; k++)
+			{
+				auto factor = equations[k][r] / equations[r][r];
+				for (int c = r; c < 4; c++)
+					equations[k][c] -= factor * equations[r][c];
+			}
+		}
+		double coefficients[3];
+		for (int r = 2; r >= 0; r--)
+		{
+			coefficients[r] = equations[r][3];
+			for (int c = r + 1; c < 3; c++)
+				coefficients[r] -= equations[r][c] * coefficients[c];
+			coefficients[r] /= equations[r][r];
+		}
+		greeks.gamma = 2.0 * coefficients[2] / (scale * scale);
+		greeks.theta = (coefficients[0] - greeks.price) / (2.0 * timeStepSize);
+		return greeks;
+	}
+}
+
 pricers::TreePricer::TreePricer(const std::shared_ptr<models::ITreeModel>& model)
 {
 	setModel(model);
@@ -39,11 +140,37 @@ const std::shared_ptr<std::vector<std::shared_ptr<double>>> pricers::TreePricer:
 
 
 //// Returns the price of the vanilla options for a specified number of discrete time steps 
-//// Trees for the underlying price are constructed using the private model, as delegated at run time.
-//// Trees are constructred for each unique expiry in the set of options, and then the tree is passed on the option pricing function.
 const std::shared_ptr<std::vector<std::shared_ptr<double>>> pricers::TreePricer::price(const int nTimeSteps,
 	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing, 
 	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation)
+{
+	auto greeks = priceByExpiry(nTimeSteps, vanillaOptions, useVanillaOptionSmoothing, implementation, upperLimitStandardDeviation,
+		lowerLimitStandardDeviation, false);
+	vector<shared_ptr<double>> prices;
+	prices.reserve(greeks.size());
+	for (auto& optionGreeks : greeks)
+		prices.push_back(make_shared<double>(optionGreeks.price));
+	auto pricesPtr = make_shared<vector<shared_ptr<double>>>(move(prices));
+	return pricesPtr;
+}
+
+//// Returns the price, delta, gamma and theta of the vanilla options for a specified number of discrete time steps. The Greeks are read off 
+//// the trees which are constructed for the prices, rather than by pricing again on trees with bumped inputs.
+const std::vector<models::Greeks> pricers::TreePricer::priceWithGreeks(const int nTimeSteps,
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing, 
+	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation)
+{
+	return priceByExpiry(nTimeSteps, vanillaOptions, useVanillaOptionSmoothing, implementation, upperLimitStandardDeviation,
+		lowerLimitStandardDeviation, true);
+}
+
+//// Trees for the underlying price are constructed using the private model, as delegated at run time.
+//// Trees are constructred for each unique expiry in the set of options, and then the tree is passed on the option pricing function, which
+//// prices all of the options on that expiry in a single backward induction.
+const std::vector<models::Greeks> pricers::TreePricer::priceByExpiry(const int nTimeSteps,
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, const bool useVanillaOptionSmoothing, 
+	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation,
+	const bool calculateGreeks)
 {
 	// Input validation. Check that the model and vanilla options have the same underlying
 	auto nValillaOptions = vanillaOptions->size();
@@ -55,41 +182,97 @@ const std::shared_ptr<std::vector<std::shared_ptr<double>>> pricers::TreePricer:
 			throw invalid_argument("The vanilla options are not on the same undelrying as the pricing model.");
 	}
 
-	// Construct a tree for the underlying asset price for each unique times to expiry in the vanilla options vector
-	map<double, shared_ptr<Tree>> treesByTimeToExpiry;
+	// Group the vanilla options by their time to expiry
+	map<double, vector<int>> optionIndicesByTimeToExpiry;
 	for (int i = 0; i < nValillaOptions; i++)
+		optionIndicesByTimeToExpiry[vanillaOptions->at(i)->getTimeToExpiry()].push_back(i);
+
+	// Construct a tree for the underlying asset price for each unique times to expiry in the vanilla options vector, and price all of the 
+	// options on that expiry together. If the model supports it, and it has been selected, an implicit recombining lattice is constructed 
+	// instead of the tree. If a tree cache has been provided, trees which have already been constructed with the same inputs are reused. If a
+	// memory budget has been set, the size of each tree is estimated before it is constructed, and the number of time steps is fitted to it.
+	auto useRecombiningLattice = m_useRecombiningLattice && m_model->supportsRecombiningLattice();
+	vector<models::Greeks> greeks(nValillaOptions);
+	for (auto& optionIndices : optionIndicesByTimeToExpiry)
 	{
-		auto timeToExpiry = vanillaOptions->at(i)->getTimeToExpiry();
-		if (treesByTimeToExpiry.count(timeToExpiry) == 0) // tree for the current option's time to expiry has not been constructed.
+		auto timeToExpiry = optionIndices.first;
+		vector<shared_ptr<instruments::VanillaOption>> expiryOptions;
+		expiryOptions.reserve(optionIndices.second.size());
+		for (auto& index : optionIndices.second)
+			expiryOptions.push_back(vanillaOptions->at(index));
+		auto expiryOptionsPtr = make_shared<vector<shared_ptr<instruments::VanillaOption>>>(move(expiryOptions));
+
+		vector<models::Greeks> expiryGreeks;
+		if (useRecombiningLattice)
 		{
-			//auto nTimeSteps = (int)(timeToExpiry / timeStepSize + 0.5); // round up the number of time steps
-			auto tree = m_model->constructTree(nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, lowerLimitStandardDeviation);
-			treesByTimeToExpiry.insert({ timeToExpiry, move(tree) });
+			auto lattice = m_model->constructRecombiningLattice(nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation,
+				lowerLimitStandardDeviation);
+			expiryGreeks = priceOnLattice(lattice, expiryOptionsPtr, useVanillaOptionSmoothing, calculateGreeks);
 		}
 		else
-			continue;
+		{
+			//auto nTimeSteps = (int)(timeToExpiry / timeStepSize + 0.5); // round up the number of time steps
+			auto nTreeTimeSteps = m_maxTreeBytes > 0 
+				? fitTimeStepsToMaxTreeBytes(nTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, lowerLimitStandardDeviation)
+				: nTimeSteps;
+			auto tree = m_treeCache != nullptr
+				? m_treeCache->getTree(m_model, nTreeTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, 
+					lowerLimitStandardDeviation)
+				: m_model->constructTree(nTreeTimeSteps, timeToExpiry, implementation, upperLimitStandardDeviation, lowerLimitStandardDeviation);
+			expiryGreeks = priceOnTree(tree, expiryOptionsPtr, useVanillaOptionSmoothing, calculateGreeks);
+		}
+		for (int i = 0; i < optionIndices.second.size(); i++)
+			greeks[optionIndices.second[i]] = expiryGreeks[i];
 	}
+	return greeks;
+}
+
+//// Calculate the price for a Vanilla Option given a preconstructed tree and discount rate 
+const std::shared_ptr<double> pricers::TreePricer::price(const double discountRate, const std::shared_ptr<models::Tree> tree, 
+	const std::shared_ptr<instruments::VanillaOption> vanillaOption, const bool useVanillaOptionSmoothing)
+{
+	auto vanillaOptionsPtr = make_shared<vector<shared_ptr<instruments::VanillaOption>>>(1, vanillaOption);
+	auto pricesPtr = price(discountRate, tree, vanillaOptionsPtr, useVanillaOptionSmoothing);
+	return pricesPtr->at(0);
+}
 
-	// Calculate the price for each vanilla option
+//// Calculate the price for a set of Vanilla Options with the same expiry given a preconstructed tree and discount rate 
+const std::shared_ptr<std::vector<std::shared_ptr<double>>> pricers::TreePricer::price(const double discountRate, 
+	const std::shared_ptr<models::Tree> tree, const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, 
+	const bool useVanillaOptionSmoothing)
+{
+	auto greeks = priceOnTree(tree, vanillaOptions, useVanillaOptionSmoothing, false);
 	vector<shared_ptr<double>> prices;
-	prices.reserve(nValillaOptions);
-	for (int i = 0; i < nValillaOptions; i++)
-	{
-		auto timeToExpiry = vanillaOptions->at(i)->getTimeToExpiry();
-		prices.push_back(pricers::TreePricer::price(m_model->getDiscountRate(), treesByTimeToExpiry[timeToExpiry], vanillaOptions->at(i), 
-			useVanillaOptionSmoothing));
-	}
+	prices.reserve(greeks.size());
+	for (auto& optionGreeks : greeks)
+		prices.push_back(make_shared<double>(optionGreeks.price));
 	auto pricesPtr = make_shared<vector<shared_ptr<double>>>(move(prices));
 	return pricesPtr;
 }
 
-//// Calculate the price for a Vanilla Option given a preconstructed tree and discount rate 
-const std::shared_ptr<double> pricers::TreePricer::price(const double discountRate, const std::shared_ptr<models::Tree> tree, 
-	const std::shared_ptr<instruments::VanillaOption> vanillaOption, const bool useVanillaOptionSmoothing)
+//// Calculate the price, delta, gamma and theta for a set of Vanilla Options with the same expiry given a preconstructed tree and discount rate 
+const std::vector<models::Greeks> pricers::TreePricer::priceWithGreeks(const double discountRate, const std::shared_ptr<models::Tree> tree, 
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing)
 {
-	// Input validation - check whether the time to expiry of the provided tree is the same as that for the vanilla option
-	if (abs(tree->getTimeToExpiry() - vanillaOption->getTimeToExpiry()) > 0.0000001)
-		throw invalid_argument("The provided tree and vanilla option do not have the same time to maturity.");
+	return priceOnTree(tree, vanillaOptions, useVanillaOptionSmoothing, true);
+}
+
+//// The options are priced in a single backward induction. The option values are stored node-major, i.e. the value of option o at node j is 
+//// held at j * nOptions + o, so that the forward indices and probabilities of each node are loaded once and shared across all of the options.
+//// If the Greeks are calculated, the option values at the first three times are kept as the induction passes them.
+const std::vector<models::Greeks> pricers::TreePricer::priceOnTree(const std::shared_ptr<models::Tree>& tree,
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, const bool useVanillaOptionSmoothing,
+	const bool calculateGreeks)
+{
+	// Input validation - check whether the time to expiry of the provided tree is the same as that for the vanilla options
+	auto nOptions = (int)vanillaOptions->size();
+	for (int o = 0; o < nOptions; o++)
+		if (abs(tree->getTimeToExpiry() - vanillaOptions->at(o)->getTimeToExpiry()) > 0.0000001)
+			throw invalid_argument("The provided tree and vanilla option do not have the same time to maturity.");
+	if (calculateGreeks && tree->getNTimesSteps() < 2)
+		throw invalid_argument("The Greeks require a tree with at least two time steps.");
+	if (calculateGreeks && tree->getDividendTimeIndex() <= 2)
+		throw invalid_argument("A dividend is deducted within the first two time steps of the tree, so the Greeks cannot be read off it.");
 
 	// Pricing is done in backwards time. Suppose there are n time steps. Then, if useVanillaOptionSmoothing is true, and the model supports it,
 	// then we calculate the value at each node at time n - 1 as the smooth value. Otherwise, we start at time n, and calculate the payoff (i.e.
@@ -97,80 +280,399 @@ const std::shared_ptr<double> pricers::TreePricer::price(const double discountRa
 
 	auto nTimeSteps = tree->getNTimesSteps();
 	auto timeStepSize = (tree->getTimeToExpiry()) / nTimeSteps;
-	auto treeNodes = tree->getTreeNodes();
-	vector<double> futureValues; // option value at the tree nodes of the next time step
-	vector<double> currentValues; // option value at the tree nodes of current time step
-	auto maxFutureValuesNodes = treeNodes->at(nTimeSteps - 1)->size();
-	futureValues.reserve(maxFutureValuesNodes);
-	currentValues.reserve(maxFutureValuesNodes);
+	auto& levelOffsets = tree->getLevelOffsets();
+	auto& nodeValues = tree->getValues();
+	auto& firstForwardIndex = tree->getFirstForwardIndex(); // the index of the first node for the forward time hit by each node
+	auto& nodeBranchingIndex = tree->getNodeBranchingIndex();
+	auto& branchings = tree->getBranchings();
+	auto& branchProbabilities = tree->getBranchProbabilities(); // the probability of reaching each of the nodes for the forward time
+	auto discountFactor = exp(-1.0 * m_model->getDiscountRate() * timeStepSize);
+	auto isSmoothed = useVanillaOptionSmoothing && m_model->supportsVanillaOptionSmoothing(timeStepSize * (double)(nTimeSteps - 1),
+		timeStepSize * (double)nTimeSteps);
 
-	auto currentValuesPtr = make_shared<vector<double>>(move(currentValues));
-	auto futureValuesPtr = make_shared<vector<double>>(move(futureValues));
+	// The scratch memory is released back to the arena, if provided, when the pricing is done
+	utilities::ArenaScope arenaScope(m_arena.get());
+	utilities::ArenaAllocator<double> allocator(m_arena.get());
 
-	// useVanillaOptionSmoothin determines whether or not to use the closed form solution in valuing the option 
-	// The smoothing is only applicable if the current time is the second last time in the grid, with the last time being expiry
-	for (int i = (nTimeSteps - 1); i >= 0; i--) 
+	// The exercise conditions of each option are unpacked once, rather than at every node
+	ScratchVector strikes(allocator);
+	ScratchVector exerciseSigns(allocator);
+	ScratchVector americanMasks(allocator); // 1 for American options, 0 for European options
+	strikes.reserve(nOptions);
+	exerciseSigns.reserve(nOptions);
+	americanMasks.reserve(nOptions);
+	for (auto& vanillaOption : *vanillaOptions)
 	{
+		strikes.push_back(vanillaOption->getStrike());
+		exerciseSigns.push_back(vanillaOption->getOptionRight() == OptionRight::call ? 1.0 : -1.0);
+		americanMasks.push_back(vanillaOption->getExerciseType() == ExerciseType::american ? 1.0 : 0.0);
+	}
 
-		auto futureTreeNodes = treeNodes->at(i + 1); // i = 2 returns the tree nodes at the last time step, i.e. expiry
-		auto currentTreeNodes = treeNodes->at(i); 
+	ScratchVector futureValues(allocator); // option values at the tree nodes of the next time step
+	ScratchVector currentValues(allocator); // option values at the tree nodes of current time step
+	auto maxFutureValuesNodes = tree->getNNodes(nTimeSteps);
+	futureValues.reserve(maxFutureValuesNodes * nOptions);
+	currentValues.reserve(maxFutureValuesNodes * nOptions);
+	vector<double> levelUnderlyingPrices[3]; // underlying prices and option values at the first three times, for the Greeks
+	vector<double> levelOptionValues[3];
 
-		// Initialise the future values. i.e. calculate the option payoff at maturity, and apply any exercise conditions.
-		// Only needs to done if there is no smoothing
-		if (i == (nTimeSteps - 1) && !(useVanillaOptionSmoothing && m_model->supportsVanillaOptionSmoothing(timeStepSize * (double)i, 
-			timeStepSize * (double)(i+1))))
-		{
-			for (int j = 0; j < futureTreeNodes->size(); j++) 
-			{
-				auto payoffAtNode = vanillaOption->intrinsicValue(futureTreeNodes->at(j)->getValue()); // at maturity the value is always intrinsic
-				futureValuesPtr->push_back(*payoffAtNode);
-			}
-		}
+	// Initialise the future values. i.e. calculate the option payoff at maturity. Only needs to done if there is no smoothing
+	if (!isSmoothed)
+	{
+		for (int j = levelOffsets[nTimeSteps]; j < levelOffsets[nTimeSteps + 1]; j++)
+			for (int o = 0; o < nOptions; o++)
+				futureValues.push_back(fmax(0.0, exerciseSigns[o] * (nodeValues[j] - strikes[o]))); // at maturity the value is always intrinsic
+	}
 
-		// Get the future tree nodes
-		if (i == (nTimeSteps - 1) && useVanillaOptionSmoothing && m_model->supportsVanillaOptionSmoothing(timeStepSize * (double)i, 
-			timeStepSize * (double)(i + 1)))
+	// useVanillaOptionSmoothin determines whether or not to use the closed form solution in valuing the option 
+	// The smoothing is only applicable if the current time is the second last time in the grid, with the last time being expiry
+	for (int i = (nTimeSteps - 1); i >= 0; i--)
+	{
+		auto currentOffset = levelOffsets[i];
+		auto nCurrentNodes = levelOffsets[i + 1] - currentOffset;
+		currentValues.assign(nCurrentNodes * nOptions, 0.0);
+
+		if (i == (nTimeSteps - 1) && isSmoothed)
 		{
-			for (int j = 0; j < currentTreeNodes->size(); j++)
+			// The smoothed values of each option are calculated for the whole level at once
+			ScratchVector smoothedValues(nCurrentNodes, 0.0, allocator);
+			for (int o = 0; o < nOptions; o++)
 			{
-				auto smoothedValue = m_model->smoothedValueAtTreeNode(
-					currentTreeNodes->at(j)->getValue(),
-					vanillaOption,
-					timeStepSize);
-				auto value = vanillaOption->valueAtTreeNode(*smoothedValue, currentTreeNodes->at(j)->getValue()); // apply Exercise conditions
-				currentValuesPtr->push_back(*value);
+				m_model->smoothedValuesAtTreeNodes(&nodeValues[currentOffset], nCurrentNodes, vanillaOptions->at(o), timeStepSize, 
+					smoothedValues.data(), m_normalDistributionImplementation);
+				applySmoothedValueExercise(&currentValues[o], nOptions, smoothedValues.data(), &nodeValues[currentOffset], nCurrentNodes,
+					strikes[o], exerciseSigns[o], americanMasks[o]);
 			}
 		}
 		else // i.e. no smoothing, calculate the expected present value for each node, and apply any exercise conditions
 		{
-			for (int j = 0; j < currentTreeNodes->size(); j++)
+			auto stepNodes = [&](const int nodeBegin, const int nodeEnd)
 			{
-				auto currentTreeNode = currentTreeNodes->at(j);
-				auto value = 0.0;
-				// iterate through each of the forward underlying prices of the current node
-				auto forwardValuesIndex = currentTreeNode->getForwardValuesIndex(); // the index of the nodes for the forward time
-				auto forwardProbabilities = currentTreeNode->getForwardProbabilities(); // the index of the nodes for the forward time
-				auto nForwardValues = currentTreeNode->getNForwardValues();
-				for (int k = 0; k < currentTreeNode->getNForwardValues(); k++)
+				if (tree->isBinomialLevel(i)) // node j branches to nodes j and j + 1 with the same probabilities
 				{
-					auto index = forwardValuesIndex->at(k);
-					value += forwardProbabilities->at(k) * futureValuesPtr->at(index);
+					auto& probabilities = branchProbabilities[tree->getBranching(currentOffset).probabilitiesIndex];
+					auto upProbability = probabilities[0];
+					auto downProbability = probabilities[1];
+					if (nOptions == 1)
+						BackwardInductionKernel::stepOverNodes(&currentValues[nodeBegin], &futureValues[nodeBegin], 
+							&nodeValues[currentOffset + nodeBegin], nodeEnd - nodeBegin, upProbability, downProbability, discountFactor, 
+							strikes[0], exerciseSigns[0], americanMasks[0]);
+					else
+						for (int j = nodeBegin; j < nodeEnd; j++)
+							BackwardInductionKernel::stepOverOptions(&currentValues[j * nOptions], &futureValues[j * nOptions],
+								&futureValues[(j + 1) * nOptions], nodeValues[currentOffset + j], nOptions, upProbability, downProbability, 
+								discountFactor, strikes.data(), exerciseSigns.data(), americanMasks.data());
+					return;
 				}
-				value = value * exp(-1.0 * m_model->getDiscountRate() * timeStepSize); // expected present value
-				auto exercisedValue = vanillaOption->valueAtTreeNode(value, currentTreeNode->getValue());
-				currentValuesPtr->push_back(*exercisedValue);
-			}
+
+				// Levels where all nodes share the same branching go through a kernel specialised on the number of branches
+				auto levelBranchingIndex = tree->getLevelBranchingIndex(i);
+				if (levelBranchingIndex >= 0)
+				{
+					auto& branching = branchings[levelBranchingIndex];
+					auto probabilities = branchProbabilities[branching.probabilitiesIndex].data();
+					auto stepOverNodes = branching.nBranches == 2 ? &BranchingKernel<2>::stepOverNodes
+						: branching.nBranches == 10 ? &BranchingKernel<10>::stepOverNodes
+						: branching.nBranches == 20 ? &BranchingKernel<20>::stepOverNodes : nullptr;
+					if (stepOverNodes != nullptr)
+					{
+						stepOverNodes(&currentValues[nodeBegin * nOptions], futureValues.data(), &nodeValues[currentOffset + nodeBegin],
+							&firstForwardIndex[currentOffset + nodeBegin], nodeEnd - nodeBegin, nOptions, probabilities, discountFactor,
+							strikes.data(), exerciseSigns.data(), americanMasks.data());
+						return;
+					}
+				}
+
+				for (int j = nodeBegin; j < nodeEnd; j++)
+				{
+					auto node = currentOffset + j;
+					auto currentRow = &currentValues[j * nOptions];
+					// iterate through each of the forward underlying prices of the current node, which are consecutive nodes at the next time
+					auto& branching = branchings[nodeBranchingIndex[node]];
+					auto futureRow = &futureValues[firstForwardIndex[node] * nOptions];
+					for (int k = 0; k < branching.nBranches; k++, futureRow += nOptions)
+					{
+						auto forwardProbability = branchProbabilities[branching.probabilitiesIndex][k];
+						for (int o = 0; o < nOptions; o++)
+							currentRow[o] += forwardProbability * futureRow[o];
+					}
+					auto underlyingPrice = nodeValues[node];
+					for (int o = 0; o < nOptions; o++)
+					{
+						auto value = currentRow[o] * discountFactor; // expected present value
+						currentRow[o] = fmax(value, americanMasks[o] * fmax(0.0, exerciseSigns[o] * (underlyingPrice - strikes[o])));
+					}
+				}
+			};
+			stepLevel(nCurrentNodes, stepNodes);
+		}
+
+		// Keep the values of the first times for the Greeks
+		if (calculateGreeks && i <= 2)
+		{
+			levelUnderlyingPrices[i].assign(&nodeValues[currentOffset], &nodeValues[currentOffset] + nCurrentNodes);
+			levelOptionValues[i].assign(currentValues.begin(), currentValues.end());
 		}
 
 		// Swap around the points for the next time step
-		futureValuesPtr = currentValuesPtr; // the current option values become the future values for the next time step
-		vector<double> newEmptyVector;
-		newEmptyVector.reserve(maxFutureValuesNodes);
-		currentValuesPtr = make_shared<vector<double>>(newEmptyVector); // point the current values ptr to a new empty vector
+		futureValues.swap(currentValues); // the current option values become the future values for the next time step
+	}
+
+	// Return the option prices, which are held in futureValues after the loop is done
+	vector<models::Greeks> greeks(nOptions);
+	for (int o = 0; o < nOptions; o++)
+	{
+		if (calculateGreeks)
+			greeks[o] = calculateTreeGreeks(levelUnderlyingPrices, levelOptionValues, nOptions, o, timeStepSize);
+		else
+			greeks[o].price = futureValues[o];
+	}
+	return greeks;
+}
+
+
+//// Calculate the price for a Vanilla Option given a preconstructed implicit recombining lattice and discount rate 
+const std::shared_ptr<double> pricers::TreePricer::price(const double discountRate, const std::shared_ptr<models::RecombiningLattice> lattice,
+	const std::shared_ptr<instruments::VanillaOption> vanillaOption, const bool useVanillaOptionSmoothing)
+{
+	auto vanillaOptionsPtr = make_shared<vector<shared_ptr<instruments::VanillaOption>>>(1, vanillaOption);
+	auto pricesPtr = price(discountRate, lattice, vanillaOptionsPtr, useVanillaOptionSmoothing);
+	return pricesPtr->at(0);
+}
+
+//// Calculate the price for a set of Vanilla Options with the same expiry given a preconstructed implicit recombining lattice and discount rate 
+const std::shared_ptr<std::vector<std::shared_ptr<double>>> pricers::TreePricer::price(const double discountRate, 
+	const std::shared_ptr<models::RecombiningLattice> lattice, 
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing)
+{
+	auto greeks = priceOnLattice(lattice, vanillaOptions, useVanillaOptionSmoothing, false);
+	vector<shared_ptr<double>> prices;
+	prices.reserve(greeks.size());
+	for (auto& optionGreeks : greeks)
+		prices.push_back(make_shared<double>(optionGreeks.price));
+	auto pricesPtr = make_shared<vector<shared_ptr<double>>>(move(prices));
+	return pricesPtr;
+}
+
+//// Calculate the price, delta, gamma and theta for a set of Vanilla Options with the same expiry given a preconstructed implicit recombining
+//// lattice and discount rate 
+const std::vector<models::Greeks> pricers::TreePricer::priceWithGreeks(const double discountRate, 
+	const std::shared_ptr<models::RecombiningLattice> lattice, 
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing)
+{
+	return priceOnLattice(lattice, vanillaOptions, useVanillaOptionSmoothing, true);
+}
+
+//// The option values are held in a single buffer indexed by the number of down moves (and then by option), and are overwritten in place in 
+//// backwards time. The value at node k only depends on the values at nodes k and k + 1 at the next time, so sweeping k upwards never 
+//// overwrites a value that is still required. Hence, the memory required is O(nTimeSteps * nOptions). Levels that are split across threads
+//// are written to a second buffer instead, as the threads do not sweep in order. If the Greeks are calculated, the option values at the 
+//// first three times are kept as the induction passes them.
+const std::vector<models::Greeks> pricers::TreePricer::priceOnLattice(const std::shared_ptr<models::RecombiningLattice>& lattice,
+	const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, const bool useVanillaOptionSmoothing,
+	const bool calculateGreeks)
+{
+	// Input validation - check whether the time to expiry of the provided lattice is the same as that for the vanilla options
+	auto nOptions = (int)vanillaOptions->size();
+	for (int o = 0; o < nOptions; o++)
+		if (abs(lattice->getTimeToExpiry() - vanillaOptions->at(o)->getTimeToExpiry()) > 0.0000001)
+			throw invalid_argument("The provided lattice and vanilla option do not have the same time to maturity.");
+	if (calculateGreeks && lattice->getNTimesSteps() < 2)
+		throw invalid_argument("The Greeks require a lattice with at least two time steps.");
+	if (calculateGreeks && lattice->getDividendTimeIndex() <= 2)
+		throw invalid_argument("A dividend is deducted within the first two time steps of the lattice, so the Greeks cannot be read off it.");
+
+	auto nTimeSteps = lattice->getNTimesSteps();
+	auto timeStepSize = (lattice->getTimeToExpiry()) / nTimeSteps;
+	auto upProbability = lattice->getUpProbability();
+	auto downProbability = lattice->getDownProbability();
+	auto discountFactor = exp(-1.0 * m_model->getDiscountRate() * timeStepSize);
+	auto isSmoothed = useVanillaOptionSmoothing && m_model->supportsVanillaOptionSmoothing(timeStepSize * (double)(nTimeSteps - 1),
+		timeStepSize * (double)nTimeSteps);
+
+	// The scratch memory is released back to the arena, if provided, when the pricing is done
+	utilities::ArenaScope arenaScope(m_arena.get());
+	utilities::ArenaAllocator<double> allocator(m_arena.get());
+
+	// The exercise conditions of each option are unpacked once, rather than at every node
+	ScratchVector strikes(allocator);
+	ScratchVector exerciseSigns(allocator);
+	ScratchVector americanMasks(allocator); // 1 for American options, 0 for European options
+	strikes.reserve(nOptions);
+	exerciseSigns.reserve(nOptions);
+	americanMasks.reserve(nOptions);
+	for (auto& vanillaOption : *vanillaOptions)
+	{
+		strikes.push_back(vanillaOption->getStrike());
+		exerciseSigns.push_back(vanillaOption->getOptionRight() == OptionRight::call ? 1.0 : -1.0);
+		americanMasks.push_back(vanillaOption->getExerciseType() == ExerciseType::american ? 1.0 : 0.0);
+	}
+	auto hasAmericanOption = find(americanMasks.begin(), americanMasks.end(), 1.0) != americanMasks.end();
+	ScratchVector values((nTimeSteps + 1) * nOptions, 0.0, allocator); // option values at the nodes, indexed by the number of down moves
+	ScratchVector nextValues(allocator); // only required for the levels that are split across threads, which cannot be updated in place
+	ScratchVector underlyingPrices(nTimeSteps + 1, 0.0, allocator); // underlying prices at the nodes of the current time
+	vector<double> levelUnderlyingPrices[3]; // underlying prices and option values at the first three times, for the Greeks
+	vector<double> levelOptionValues[3];
+	auto keepLevel = [&](const int i)
+	{
+		if (!calculateGreeks || i > 2)
+			return;
+		auto firstDownMoves = lattice->getFirstDownMoves(i);
+		auto nNodes = lattice->getLastDownMoves(i) - firstDownMoves + 1;
+		levelUnderlyingPrices[i].resize(nNodes);
+		lattice->getValues(i, firstDownMoves, nNodes, levelUnderlyingPrices[i].data());
+		levelOptionValues[i].assign(&values[firstDownMoves * nOptions], &values[firstDownMoves * nOptions] + nNodes * nOptions);
+	};
+
+	// Initialise the values at expiry. Only needs to done if there is no smoothing
+	if (!isSmoothed)
+	{
+		for (int k = lattice->getFirstDownMoves(nTimeSteps); k <= lattice->getLastDownMoves(nTimeSteps); k++)
+		{
+			auto underlyingPrice = lattice->getValue(nTimeSteps, k);
+			for (int o = 0; o < nOptions; o++)
+				values[k * nOptions + o] = fmax(0.0, exerciseSigns[o] * (underlyingPrice - strikes[o])); // at maturity the value is always intrinsic
+		}
+	}
+
+	// Calculates the expected present value for the nodes [kBegin, kEnd) at time i, and applies any exercise conditions. Truncated moves are 
+	// removed from the highest and lowest nodes, in which case the remaining move has a probability of 1. The nodes in between branch to both 
+	// nodes k and k + 1, and are handed to the binomial kernel. The underlying prices are only required if there are American options.
+	auto stepNodes = [&](const int i, const int kBegin, const int kEnd, double* currentValues, const double* futureValues)
+	{
+		auto firstFutureDownMoves = lattice->getFirstDownMoves(i + 1);
+		auto binomialBegin = max(kBegin, max(lattice->getFirstDownMoves(i), firstFutureDownMoves));
+		auto binomialEnd = min(kEnd, min(lattice->getLastDownMoves(i), lattice->getLastDownMoves(i + 1) - 1) + 1);
+		for (int k = kBegin; k < kEnd; k++)
+		{
+			if (k == binomialBegin && binomialBegin < binomialEnd)
+			{
+				if (hasAmericanOption)
+					lattice->getValues(i, binomialBegin, binomialEnd - binomialBegin, &underlyingPrices[binomialBegin]);
+				if (nOptions == 1)
+					BackwardInductionKernel::stepOverNodes(currentValues + k, futureValues + k, &underlyingPrices[k], binomialEnd - k,
+						upProbability, downProbability, discountFactor, strikes[0], exerciseSigns[0], americanMasks[0]);
+				else
+					for (int l = binomialBegin; l < binomialEnd; l++)
+						BackwardInductionKernel::stepOverOptions(currentValues + l * nOptions, futureValues + l * nOptions, 
+							futureValues + (l + 1) * nOptions, underlyingPrices[l], nOptions, upProbability, downProbability, discountFactor,
+							strikes.data(), exerciseSigns.data(), americanMasks.data());
+				k = binomialEnd - 1;
+				continue;
+			}
+
+			auto isUpMoveAdded = k >= firstFutureDownMoves;
+			auto futureRow = futureValues + (isUpMoveAdded ? k : k + 1) * nOptions;
+			auto currentRow = currentValues + k * nOptions;
+			auto underlyingPrice = lattice->getValue(i, k);
+			for (int o = 0; o < nOptions; o++)
+			{
+				auto value = futureRow[o] * discountFactor; // expected present value
+				currentRow[o] = fmax(value, americanMasks[o] * fmax(0.0, exerciseSigns[o] * (underlyingPrice - strikes[o])));
+			}
+		}
+	};
+
+	auto i = nTimeSteps - 1;
+	if (i >= 0 && isSmoothed)
+	{
+		// The smoothed values of each option are calculated for the whole level at once
+		auto firstDownMoves = lattice->getFirstDownMoves(i);
+		auto nNodes = lattice->getLastDownMoves(i) - firstDownMoves + 1;
+		ScratchVector smoothedValues(nNodes, 0.0, allocator);
+		lattice->getValues(i, firstDownMoves, nNodes, underlyingPrices.data());
+		for (int o = 0; o < nOptions; o++)
+		{
+			m_model->smoothedValuesAtTreeNodes(underlyingPrices.data(), nNodes, vanillaOptions->at(o), timeStepSize, smoothedValues.data(),
+				m_normalDistributionImplementation);
+			applySmoothedValueExercise(&values[firstDownMoves * nOptions + o], nOptions, smoothedValues.data(), underlyingPrices.data(), nNodes,
+				strikes[o], exerciseSigns[o], americanMasks[o]);
+		}
+		keepLevel(i);
+		i--;
+	}
+
+	while (i >= 0)
+	{
+		auto firstDownMoves = lattice->getFirstDownMoves(i);
+		auto lastDownMoves = lattice->getLastDownMoves(i);
+		auto nNodes = lastDownMoves - firstDownMoves + 1;
+
+		// Levels that are split across threads are written to the second buffer, and the other levels are updated in place
+		if (isParallelLevel(nNodes))
+		{
+			nextValues.resize(values.size());
+			stepLevel(nNodes, [&](const int nodeBegin, const int nodeEnd) {
+				stepNodes(i, firstDownMoves + nodeBegin, firstDownMoves + nodeEnd, nextValues.data(), values.data()); });
+			values.swap(nextValues);
+		}
+		else
+			stepNodes(i, firstDownMoves, lastDownMoves + 1, values.data(), values.data());
+		keepLevel(i);
+		i--;
 	}
 
-	// Return the option price
-	auto pricePtr = make_shared<double>(move(futureValuesPtr->at(0))); // after the loop is done, the option price is pointed to by futureValuesPtr
-	return pricePtr;
+	// Return the option prices
+	vector<models::Greeks> greeks(nOptions);
+	for (int o = 0; o < nOptions; o++)
+	{
+		if (calculateGreeks)
+			greeks[o] = calculateTreeGreeks(levelUnderlyingPrices, levelOptionValues, nOptions, o, timeStepSize);
+		else
+			greeks[o].price = values[o];
+	}
+	return greeks;
+}
+
+
+//// Whether a level of backward induction with the given number of nodes is split across the thread pool
+const bool pricers::TreePricer::isParallelLevel(const int nNodes) const
+{
+	return m_threadPool != nullptr && m_threadPool->getNThreads() > 1 && nNodes >= m_parallelLevelWidth;
 }
 
+//// Runs stepNodes over the nodes [0, nNodes) of a level. Wide levels are split into contiguous chunks across the thread pool. Each node is
+//// calculated exactly as in the serial sweep, so the results are identical regardless of the number of threads.
+void pricers::TreePricer::stepLevel(const int nNodes, const std::function<void(const int, const int)>& stepNodes)
+{
+	if (isParallelLevel(nNodes))
+		m_threadPool->parallelFor(0, nNodes, stepNodes);
+	else
+		stepNodes(0, nNodes);
+}
+
+//// Returns the number of time steps with which to construct a tree within the memory budget, based on the size of the tree estimated by the
+//// model. A tree that is over budget is refused, unless reducing the time steps has been selected, in which case the largest number of time
+//// steps within the budget is found by bisection, as the size of the tree grows with the number of time steps. Note that under Richardson
+//// Extrapolation, the trees with nTimeSteps and 2 * nTimeSteps are each fitted to the budget separately.
+const int pricers::TreePricer::fitTimeStepsToMaxTreeBytes(const int nTimeSteps, const double timeToExpiry, 
+	const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation)
+{
+	auto isWithinBudget = [&](const int n) { return m_model->estimateTreeSize(n, timeToExpiry, implementation, upperLimitStandardDeviation, 
+		lowerLimitStandardDeviation).nBytes <= (double)m_maxTreeBytes; };
+	if (isWithinBudget(nTimeSteps))
+		return nTimeSteps;
+	if (!m_reduceTimeStepsToMaxTreeBytes)
+		throw invalid_argument("The estimated size of the tree exceeds the memory budget of the pricer.");
+	if (!isWithinBudget(1))
+		throw invalid_argument("The estimated size of the tree exceeds the memory budget of the pricer for any number of time steps.");
+
+	auto lowerTimeSteps = 1; // within the budget
+	auto upperTimeSteps = nTimeSteps; // over the budget
+	while (upperTimeSteps - lowerTimeSteps > 1)
+	{
+		auto middleTimeSteps = lowerTimeSteps + (upperTimeSteps - lowerTimeSteps) / 2;
+		if (isWithinBudget(middleTimeSteps))
+			lowerTimeSteps = middleTimeSteps;
+		else
+			upperTimeSteps = middleTimeSteps;
+	}
+	return lowerTimeSteps;
+}
+
+void pricers::TreePricer::setParallelLevelWidth(const int& value)
+{
+	if (value < 1)
+		throw invalid_argument("The minimum level width for parallel backward induction must be at least 1.");
+	m_parallelLevelWidth = value;
+}
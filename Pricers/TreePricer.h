@@ -4,10 +4,17 @@
 #include <iostream>
 #include <memory>
 #include <vector>
+#include <functional>
 #include "../Models/TreeModelUtilities/ITreeModel.h"
 #include "../Models/TreeModelUtilities/Tree.h"
+#include "../Models/TreeModelUtilities/RecombiningLattice.h"
+#include "../Models/TreeModelUtilities/TreeCache.h"
+#include "../Models/AnalyticModelUtilities/Greeks.h"
 #include "../Instruments/VanillaOption.h"
 #include "../Enumerations/Implementation.h"
+#include "../Enumerations/NormalDistributionImplementation.h"
+#include "../Utilities/ThreadPool.h"
+#include "../Utilities/Arena.h"
 
 namespace pricers
 {
@@ -21,9 +28,31 @@ namespace pricers
 
 		// Getters
 		const std::shared_ptr<models::ITreeModel> getModel() const { return m_model; }
+		const bool& getUseRecombiningLattice() const { return m_useRecombiningLattice; }
+		const std::shared_ptr<utilities::ThreadPool> getThreadPool() const { return m_threadPool; }
+		const int& getParallelLevelWidth() const { return m_parallelLevelWidth; }
+		const std::shared_ptr<models::TreeCache> getTreeCache() const { return m_treeCache; }
+		const size_t& getMaxTreeBytes() const { return m_maxTreeBytes; }
+		const bool& getReduceTimeStepsToMaxTreeBytes() const { return m_reduceTimeStepsToMaxTreeBytes; }
+		const std::shared_ptr<utilities::Arena> getArena() const { return m_arena; }
+		const enumerations::NormalDistributionImplementation& getNormalDistributionImplementation() const 
+		{ 
+			return m_normalDistributionImplementation; 
+		}
 
 		// Setters
 		void setModel(const std::shared_ptr<models::ITreeModel>& value) { m_model = value; }
+		void setUseRecombiningLattice(const bool& value) { m_useRecombiningLattice = value; } // only applies to models that support the lattice
+		void setThreadPool(const std::shared_ptr<utilities::ThreadPool>& value) { m_threadPool = value; } // nullptr for serial pricing
+		void setParallelLevelWidth(const int& value);
+		void setTreeCache(const std::shared_ptr<models::TreeCache>& value) { m_treeCache = value; } // nullptr to construct every tree
+		void setMaxTreeBytes(const size_t& value) { m_maxTreeBytes = value; } // 0 for no memory budget
+		void setReduceTimeStepsToMaxTreeBytes(const bool& value) { m_reduceTimeStepsToMaxTreeBytes = value; } // rather than throwing
+		void setArena(const std::shared_ptr<utilities::Arena>& value) { m_arena = value; } // nullptr to allocate scratch memory from the heap
+		void setNormalDistributionImplementation(const enumerations::NormalDistributionImplementation& value) // used by the smoothing
+		{ 
+			m_normalDistributionImplementation = value; 
+		}
 
 		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
 		TreePricer& operator = (TreePricer const&) = delete;
@@ -41,8 +70,55 @@ namespace pricers
 		const std::shared_ptr<double> price(const double discountRate, const std::shared_ptr<models::Tree> tree,
 			const std::shared_ptr<instruments::VanillaOption> vanillaOption, const bool useVanillaOptionSmoothing);
 
+		const std::shared_ptr<std::vector<std::shared_ptr<double>>> price(const double discountRate, const std::shared_ptr<models::Tree> tree,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing);
+
+		const std::shared_ptr<double> price(const double discountRate, const std::shared_ptr<models::RecombiningLattice> lattice,
+			const std::shared_ptr<instruments::VanillaOption> vanillaOption, const bool useVanillaOptionSmoothing);
+
+		const std::shared_ptr<std::vector<std::shared_ptr<double>>> price(const double discountRate, 
+			const std::shared_ptr<models::RecombiningLattice> lattice,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing);
+
+		// Prices with the delta, gamma and theta read off the first times of the same backward induction. Vega and rho are not calculated
+		// and are always NaN, as they would require trees constructed with bumped model parameters, so hedging jobs which need them must
+		// bump and reprice. The limits must be wide enough that the first two time steps of the tree are not truncated, and no dividend may
+		// be deducted within the first two time steps, as the levels would be shifted to ex-dividend prices. Otherwise an exception is thrown.
+		const std::vector<models::Greeks> priceWithGreeks(const int nTimeSteps,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing,
+			const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation);
+
+		const std::vector<models::Greeks> priceWithGreeks(const double discountRate, const std::shared_ptr<models::Tree> tree,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing);
+
+		const std::vector<models::Greeks> priceWithGreeks(const double discountRate, const std::shared_ptr<models::RecombiningLattice> lattice,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>> vanillaOptions, const bool useVanillaOptionSmoothing);
+
 	private:
 		std::shared_ptr<models::ITreeModel> m_model;
+		bool m_useRecombiningLattice = false; // price on an implicit lattice rather than a materialised tree
+		std::shared_ptr<utilities::ThreadPool> m_threadPool; // levels are only split across threads if a thread pool has been provided
+		int m_parallelLevelWidth = 2048; // the minimum number of nodes in a level for it to be split across threads
+		std::shared_ptr<models::TreeCache> m_treeCache; // trees are only reused across calls if a tree cache has been provided
+		size_t m_maxTreeBytes = 0; // the memory budget for the construction of each tree, with 0 for no budget
+		bool m_reduceTimeStepsToMaxTreeBytes = false; // whether trees over budget are constructed with fewer time steps, or refused
+		std::shared_ptr<utilities::Arena> m_arena; // the scratch memory of the backward induction is allocated from the arena, if provided
+		enumerations::NormalDistributionImplementation m_normalDistributionImplementation = enumerations::NormalDistributionImplementation::boost;
+
+		const std::vector<models::Greeks> priceByExpiry(const int nTimeSteps, 
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, const bool useVanillaOptionSmoothing,
+			const enumerations::Implementation implementation, const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation,
+			const bool calculateGreeks);
+		const std::vector<models::Greeks> priceOnTree(const std::shared_ptr<models::Tree>& tree,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, const bool useVanillaOptionSmoothing,
+			const bool calculateGreeks);
+		const std::vector<models::Greeks> priceOnLattice(const std::shared_ptr<models::RecombiningLattice>& lattice,
+			const std::shared_ptr<std::vector<std::shared_ptr<instruments::VanillaOption>>>& vanillaOptions, const bool useVanillaOptionSmoothing,
+			const bool calculateGreeks);
+		const bool isParallelLevel(const int nNodes) const;
+		void stepLevel(const int nNodes, const std::function<void(const int, const int)>& stepNodes);
+		const int fitTimeStepsToMaxTreeBytes(const int nTimeSteps, const double timeToExpiry, const enumerations::Implementation implementation,
+			const double upperLimitStandardDeviation, const double lowerLimitStandardDeviation);
 	};
 }
 
@@ -5,15 +5,30 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <random>
+#include <numeric>
+#include <boost/math/distributions/normal.hpp>
 #include "../Enumerations/ExerciseType.h"
 #include "../Enumerations/OptionRight.h"
 #include "../Enumerations/UnderlyingCode.h"
 #include "../Enumerations/Implementation.h"
+#include "../Enumerations/NormalDistributionImplementation.h"
+#include "../Enumerations/ImpliedVolatilityStatus.h"
+#include "../Enumerations/KernelImplementation.h"
 #include "../Instruments/VanillaOption.h"
 #include "../Models/BlackScholes.h"
+#include "../Models/TreeModelUtilities/LogNormalDiffusionTreeHelper.h"
+#include "../Models/TreeModelUtilities/RecombiningNodeValues.h"
 #include "../Pricers/MonteCarloPricer.h"
 #include "../Pricers/AnalyticPricer.h"
 #include "../Pricers/TreePricer.h"
+#include "../Pricers/BackwardInductionKernel.h"
+#include "../Pricers/BlackScholesBatchPricer.h"
+#include "../Pricers/ImpliedVolatilitySolver.h"
+#include "../Utilities/Arena.h"
+#include "../Utilities/NormalDistribution.h"
+#include "../Utilities/NormalVariateGenerator.h"
+#include "../Utilities/Philox.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -263,6 +278,1231 @@ namespace tests
 		return testPass;
 	}
 
+	//// Black Scholes Model : price European options on a 10,000 step implicit recombining lattice. The lattice only requires O(nTimeSteps) 
+	//// memory, so that large trees can be used for accuracy checks against the analytic solution.
+	bool BlackScholesModelTest5()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.1;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		auto vanillaOption1 = make_shared<VanillaOption>(105.0, 0.5, ExerciseType::european, OptionRight::put, UnderlyingCode::BHP);
+		auto vanillaOption2 = make_shared<VanillaOption>(90.0, 2.0, ExerciseType::european, OptionRight::put, UnderlyingCode::BHP);
+		auto vanillaOption3 = make_shared<VanillaOption>(110.0, 1.0, ExerciseType::european, OptionRight::call, UnderlyingCode::BHP);
+		auto vanillaOption4 = make_shared<VanillaOption>(100.0, 2.0, ExerciseType::european, OptionRight::call, UnderlyingCode::BHP);
+
+		vector<shared_ptr<VanillaOption>> vanillaOptions{ vanillaOption1, vanillaOption2, vanillaOption3, vanillaOption4 };
+		auto vanillaOptionsPtr = make_shared < vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		AnalyticPricer analyticPricer(blackScholesModel);
+		TreePricer treePricer(blackScholesModel);
+		treePricer.setUseRecombiningLattice(true);
+
+		// Price options
+		auto analyticPrices = analyticPricer.price(vanillaOptionsPtr);
+		// The limits are widened, as with very small time steps the limits of 6 standard deviations truncate the first few time steps
+		auto latticePrices = treePricer.price(10000, vanillaOptionsPtr, false, Implementation::One, 20.0, -20.0); // using Cox Ross Rubinstein
+
+		// Check values
+		auto testPass = true;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			auto absRelDiffLattice = abs(100.0 * (*latticePrices->at(i) - *analyticPrices->at(i)) / *analyticPrices->at(i));
+
+			// Check for 0.01% error
+			if (absRelDiffLattice > 0.01) {
+				testPass = false;
+				std::cout << "Lattice Price: " << *latticePrices->at(i)
+					<< "\t Analytic Price:" << *analyticPrices->at(i)
+					<< "\t Relative Difference:" << absRelDiffLattice
+					<< std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Black Scholes Model : price a book of American options with many strikes on a single expiry. All of the strikes are priced in a single
+	//// backward induction over the tree, which should give exactly the same prices as pricing each option on the tree individually.
+	bool BlackScholesModelTest6()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.1;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		vector<shared_ptr<VanillaOption>> vanillaOptions;
+		for (int i = 0; i < 100; i++)
+		{
+			auto optionRight = i % 2 == 0 ? OptionRight::put : OptionRight::call;
+			vanillaOptions.push_back(make_shared<VanillaOption>(75.0 + 0.5 * (double)i, 1.0, ExerciseType::american, optionRight, 
+				UnderlyingCode::BHP));
+		}
+		auto vanillaOptionsPtr = make_shared < vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		TreePricer treePricer(blackScholesModel);
+
+		// Price options
+		auto tree = blackScholesModel->constructTree(500, 1.0, Implementation::One, 6.0, -6.0);
+		auto batchedPrices = treePricer.price(discountRate, tree, vanillaOptionsPtr, false);
+
+		// Check values
+		auto testPass = true;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			auto price = treePricer.price(discountRate, tree, vanillaOptionsPtr->at(i), false);
+			if (*price != *batchedPrices->at(i)) {
+				testPass = false;
+				std::cout << "Batched Tree Price: " << *batchedPrices->at(i)
+					<< "\t Tree Price:" << *price
+					<< std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Black Scholes Model : splitting the levels of the tree and the lattice across threads gives identical prices to the serial pricing
+	bool BlackScholesModelTest7()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.1;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		vector<shared_ptr<VanillaOption>> vanillaOptions;
+		for (int i = 0; i < 10; i++)
+		{
+			auto optionRight = i % 2 == 0 ? OptionRight::put : OptionRight::call;
+			vanillaOptions.push_back(make_shared<VanillaOption>(80.0 + 4.0 * (double)i, 1.0, ExerciseType::american, optionRight, 
+				UnderlyingCode::BHP));
+		}
+		auto vanillaOptionsPtr = make_shared < vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		TreePricer serialPricer(blackScholesModel);
+		TreePricer parallelPricer(blackScholesModel);
+		parallelPricer.setThreadPool(make_shared<utilities::ThreadPool>(4));
+		parallelPricer.setParallelLevelWidth(64);
+
+		// Price options, with the tree truncated so that the highest and lowest nodes are not binomial
+		auto testPass = true;
+		for (auto useRecombiningLattice : { false, true })
+		{
+			serialPricer.setUseRecombiningLattice(useRecombiningLattice);
+			parallelPricer.setUseRecombiningLattice(useRecombiningLattice);
+			for (auto nOptions : { 1, 10 })
+			{
+				auto options = make_shared<vector<shared_ptr<VanillaOption>>>(vanillaOptionsPtr->begin(), vanillaOptionsPtr->begin() + nOptions);
+				auto serialPrices = serialPricer.price(1000, options, false, Implementation::One, 3.0, -3.0);
+				auto parallelPrices = parallelPricer.price(1000, options, false, Implementation::One, 3.0, -3.0);
+
+				// Check values
+				for (int i = 0; i < nOptions; i++)
+				{
+					if (*serialPrices->at(i) != *parallelPrices->at(i)) {
+						testPass = false;
+						std::cout << "Serial Price: " << *serialPrices->at(i)
+							<< "\t Parallel Price:" << *parallelPrices->at(i)
+							<< std::endl;
+					}
+				}
+			}
+		}
+		return testPass;
+	}
+
+	//// Black Scholes Model : trees are reused from the tree cache when the inputs are unchanged, and the cache stays within its size
+	bool BlackScholesModelTest9()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.1;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		auto vanillaOption1 = make_shared<VanillaOption>(105.0, 0.5, ExerciseType::american, OptionRight::put, UnderlyingCode::BHP);
+		auto vanillaOption2 = make_shared<VanillaOption>(95.0, 1.0, ExerciseType::american, OptionRight::call, UnderlyingCode::BHP);
+		vector<shared_ptr<VanillaOption>> vanillaOptions{ vanillaOption1, vanillaOption2 };
+		auto vanillaOptionsPtr = make_shared < vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		auto treeCache = make_shared<TreeCache>(64 * 1024 * 1024);
+		TreePricer treePricer(blackScholesModel);
+		TreePricer cachedTreePricer(blackScholesModel);
+		cachedTreePricer.setTreeCache(treeCache);
+
+		// Price options. The second pricing, by a new pricer on a new model with the same parameters, reuses both trees
+		auto treePrices = treePricer.price(500, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		auto cachedTreePrices = cachedTreePricer.price(500, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		TreePricer newCachedTreePricer(make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode));
+		newCachedTreePricer.setTreeCache(treeCache);
+		auto reusedTreePrices = newCachedTreePricer.price(500, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+
+		// Check values
+		auto testPass = treeCache->getNMisses() == 2 && treeCache->getNHits() == 2 && treeCache->getNTrees() == 2;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			if (*treePrices->at(i) != *cachedTreePrices->at(i) || *treePrices->at(i) != *reusedTreePrices->at(i)) {
+				testPass = false;
+				std::cout << "Tree Price: " << *treePrices->at(i)
+					<< "\t Cached Tree Price:" << *cachedTreePrices->at(i)
+					<< "\t Reused Tree Price:" << *reusedTreePrices->at(i)
+					<< std::endl;
+			}
+		}
+
+		// A change to the model parameters constructs new trees, and shrinking the cache evicts the least recently used trees
+		blackScholesModel->setImpliedVolatility(0.2);
+		cachedTreePricer.price(500, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		testPass = testPass && treeCache->getNMisses() == 4 && treeCache->getNTrees() == 4;
+		treeCache->setMaxBytes(treeCache->getNBytes() / 2);
+		testPass = testPass && treeCache->getNTrees() == 2 && treeCache->getNBytes() <= treeCache->getMaxBytes();
+		cachedTreePricer.price(500, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		testPass = testPass && treeCache->getNHits() == 4;
+		return testPass;
+	}
+
+	//// Black Scholes Model : the estimated size of the tree matches the constructed tree, with and without truncation, and a tree pricer with
+	//// a memory budget either refuses a tree over budget, or prices with the largest number of time steps within the budget
+	bool BlackScholesModelTest10()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.1;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Compare the estimated and constructed trees
+		auto testPass = true;
+		vector<double> limits{ 6.0, 2.0, 0.5 };
+		for (auto& limit : limits)
+		{
+			auto tree = blackScholesModel->constructTree(400, 1.0, Implementation::One, limit, -limit);
+			auto estimate = blackScholesModel->estimateTreeSize(400, 1.0, Implementation::One, limit, -limit);
+			auto nMaxLevelNodes = 0;
+			for (int i = 0; i < tree->getNTimesSteps() + 1; i++)
+				nMaxLevelNodes = max(nMaxLevelNodes, tree->getNNodes(i));
+			if (estimate.nNodes != tree->getNNodes() || estimate.nBranches != tree->getNBranches() 
+				|| estimate.nMaxLevelNodes != nMaxLevelNodes || estimate.nBytes > tree->getNBytes())
+			{
+				testPass = false;
+				std::cout << "Limit: " << limit
+					<< "\t Estimated Nodes: " << estimate.nNodes << "\t Tree Nodes: " << tree->getNNodes()
+					<< "\t Estimated Branches: " << estimate.nBranches << "\t Tree Branches: " << tree->getNBranches()
+					<< "\t Estimated Bytes: " << estimate.nBytes << "\t Tree Bytes: " << tree->getNBytes()
+					<< std::endl;
+			}
+		}
+
+		// Construct Vanilla Options
+		auto vanillaOption = make_shared<VanillaOption>(105.0, 1.0, ExerciseType::american, OptionRight::put, UnderlyingCode::BHP);
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>(1, vanillaOption);
+
+		// Set the memory budget to half of the tree with 500 time steps
+		auto maxTreeBytes = (size_t)(0.5 * blackScholesModel->estimateTreeSize(500, 1.0, Implementation::One, 6.0, -6.0).nBytes);
+		auto nFittedTimeSteps = 500;
+		while (blackScholesModel->estimateTreeSize(nFittedTimeSteps, 1.0, Implementation::One, 6.0, -6.0).nBytes > maxTreeBytes)
+			nFittedTimeSteps--;
+		TreePricer treePricer(blackScholesModel);
+		TreePricer budgetTreePricer(blackScholesModel);
+		budgetTreePricer.setMaxTreeBytes(maxTreeBytes);
+
+		// A tree over budget is refused
+		auto isRefused = false;
+		try
+		{
+			budgetTreePricer.price(500, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		}
+		catch (const invalid_argument&)
+		{
+			isRefused = true;
+		}
+		testPass = testPass && isRefused;
+
+		// A tree over budget is priced with fewer time steps, and a tree within budget is unchanged
+		budgetTreePricer.setReduceTimeStepsToMaxTreeBytes(true);
+		auto fittedPrice = budgetTreePricer.price(500, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0)->at(0);
+		auto expectedFittedPrice = treePricer.price(nFittedTimeSteps, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0)->at(0);
+		auto withinBudgetPrice = budgetTreePricer.price(200, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0)->at(0);
+		auto expectedWithinBudgetPrice = treePricer.price(200, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0)->at(0);
+		if (*fittedPrice != *expectedFittedPrice || *withinBudgetPrice != *expectedWithinBudgetPrice)
+		{
+			testPass = false;
+			std::cout << "Fitted Time Steps: " << nFittedTimeSteps
+				<< "\t Budget Price: " << *fittedPrice << "\t Expected Price: " << *expectedFittedPrice
+				<< "\t Within Budget Price: " << *withinBudgetPrice << "\t Expected Price: " << *expectedWithinBudgetPrice
+				<< std::endl;
+		}
+		return testPass && nFittedTimeSteps < 500;
+	}
+
+	//// Black Scholes Model : the underlying prices of the tree, calculated in closed form, match those calculated by multiplying the price of
+	//// the previous node by the up or down multiplier, and the implicit lattice has the same nodes as the tree
+	bool BlackScholesModelTest11()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.3;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct tree and lattice
+		auto nTimeSteps = 2000;
+		auto timeToExpiry = 1.0;
+		auto tree = blackScholesModel->constructTree(nTimeSteps, timeToExpiry, Implementation::One, 20.0, -20.0);
+		auto lattice = blackScholesModel->constructRecombiningLattice(nTimeSteps, timeToExpiry, Implementation::One, 20.0, -20.0);
+		shared_ptr<vector<double>> diffusionStatesPtr, diffusionProbabilitiesPtr;
+		tie(diffusionStatesPtr, diffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateDiffusionStatesAndProbabilities(
+			timeToExpiry / (double)nTimeSteps, impliedVolatility, discountRate, costOfCarry, Implementation::One);
+		auto upMultiplier = exp(diffusionStatesPtr->at(0));
+		auto downMultiplier = exp(diffusionStatesPtr->at(1));
+
+		// Check values. The first node at each time is an up move from the first node at the previous time, and the remaining nodes are down
+		// moves from the nodes at the previous time.
+		auto testPass = tree->getNNodes() == (nTimeSteps + 1) * (nTimeSteps + 2) / 2;
+		auto maxRelDiff = 0.0;
+		vector<double> multipliedValues{ initialUnderlyingPrice };
+		for (int i = 1; i < nTimeSteps + 1 && testPass; i++)
+		{
+			vector<double> nextMultipliedValues{ multipliedValues[0] * upMultiplier };
+			for (auto& value : multipliedValues)
+				nextMultipliedValues.push_back(value * downMultiplier);
+			multipliedValues = move(nextMultipliedValues);
+			for (int j = 0; j < i + 1; j++)
+			{
+				maxRelDiff = max(maxRelDiff, abs(tree->getValue(i, j) - multipliedValues[j]) / multipliedValues[j]);
+				if (tree->getValue(i, j) != lattice->getValue(i, j))
+					testPass = false;
+			}
+		}
+		if (maxRelDiff > 1.0e-12 || !testPass)
+		{
+			testPass = false;
+			std::cout << "Max Relative Difference: " << maxRelDiff << std::endl;
+		}
+		return testPass;
+	}
+
+	//// Black Scholes Model : pricing with the scratch memory allocated from an arena gives identical prices to the heap, releases all of the
+	//// memory at the end of each call, reuses the blocks of the arena across calls, and reports the peak memory used
+	bool BlackScholesModelTest12()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.1;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		auto vanillaOption1 = make_shared<VanillaOption>(105.0, 1.0, ExerciseType::american, OptionRight::put, UnderlyingCode::BHP);
+		auto vanillaOption2 = make_shared<VanillaOption>(95.0, 1.0, ExerciseType::american, OptionRight::call, UnderlyingCode::BHP);
+		vector<shared_ptr<VanillaOption>> vanillaOptions{ vanillaOption1, vanillaOption2 };
+		auto vanillaOptionsPtr = make_shared < vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		auto arena = make_shared<utilities::Arena>(64 * 1024);
+		TreePricer treePricer(blackScholesModel);
+		TreePricer arenaTreePricer(blackScholesModel);
+		arenaTreePricer.setArena(arena);
+		TreePricer latticePricer(blackScholesModel);
+		TreePricer arenaLatticePricer(blackScholesModel);
+		latticePricer.setUseRecombiningLattice(true);
+		arenaLatticePricer.setUseRecombiningLattice(true);
+		arenaLatticePricer.setArena(arena);
+
+		// Price options
+		auto nTimeSteps = 1000;
+		auto treePrices = treePricer.price(nTimeSteps, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		auto arenaTreePrices = arenaTreePricer.price(nTimeSteps, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		auto nReservedBytes = arena->getNReservedBytes();
+		arenaTreePricer.price(nTimeSteps, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		auto latticePrices = latticePricer.price(nTimeSteps, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		auto arenaLatticePrices = arenaLatticePricer.price(nTimeSteps, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+
+		// Check values. The tree holds the option values of two levels of at most nTimeSteps + 1 nodes at once.
+		auto minPeakBytes = 2 * (nTimeSteps + 1) * vanillaOptionsPtr->size() * sizeof(double);
+		auto testPass = arena->getNBytes() == 0 && arena->getPeakBytes() >= minPeakBytes && arena->getNReservedBytes() == nReservedBytes;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			if (*treePrices->at(i) != *arenaTreePrices->at(i) || *latticePrices->at(i) != *arenaLatticePrices->at(i))
+			{
+				testPass = false;
+				std::cout << "Tree Price: " << *treePrices->at(i)
+					<< "\t Arena Tree Price:" << *arenaTreePrices->at(i)
+					<< "\t Lattice Price:" << *latticePrices->at(i)
+					<< "\t Arena Lattice Price:" << *arenaLatticePrices->at(i)
+					<< std::endl;
+			}
+		}
+
+		// Allocations are aligned, and released to a mark in O(1)
+		auto mark = arena->getMark();
+		auto bytes = arena->allocate(3, 1);
+		auto doubles = arena->allocate(10 * sizeof(double), alignof(double));
+		auto largeAllocation = arena->allocate(1024 * 1024, 64);
+		testPass = testPass && bytes != nullptr && reinterpret_cast<uintptr_t>(doubles) % alignof(double) == 0
+			&& reinterpret_cast<uintptr_t>(largeAllocation) % 64 == 0 && arena->getNBytes() >= 1024 * 1024;
+		arena->release(mark);
+		testPass = testPass && arena->getNBytes() == 0;
+		if (!testPass)
+			std::cout << "Peak Bytes: " << arena->getPeakBytes() << "\t Bytes: " << arena->getNBytes() << std::endl;
+		return testPass;
+	}
+
+	//// Tests that the smoothed values of a whole level are the same as those calculated node by node, to rounding as the compiler may contract
+	//// the two calculations differently, and that the tree and lattice prices with smoothing agree
+	bool BlackScholesModelTest13()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Compare the smoothed values of a level against those of each node
+		auto testPass = true;
+		auto timeStepSize = 0.01;
+		vector<double> underlyingPrices;
+		for (int j = 0; j < 201; j++)
+			underlyingPrices.push_back(50.0 + 0.5 * j);
+		vector<double> smoothedValues(underlyingPrices.size());
+		for (auto optionRight : { OptionRight::call, OptionRight::put })
+		{
+			auto vanillaOption = make_shared<VanillaOption>(100.0, 1.0, ExerciseType::american, optionRight, underlyingCode);
+			blackScholesModel->smoothedValuesAtTreeNodes(underlyingPrices.data(), (int)underlyingPrices.size(), vanillaOption, timeStepSize,
+				smoothedValues.data(), NormalDistributionImplementation::boost);
+			for (int j = 0; j < underlyingPrices.size(); j++)
+			{
+				auto smoothedValue = *blackScholesModel->smoothedValueAtTreeNode(underlyingPrices[j], vanillaOption, timeStepSize);
+				testPass = testPass && abs(smoothedValues[j] - smoothedValue) <= 1.0e-12 * fmax(1.0, abs(smoothedValue));
+			}
+		}
+		if (!testPass)
+			std::cout << "The smoothed values of the level do not match those of each node." << std::endl;
+
+		// Construct Vanilla Options
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>();
+		for (auto strike : { 90.0, 100.0, 110.0 })
+		{
+			vanillaOptionsPtr->push_back(make_shared<VanillaOption>(strike, 1.0, ExerciseType::american, OptionRight::put, underlyingCode));
+			vanillaOptionsPtr->push_back(make_shared<VanillaOption>(strike, 1.0, ExerciseType::european, OptionRight::call, underlyingCode));
+		}
+
+		// Tree and lattice prices with smoothing
+		TreePricer treePricer(blackScholesModel);
+		auto treePrices = treePricer.price(300, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		treePricer.setUseRecombiningLattice(true);
+		auto latticePrices = treePricer.price(300, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		for (int o = 0; o < vanillaOptionsPtr->size(); o++)
+		{
+			if (abs(*treePrices->at(o) - *latticePrices->at(o)) > 1.0e-12)
+			{
+				testPass = false;
+				std::cout << "Strike: " << vanillaOptionsPtr->at(o)->getStrike() << "\t Tree Price: " << *treePrices->at(o)
+					<< "\t Lattice Price: " << *latticePrices->at(o) << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests the accuracy contract of the fast normal distribution against boost over [-40, 40], and that the analytic and smoothed tree
+	//// prices with the fast normal distribution are close to those with boost
+	bool BlackScholesModelTest14()
+	{
+		// Sweep the normal distribution
+		auto testPass = true;
+		boost::math::normal z;
+		auto maxCdfError = 0.0;
+		auto maxPdfError = 0.0;
+		for (int i = 0; i <= 800000; i++)
+		{
+			auto x = -40.0 + 0.0001 * i;
+			maxCdfError = max(maxCdfError, abs(utilities::NormalDistribution::cdf(x) - boost::math::cdf(z, x)));
+			auto pdf = boost::math::pdf(z, x);
+			if (abs(x) < 37.5)
+				maxPdfError = max(maxPdfError, abs(utilities::NormalDistribution::pdf(x) - pdf) / pdf);
+		}
+		testPass = maxCdfError <= utilities::NormalDistribution::maxCdfAbsoluteError 
+			&& maxPdfError <= utilities::NormalDistribution::maxPdfRelativeError
+			&& utilities::NormalDistribution::cdf(-40.0) == 0.0 && utilities::NormalDistribution::cdf(40.0) == 1.0
+			&& utilities::NormalDistribution::pdf(40.0) == 0.0;
+		if (!testPass)
+			std::cout << "Max CDF Error: " << maxCdfError << "\t Max PDF Relative Error: " << maxPdfError << std::endl;
+
+		// The array functions must give the same values as the scalar functions
+		vector<double> x, cdfValues(1001), pdfValues(1001);
+		for (int i = 0; i <= 1000; i++)
+			x.push_back(-10.0 + 0.02 * i);
+		utilities::NormalDistribution::cdf(x.data(), (int)x.size(), cdfValues.data());
+		utilities::NormalDistribution::pdf(x.data(), (int)x.size(), pdfValues.data());
+		for (int i = 0; i < x.size(); i++)
+			testPass = testPass && cdfValues[i] == utilities::NormalDistribution::cdf(x[i]) 
+				&& pdfValues[i] == utilities::NormalDistribution::pdf(x[i]);
+
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		auto europeanOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>();
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>();
+		for (auto strike : { 60.0, 90.0, 100.0, 110.0, 160.0 })
+		{
+			europeanOptionsPtr->push_back(make_shared<VanillaOption>(strike, 1.0, ExerciseType::european, OptionRight::call, underlyingCode));
+			europeanOptionsPtr->push_back(make_shared<VanillaOption>(strike, 1.0, ExerciseType::european, OptionRight::put, underlyingCode));
+			vanillaOptionsPtr->push_back(make_shared<VanillaOption>(strike, 1.0, ExerciseType::american, OptionRight::put, underlyingCode));
+			vanillaOptionsPtr->push_back(make_shared<VanillaOption>(strike, 1.0, ExerciseType::european, OptionRight::call, underlyingCode));
+		}
+
+		// Analytic prices
+		AnalyticPricer analyticPricer(blackScholesModel);
+		auto boostAnalyticPrices = analyticPricer.price(europeanOptionsPtr);
+		analyticPricer.setNormalDistributionImplementation(NormalDistributionImplementation::fast);
+		auto fastAnalyticPrices = analyticPricer.price(europeanOptionsPtr);
+
+		// Tree and lattice prices with smoothing
+		TreePricer treePricer(blackScholesModel);
+		auto boostTreePrices = treePricer.price(300, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		treePricer.setNormalDistributionImplementation(NormalDistributionImplementation::fast);
+		auto fastTreePrices = treePricer.price(300, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+		treePricer.setUseRecombiningLattice(true);
+		auto fastLatticePrices = treePricer.price(300, vanillaOptionsPtr, true, Implementation::One, 6.0, -6.0);
+
+		for (int o = 0; o < europeanOptionsPtr->size(); o++)
+		{
+			if (abs(*boostAnalyticPrices->at(o) - *fastAnalyticPrices->at(o)) > 1.0e-12
+				|| abs(*boostTreePrices->at(o) - *fastTreePrices->at(o)) > 1.0e-12
+				|| abs(*boostTreePrices->at(o) - *fastLatticePrices->at(o)) > 1.0e-12)
+			{
+				testPass = false;
+				std::cout << "Option: " << o << "\t Boost Analytic Price: " << *boostAnalyticPrices->at(o) << "\t Fast Analytic Price: " 
+					<< *fastAnalyticPrices->at(o) << "\t Boost Tree Price: " << *boostTreePrices->at(o) << "\t Fast Tree Price: " 
+					<< *fastTreePrices->at(o) << "\t Fast Lattice Price: " << *fastLatticePrices->at(o) << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests that the batch prices of a set of quotes, each with its own market data, are those of the analytic solution of the Black Scholes
+	//// model, exactly with the boost normal distribution and to within 1e-12 with the fast normal distribution
+	bool BlackScholesModelTest15()
+	{
+		// Generate quotes
+		auto nOptions = 1000;
+		mt19937 generator(11);
+		uniform_real_distribution<> uniform(0.0, 1.0);
+		vector<double> underlyingPrices, strikes, timesToExpiry, discountRates, costsOfCarry, impliedVolatilities;
+		vector<OptionRight> optionRights;
+		for (int i = 0; i < nOptions; i++)
+		{
+			underlyingPrices.push_back(50.0 + 100.0 * uniform(generator));
+			strikes.push_back(50.0 + 100.0 * uniform(generator));
+			timesToExpiry.push_back(0.01 + 5.0 * uniform(generator));
+			discountRates.push_back(0.1 * uniform(generator));
+			costsOfCarry.push_back(0.05 * uniform(generator));
+			impliedVolatilities.push_back(0.05 + 0.6 * uniform(generator));
+			optionRights.push_back(i % 2 == 0 ? OptionRight::call : OptionRight::put);
+		}
+
+		// Batch prices
+		vector<double> boostPrices(nOptions), fastPrices(nOptions);
+		BlackScholesBatchPricer::price(nOptions, underlyingPrices.data(), strikes.data(), timesToExpiry.data(), discountRates.data(),
+			costsOfCarry.data(), impliedVolatilities.data(), optionRights.data(), boostPrices.data(), NormalDistributionImplementation::boost);
+		BlackScholesBatchPricer::price(nOptions, underlyingPrices.data(), strikes.data(), timesToExpiry.data(), discountRates.data(),
+			costsOfCarry.data(), impliedVolatilities.data(), optionRights.data(), fastPrices.data(), NormalDistributionImplementation::fast);
+
+		// Compare against the analytic solution of the model
+		auto testPass = true;
+		for (int i = 0; i < nOptions; i++)
+		{
+			models::BlackScholes blackScholesModel(costsOfCarry[i], discountRates[i], impliedVolatilities[i], underlyingPrices[i], 
+				UnderlyingCode::BHP);
+			auto price = *blackScholesModel.calculateAnalyticSolution(strikes[i], timesToExpiry[i], optionRights[i], ExerciseType::european);
+			if (boostPrices[i] != price || abs(fastPrices[i] - price) > 1.0e-12)
+			{
+				testPass = false;
+				std::cout << "Quote: " << i << "\t Price: " << price << "\t Boost Batch Price: " << boostPrices[i] 
+					<< "\t Fast Batch Price: " << fastPrices[i] << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests the analytic Greeks of the Black Scholes model against central finite differences of the analytic price, and that the Greeks of 
+	//// the analytic and batch pricers are those of the model
+	bool BlackScholesModelTest16()
+	{
+		// Model parameters
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto price = [&](const double underlyingPrice, const double volatility, const double rate, const double strike, const double time, 
+			const OptionRight optionRight)
+		{
+			models::BlackScholes blackScholesModel(costOfCarry, rate, volatility, underlyingPrice, underlyingCode);
+			return *blackScholesModel.calculateAnalyticSolution(strike, time, optionRight, ExerciseType::european);
+		};
+
+		// Compare against finite differences
+		auto testPass = true;
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>();
+		for (auto optionRight : { OptionRight::call, OptionRight::put })
+		{
+			for (auto strike : { 80.0, 100.0, 120.0 })
+			{
+				for (auto timeToExpiry : { 0.25, 1.0, 3.0 })
+				{
+					vanillaOptionsPtr->push_back(make_shared<VanillaOption>(strike, timeToExpiry, ExerciseType::european, optionRight, 
+						underlyingCode));
+					auto greeks = blackScholesModel->calculateAnalyticGreeks(strike, timeToExpiry, optionRight, ExerciseType::european);
+					auto S = initialUnderlyingPrice;
+					auto h = 0.01;
+					auto delta = (price(S + h, impliedVolatility, discountRate, strike, timeToExpiry, optionRight) 
+						- price(S - h, impliedVolatility, discountRate, strike, timeToExpiry, optionRight)) / (2.0 * h);
+					auto gamma = (price(S + h, impliedVolatility, discountRate, strike, timeToExpiry, optionRight) 
+						- 2.0 * price(S, impliedVolatility, discountRate, strike, timeToExpiry, optionRight)
+						+ price(S - h, impliedVolatility, discountRate, strike, timeToExpiry, optionRight)) / (h * h);
+					auto vega = (price(S, impliedVolatility + 1.0e-5, discountRate, strike, timeToExpiry, optionRight)
+						- price(S, impliedVolatility - 1.0e-5, discountRate, strike, timeToExpiry, optionRight)) / 2.0e-5;
+					auto theta = -(price(S, impliedVolatility, discountRate, strike, timeToExpiry + 1.0e-5, optionRight)
+						- price(S, impliedVolatility, discountRate, strike, timeToExpiry - 1.0e-5, optionRight)) / 2.0e-5;
+					auto rho = (price(S, impliedVolatility, discountRate + 1.0e-5, strike, timeToExpiry, optionRight)
+						- price(S, impliedVolatility, discountRate - 1.0e-5, strike, timeToExpiry, optionRight)) / 2.0e-5;
+					if (greeks.price != price(S, impliedVolatility, discountRate, strike, timeToExpiry, optionRight)
+						|| abs(greeks.delta - delta) > 1.0e-6 || abs(greeks.gamma - gamma) > 1.0e-5 || abs(greeks.vega - vega) > 1.0e-5
+						|| abs(greeks.theta - theta) > 1.0e-5 || abs(greeks.rho - rho) > 1.0e-5)
+					{
+						testPass = false;
+						std::cout << "Strike: " << strike << "\t Time: " << timeToExpiry << "\t Delta: " << greeks.delta << " vs " << delta
+							<< "\t Gamma: " << greeks.gamma << " vs " << gamma << "\t Vega: " << greeks.vega << " vs " << vega
+							<< "\t Theta: " << greeks.theta << " vs " << theta << "\t Rho: " << greeks.rho << " vs " << rho << std::endl;
+					}
+				}
+			}
+		}
+
+		// The analytic pricer and the batch pricer
+		AnalyticPricer analyticPricer(blackScholesModel);
+		auto analyticGreeks = analyticPricer.priceWithGreeks(vanillaOptionsPtr);
+		auto nOptions = (int)vanillaOptionsPtr->size();
+		vector<double> underlyingPrices(nOptions, initialUnderlyingPrice), strikes, timesToExpiry, discountRates(nOptions, discountRate),
+			costsOfCarry(nOptions, costOfCarry), impliedVolatilities(nOptions, impliedVolatility);
+		vector<OptionRight> optionRights;
+		for (auto& vanillaOption : *vanillaOptionsPtr)
+		{
+			strikes.push_back(vanillaOption->getStrike());
+			timesToExpiry.push_back(vanillaOption->getTimeToExpiry());
+			optionRights.push_back(vanillaOption->getOptionRight());
+		}
+		vector<models::Greeks> boostGreeks(nOptions), fastGreeks(nOptions);
+		BlackScholesBatchPricer::priceWithGreeks(nOptions, underlyingPrices.data(), strikes.data(), timesToExpiry.data(), discountRates.data(),
+			costsOfCarry.data(), impliedVolatilities.data(), optionRights.data(), boostGreeks.data(), NormalDistributionImplementation::boost);
+		BlackScholesBatchPricer::priceWithGreeks(nOptions, underlyingPrices.data(), strikes.data(), timesToExpiry.data(), discountRates.data(),
+			costsOfCarry.data(), impliedVolatilities.data(), optionRights.data(), fastGreeks.data(), NormalDistributionImplementation::fast);
+		for (int o = 0; o < nOptions; o++)
+		{
+			auto& greeks = analyticGreeks[o];
+			auto pass = greeks.price == *analyticPricer.price(vanillaOptionsPtr->at(o))
+				&& boostGreeks[o].price == greeks.price && boostGreeks[o].delta == greeks.delta && boostGreeks[o].gamma == greeks.gamma
+				&& boostGreeks[o].vega == greeks.vega && boostGreeks[o].theta == greeks.theta && boostGreeks[o].rho == greeks.rho
+				&& abs(fastGreeks[o].price - greeks.price) < 1.0e-12 && abs(fastGreeks[o].delta - greeks.delta) < 1.0e-12 
+				&& abs(fastGreeks[o].gamma - greeks.gamma) < 1.0e-12 && abs(fastGreeks[o].vega - greeks.vega) < 1.0e-12 
+				&& abs(fastGreeks[o].theta - greeks.theta) < 1.0e-12 && abs(fastGreeks[o].rho - greeks.rho) < 1.0e-12;
+			if (!pass)
+			{
+				testPass = false;
+				std::cout << "The batch Greeks of option " << o << " do not match the Greeks of the model." << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests the delta, gamma and theta read off the tree against the analytic Greeks for European options, and against bumping and pricing 
+	//// on new trees for American options, and that the Greeks of the tree and the lattice agree
+	bool BlackScholesModelTest17()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto nTimeSteps = 1000;
+		auto upperLimitStandardDeviation = 50.0; // wide enough that the first time steps are not truncated
+		auto lowerLimitStandardDeviation = -50.0;
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>();
+		for (auto exerciseType : { ExerciseType::european, ExerciseType::american })
+			for (auto optionRight : { OptionRight::call, OptionRight::put })
+				for (auto strike : { 90.0, 100.0, 110.0 })
+					vanillaOptionsPtr->push_back(make_shared<VanillaOption>(strike, 1.0, exerciseType, optionRight, underlyingCode));
+
+		// Greeks from the tree and the lattice
+		TreePricer treePricer(blackScholesModel);
+		auto prices = treePricer.price(nTimeSteps, vanillaOptionsPtr, false, Implementation::One, upperLimitStandardDeviation, 
+			lowerLimitStandardDeviation);
+		auto treeGreeks = treePricer.priceWithGreeks(nTimeSteps, vanillaOptionsPtr, false, Implementation::One, upperLimitStandardDeviation, 
+			lowerLimitStandardDeviation);
+		treePricer.setUseRecombiningLattice(true);
+		auto latticeGreeks = treePricer.priceWithGreeks(nTimeSteps, vanillaOptionsPtr, false, Implementation::One, upperLimitStandardDeviation, 
+			lowerLimitStandardDeviation);
+
+		// Bumped prices for the American options, averaged over trees with n and n + 1 time steps to remove the odd-even oscillation of the 
+		// tree prices
+		auto bumpedPrice = [&](const double underlyingPrice, const double timeToExpiry, const shared_ptr<VanillaOption>& vanillaOption)
+		{
+			TreePricer bumpedTreePricer(make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, underlyingPrice,
+				underlyingCode));
+			auto bumpedOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>(1, make_shared<VanillaOption>(vanillaOption->getStrike(), 
+				timeToExpiry, vanillaOption->getExerciseType(), vanillaOption->getOptionRight(), underlyingCode));
+			return 0.5 * (*bumpedTreePricer.price(nTimeSteps, bumpedOptionsPtr, false, Implementation::One, upperLimitStandardDeviation, 
+				lowerLimitStandardDeviation)->at(0) + *bumpedTreePricer.price(nTimeSteps + 1, bumpedOptionsPtr, false, Implementation::One, 
+				upperLimitStandardDeviation, lowerLimitStandardDeviation)->at(0));
+		};
+
+		auto testPass = true;
+		for (int o = 0; o < vanillaOptionsPtr->size(); o++)
+		{
+			auto& vanillaOption = vanillaOptionsPtr->at(o);
+			auto& greeks = treeGreeks[o];
+			double delta, gamma, theta;
+			if (vanillaOption->getExerciseType() == ExerciseType::european)
+			{
+				auto analyticGreeks = blackScholesModel->calculateAnalyticGreeks(vanillaOption->getStrike(), 1.0, 
+					vanillaOption->getOptionRight(), ExerciseType::european);
+				delta = analyticGreeks.delta;
+				gamma = analyticGreeks.gamma;
+				theta = analyticGreeks.theta;
+			}
+			else
+			{
+				auto h = 2.0;
+				auto price = bumpedPrice(initialUnderlyingPrice, 1.0, vanillaOption);
+				auto upPrice = bumpedPrice(initialUnderlyingPrice + h, 1.0, vanillaOption);
+				auto downPrice = bumpedPrice(initialUnderlyingPrice - h, 1.0, vanillaOption);
+				delta = (upPrice - downPrice) / (2.0 * h);
+				gamma = (upPrice - 2.0 * price + downPrice) / (h * h);
+				theta = -(bumpedPrice(initialUnderlyingPrice, 1.01, vanillaOption) - bumpedPrice(initialUnderlyingPrice, 0.99, vanillaOption)) / 0.02;
+			}
+			auto& lattice = latticeGreeks[o];
+			if (greeks.price != *prices->at(o) || abs(greeks.delta - delta) > 2.0e-3 || abs(greeks.gamma - gamma) > 1.0e-3 
+				|| abs(greeks.theta - theta) > 5.0e-2 || !std::isnan(greeks.vega) || !std::isnan(greeks.rho)
+				|| abs(lattice.price - greeks.price) > 1.0e-12 || abs(lattice.delta - greeks.delta) > 1.0e-9 
+				|| abs(lattice.gamma - greeks.gamma) > 1.0e-9 || abs(lattice.theta - greeks.theta) > 1.0e-9)
+			{
+				testPass = false;
+				std::cout << "Option: " << o << "\t Delta: " << greeks.delta << " vs " << delta << "\t Gamma: " << greeks.gamma << " vs " 
+					<< gamma << "\t Theta: " << greeks.theta << " vs " << theta << "\t Lattice Delta: " << lattice.delta 
+					<< "\t Lattice Gamma: " << lattice.gamma << "\t Lattice Theta: " << lattice.theta << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests that the implied volatilities of batch prices over a wide range of strikes, including deep in and out of the money, are the 
+	//// volatilities the prices were calculated with, and that prices outside the no arbitrage bounds are reported as such
+	bool BlackScholesModelTest18()
+	{
+		// Generate quotes, with strikes out to more than three standard deviations either side of the forward price
+		auto nOptions = 2000;
+		mt19937 generator(13);
+		uniform_real_distribution<> uniform(0.0, 1.0);
+		vector<double> underlyingPrices, strikes, timesToExpiry, discountRates, costsOfCarry, impliedVolatilities;
+		vector<OptionRight> optionRights;
+		for (int i = 0; i < nOptions; i++)
+		{
+			underlyingPrices.push_back(100.0);
+			timesToExpiry.push_back(0.02 + 5.0 * uniform(generator));
+			discountRates.push_back(0.1 * uniform(generator));
+			costsOfCarry.push_back(0.05 * uniform(generator));
+			impliedVolatilities.push_back(0.05 + 1.0 * uniform(generator));
+			auto moneyness = (2.0 * uniform(generator) - 1.0) * 3.5 * impliedVolatilities[i] * sqrt(timesToExpiry[i]);
+			strikes.push_back(100.0 * exp(moneyness));
+			optionRights.push_back(i % 2 == 0 ? OptionRight::call : OptionRight::put);
+		}
+		vector<double> prices(nOptions);
+		BlackScholesBatchPricer::price(nOptions, underlyingPrices.data(), strikes.data(), timesToExpiry.data(), discountRates.data(),
+			costsOfCarry.data(), impliedVolatilities.data(), optionRights.data(), prices.data(), NormalDistributionImplementation::boost);
+
+		// Invert the prices, with both implementations of the normal distribution
+		auto testPass = true;
+		for (auto normalDistributionImplementation : { NormalDistributionImplementation::boost, NormalDistributionImplementation::fast })
+		{
+			vector<double> solvedVolatilities(nOptions);
+			vector<ImpliedVolatilityStatus> statuses(nOptions);
+			ImpliedVolatilitySolver::solve(nOptions, prices.data(), underlyingPrices.data(), strikes.data(), timesToExpiry.data(), 
+				discountRates.data(), costsOfCarry.data(), optionRights.data(), solvedVolatilities.data(), statuses.data(), 
+				normalDistributionImplementation);
+			for (int i = 0; i < nOptions; i++)
+			{
+				if (statuses[i] != ImpliedVolatilityStatus::converged || abs(solvedVolatilities[i] - impliedVolatilities[i]) > 1.0e-8)
+				{
+					testPass = false;
+					std::cout << "Quote: " << i << "\t Strike: " << strikes[i] << "\t Volatility: " << impliedVolatilities[i] 
+						<< "\t Implied Volatility: " << solvedVolatilities[i] << std::endl;
+				}
+			}
+		}
+
+		// Prices below the intrinsic value, at the intrinsic value, and at the upper bound
+		vector<double> boundaryPrices = { 19.0, 20.0, 100.0, 120.0 };
+		vector<double> boundaryUnderlyingPrices(4, 100.0), boundaryStrikes = { 80.0, 80.0, 80.0, 120.0 }, boundaryTimesToExpiry(4, 1.0);
+		vector<double> boundaryDiscountRates(4, 0.0), boundaryCostsOfCarry(4, 0.0);
+		vector<OptionRight> boundaryOptionRights = { OptionRight::call, OptionRight::call, OptionRight::call, OptionRight::put };
+		vector<double> boundaryVolatilities(4);
+		vector<ImpliedVolatilityStatus> boundaryStatuses(4);
+		ImpliedVolatilitySolver::solve(4, boundaryPrices.data(), boundaryUnderlyingPrices.data(), boundaryStrikes.data(), 
+			boundaryTimesToExpiry.data(), boundaryDiscountRates.data(), boundaryCostsOfCarry.data(), boundaryOptionRights.data(), 
+			boundaryVolatilities.data(), boundaryStatuses.data());
+		if (boundaryStatuses[0] != ImpliedVolatilityStatus::belowIntrinsic || !std::isnan(boundaryVolatilities[0])
+			|| boundaryStatuses[2] != ImpliedVolatilityStatus::aboveMaximum || !std::isnan(boundaryVolatilities[2])
+			|| boundaryStatuses[3] != ImpliedVolatilityStatus::aboveMaximum || !std::isnan(boundaryVolatilities[3]))
+		{
+			testPass = false;
+			std::cout << "Prices outside the bounds were not reported" << std::endl;
+		}
+		if (boundaryStatuses[1] != ImpliedVolatilityStatus::converged || boundaryVolatilities[1] != 0.0)
+		{
+			testPass = false;
+			std::cout << "Intrinsic Value Status: " << static_cast<int>(boundaryStatuses[1]) << "\t Implied Volatility: " 
+				<< boundaryVolatilities[1] << std::endl;
+		}
+		return testPass;
+	}
+
+	//// Tests that Monte Carlo prices simulated over a thread pool are those of the serial simulation for any number of threads, and that
+	//// they converge to the analytic prices
+	bool BlackScholesModelTest19()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.1;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		vector<shared_ptr<VanillaOption>> vanillaOptions;
+		for (auto timeToExpiry : { 0.5, 2.0 })
+		{
+			vanillaOptions.push_back(make_shared<VanillaOption>(95.0, timeToExpiry, ExerciseType::european, OptionRight::put, underlyingCode));
+			vanillaOptions.push_back(make_shared<VanillaOption>(105.0, timeToExpiry, ExerciseType::european, OptionRight::call, underlyingCode));
+		}
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		MonteCarloPricer serialPricer(blackScholesModel);
+		MonteCarloPricer singleThreadPricer(blackScholesModel);
+		singleThreadPricer.setThreadPool(make_shared<utilities::ThreadPool>(1));
+		MonteCarloPricer parallelPricer(blackScholesModel);
+		parallelPricer.setThreadPool(make_shared<utilities::ThreadPool>(4));
+		MonteCarloPricer otherParallelPricer(blackScholesModel);
+		otherParallelPricer.setThreadPool(make_shared<utilities::ThreadPool>(3));
+		AnalyticPricer analyticPricer(blackScholesModel);
+
+		// Price options
+		auto nPaths = 5000000;
+		auto seed = 5;
+		auto analyticPrices = analyticPricer.price(vanillaOptionsPtr);
+		auto serialPrices = serialPricer.price(nPaths, vanillaOptionsPtr, seed);
+		auto singleThreadPrices = singleThreadPricer.price(nPaths, vanillaOptionsPtr, seed);
+		auto parallelPrices = parallelPricer.price(nPaths, vanillaOptionsPtr, seed);
+		auto otherParallelPrices = otherParallelPricer.price(nPaths, vanillaOptionsPtr, seed);
+
+		// Check values, with a 0.5% tolerance on the analytic prices being about four standard errors for the out of the money put
+		auto testPass = true;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			auto absRelDiff = abs(100.0 * (*parallelPrices->at(i) - *analyticPrices->at(i)) / *analyticPrices->at(i));
+			if (*singleThreadPrices->at(i) != *serialPrices->at(i) || *parallelPrices->at(i) != *serialPrices->at(i) 
+				|| *otherParallelPrices->at(i) != *serialPrices->at(i) || absRelDiff > 0.5)
+			{
+				testPass = false;
+				std::cout << "Serial Price: " << *serialPrices->at(i)
+					<< "\t Single Thread Price: " << *singleThreadPrices->at(i)
+					<< "\t Parallel Price: " << *parallelPrices->at(i)
+					<< "\t Other Parallel Price: " << *otherParallelPrices->at(i)
+					<< "\t Analytic Price: " << *analyticPrices->at(i)
+					<< std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests the accuracy of the inverse normal distribution function against boost, that the generated rows of normal variates are those
+	//// generated on their own, and the mean and variance of the normal variates
+	bool BlackScholesModelTest20()
+	{
+		// The inverse normal distribution function, over the centre and far into both tails
+		boost::math::normal z; // normal variate with mean 0 and variance 1
+		vector<double> p;
+		for (int i = 1; i < 100000; i++)
+			p.push_back(0.00001 * i);
+		for (auto exponent = -53.0; exponent < -1.0; exponent += 0.01)
+		{
+			p.push_back(pow(2.0, exponent));
+			p.push_back(1.0 - pow(2.0, exponent));
+		}
+		vector<double> inverseCdfValues(p.size());
+		utilities::NormalDistribution::inverseCdf(p.data(), (int)p.size(), inverseCdfValues.data());
+		auto testPass = true;
+		auto maxInverseCdfError = 0.0;
+		for (int i = 0; i < p.size(); i++)
+		{
+			auto quantile = boost::math::quantile(z, p[i]);
+			if (quantile != 0.0)
+				maxInverseCdfError = max(maxInverseCdfError, abs(inverseCdfValues[i] - quantile) / abs(quantile));
+			testPass = testPass && inverseCdfValues[i] == utilities::NormalDistribution::inverseCdf(p[i]);
+		}
+		testPass = testPass && maxInverseCdfError <= utilities::NormalDistribution::maxInverseCdfRelativeError;
+		if (!testPass)
+			std::cout << "Max Inverse CDF Relative Error: " << maxInverseCdfError << std::endl;
+
+		// Normal variates, generated a chunk at a time and on their own
+		uint64_t key = 11;
+		auto nPaths = 1000000;
+		auto nVariates = 2;
+		utilities::NormalVariateGenerator normalVariateGenerator(key);
+		vector<double> normals(utilities::NormalVariateGenerator::chunkSize);
+		vector<double> sums(nVariates, 0.0), sumsOfSquares(nVariates, 0.0);
+		for (int first = 0; first < nPaths; first += utilities::NormalVariateGenerator::chunkSize)
+		{
+			auto n = min(utilities::NormalVariateGenerator::chunkSize, nPaths - first);
+			normalVariateGenerator.setChunk(first, n);
+			for (int v = nVariates - 1; v >= 0; v--) // the rows do not have to be requested in order
+			{
+				auto row = normalVariateGenerator.normals(v);
+				utilities::NormalVariateGenerator::generateNormals(key, first, n, v, normals.data());
+				for (int i = 0; i < n; i++)
+				{
+					testPass = testPass && row[i] == normals[i];
+					sums[v] += row[i];
+					sumsOfSquares[v] += row[i] * row[i];
+				}
+			}
+		}
+
+		// Check the moments, with tolerances of about five standard errors
+		for (int v = 0; v < nVariates; v++)
+		{
+			auto mean = sums[v] / nPaths;
+			auto variance = sumsOfSquares[v] / nPaths - mean * mean;
+			if (abs(mean) > 5.0 / sqrt(nPaths) || abs(variance - 1.0) > 5.0 * sqrt(2.0 / nPaths))
+			{
+				testPass = false;
+				std::cout << "Variate: " << v << "\t Mean: " << mean << "\t Variance: " << variance << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests that the Monte Carlo prices, for which the payoffs are summed a chunk of paths at a time, are those calculated from all of the
+	//// simulated underlying prices, for options with different times to expiry and a number of paths which is not a whole number of chunks
+	bool BlackScholesModelTest21()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		vector<shared_ptr<VanillaOption>> vanillaOptions;
+		for (auto timeToExpiry : { 1.0, 0.25 })
+		{
+			for (auto strike : { 80.0, 100.0, 120.0 })
+			{
+				vanillaOptions.push_back(make_shared<VanillaOption>(strike, timeToExpiry, ExerciseType::european, OptionRight::call, underlyingCode));
+				vanillaOptions.push_back(make_shared<VanillaOption>(strike, timeToExpiry, ExerciseType::european, OptionRight::put, underlyingCode));
+			}
+		}
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Price options
+		auto nPaths = 300001;
+		auto seed = 3;
+		MonteCarloPricer monteCarloPricer(blackScholesModel);
+		auto prices = monteCarloPricer.price(nPaths, vanillaOptionsPtr, seed);
+
+		// Check values against the prices from the simulated underlying prices, which are summed in a different order
+		auto testPass = true;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			auto& vanillaOption = vanillaOptionsPtr->at(i);
+			auto simulatedUnderlyingPrices = blackScholesModel->generateMonteCarloSimulations(nPaths, vanillaOption->getTimeToExpiry(), seed);
+			auto expectedPrice = MonteCarloPricer::price(discountRate, simulatedUnderlyingPrices, vanillaOption);
+			if (abs(*prices->at(i) - *expectedPrice) > 0.000000001 * *expectedPrice)
+			{
+				testPass = false;
+				std::cout << "Price: " << *prices->at(i) << "\t Expected Price: " << *expectedPrice << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests the standard errors and confidence intervals of the Monte Carlo prices against the analytic prices, and that the paths are 
+	//// simulated until the target error is reached or the maximum number of paths has been simulated
+	bool BlackScholesModelTest22()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+
+		auto blackScholesModel = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, initialUnderlyingPrice,
+			underlyingCode);
+
+		// Construct Vanilla Options
+		vector<shared_ptr<VanillaOption>> vanillaOptions;
+		for (auto timeToExpiry : { 0.5, 1.0 })
+		{
+			vanillaOptions.push_back(make_shared<VanillaOption>(100.0, timeToExpiry, ExerciseType::european, OptionRight::call, underlyingCode));
+			vanillaOptions.push_back(make_shared<VanillaOption>(90.0, timeToExpiry, ExerciseType::european, OptionRight::put, underlyingCode));
+		}
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		MonteCarloPricer monteCarloPricer(blackScholesModel);
+		AnalyticPricer analyticPricer(blackScholesModel);
+
+		// Price options, for a fixed number of paths
+		auto nPaths = 1000000;
+		auto seed = 9;
+		auto analyticPrices = analyticPricer.price(vanillaOptionsPtr);
+		auto prices = monteCarloPricer.price(nPaths, vanillaOptionsPtr, seed);
+		auto estimates = monteCarloPricer.estimate(nPaths, vanillaOptionsPtr, seed);
+
+		// Check values, with the analytic prices within four standard errors
+		auto testPass = true;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			auto& estimate = estimates->at(i);
+			auto halfWidth = boost::math::quantile(boost::math::normal(), 0.975) * estimate.standardError;
+			if (estimate.price != *prices->at(i) || estimate.nPaths != nPaths || estimate.standardError <= 0.0 
+				|| abs(estimate.lowerBound - (estimate.price - halfWidth)) > 0.000000000001 
+				|| abs(estimate.upperBound - (estimate.price + halfWidth)) > 0.000000000001
+				|| abs(estimate.price - *analyticPrices->at(i)) > 4.0 * estimate.standardError)
+			{
+				testPass = false;
+				std::cout << "Price: " << estimate.price << "\t Standard Error: " << estimate.standardError
+					<< "\t Confidence Interval: [" << estimate.lowerBound << ", " << estimate.upperBound << "]"
+					<< "\t Analytic Price: " << *analyticPrices->at(i) << std::endl;
+			}
+		}
+
+		// Price options to a target relative error, which is reached well within the maximum number of paths. The estimates must be those 
+		// for a fixed number of paths equal to the number of paths simulated.
+		auto targetRelativeError = 0.002;
+		auto maxPaths = 5000000;
+		auto adaptiveEstimates = monteCarloPricer.estimate(0.0, targetRelativeError, maxPaths, vanillaOptionsPtr, seed);
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			auto& adaptiveEstimate = adaptiveEstimates->at(i);
+			auto fixedEstimate = monteCarloPricer.estimate(adaptiveEstimate.nPaths, vanillaOptionsPtr, seed)->at(i);
+			if (adaptiveEstimate.nPaths >= maxPaths || adaptiveEstimate.standardError > targetRelativeError * adaptiveEstimate.price
+				|| adaptiveEstimate.price != fixedEstimate.price || adaptiveEstimate.standardError != fixedEstimate.standardError)
+			{
+				testPass = false;
+				std::cout << "Paths: " << adaptiveEstimate.nPaths << "\t Price: " << adaptiveEstimate.price 
+					<< "\t Standard Error: " << adaptiveEstimate.standardError << "\t Fixed Paths Price: " << fixedEstimate.price << std::endl;
+			}
+		}
+
+		// Price options to a target absolute error which cannot be reached, so that the maximum number of paths is simulated
+		maxPaths = 300000;
+		auto budgetEstimates = monteCarloPricer.estimate(0.000001, 0.0, maxPaths, vanillaOptionsPtr, seed);
+		for (auto& budgetEstimate : *budgetEstimates)
+			testPass = testPass && budgetEstimate.nPaths == maxPaths;
+		return testPass;
+	}
+
+	//// Tests that each backward induction kernel supported by the CPU gives exactly the values of the scalar kernel, for numbers of nodes and
+	//// options which are smaller than, equal to, and not a multiple of the vector widths, for European and American options
+	bool BlackScholesModelTest23()
+	{
+		auto testPass = true;
+		auto selectedImplementation = BackwardInductionKernel::getImplementation();
+		auto selectedName = string(BackwardInductionKernel::getImplementationName());
+		if (!BackwardInductionKernel::isSupported(selectedImplementation) || !BackwardInductionKernel::isSupported(KernelImplementation::scalar)
+			|| (selectedImplementation == KernelImplementation::scalar) != (selectedName == "scalar"))
+		{
+			testPass = false;
+			std::cout << "The selected kernel " << selectedName << " is not supported." << std::endl;
+		}
+
+		auto upProbability = 0.52;
+		auto downProbability = 0.48;
+		auto discountFactor = 0.999;
+		auto strike = 100.0;
+		for (auto implementation : { KernelImplementation::scalar, KernelImplementation::avx2, KernelImplementation::avx512 })
+		{
+			if (!BackwardInductionKernel::isSupported(implementation))
+				continue;
+			for (auto n : { 1, 3, 4, 7, 8, 9, 17 })
+			{
+				// Option values, underlying prices either side of the strike, and a mix of calls and puts, and European and American options
+				vector<double> futureValues, underlyingPrices, strikes, exerciseSigns, americanMasks;
+				for (int j = 0; j <= n; j++)
+				{
+					futureValues.push_back(5.0 + 3.0 * sin(1.0 + j));
+					underlyingPrices.push_back(strike + 10.0 * cos(2.0 + j));
+					strikes.push_back(strike + 5.0 * sin(3.0 + j));
+					exerciseSigns.push_back(j % 2 == 0 ? 1.0 : -1.0);
+					americanMasks.push_back(j % 3 == 0 ? 0.0 : 1.0);
+				}
+
+				// Over the nodes of a level, for a European and an American option, into a separate array and in place
+				for (auto exerciseSign : { 1.0, -1.0 })
+				{
+					for (auto americanMask : { 0.0, 1.0 })
+					{
+						vector<double> expectedValues(n), values(n), inPlaceValues(futureValues);
+						BackwardInductionKernel::stepOverNodes(KernelImplementation::scalar, expectedValues.data(), futureValues.data(), 
+							underlyingPrices.data(), n, upProbability, downProbability, discountFactor, strike, exerciseSign, americanMask);
+						BackwardInductionKernel::stepOverNodes(implementation, values.data(), futureValues.data(), underlyingPrices.data(), n,
+							upProbability, downProbability, discountFactor, strike, exerciseSign, americanMask);
+						BackwardInductionKernel::stepOverNodes(implementation, inPlaceValues.data(), inPlaceValues.data(), 
+							underlyingPrices.data(), n, upProbability, downProbability, discountFactor, strike, exerciseSign, americanMask);
+						for (int j = 0; j < n; j++)
+						{
+							if (values[j] != expectedValues[j] || inPlaceValues[j] != expectedValues[j])
+							{
+								testPass = false;
+								std::cout << "Kernel: " << (int)implementation << "\t Nodes: " << n << "\t Node: " << j 
+									<< "\t Value: " << values[j] << "\t In Place Value: " << inPlaceValues[j] 
+									<< "\t Scalar Value: " << expectedValues[j] << std::endl;
+							}
+						}
+					}
+				}
+
+				// Over a set of options, for a single node
+				vector<double> downValues(futureValues.begin() + 1, futureValues.end());
+				vector<double> expectedValues(n), values(n);
+				BackwardInductionKernel::stepOverOptions(KernelImplementation::scalar, expectedValues.data(), futureValues.data(), 
+					downValues.data(), strike, n, upProbability, downProbability, discountFactor, strikes.data(), exerciseSigns.data(), 
+					americanMasks.data());
+				BackwardInductionKernel::stepOverOptions(implementation, values.data(), futureValues.data(), downValues.data(), strike, n,
+					upProbability, downProbability, discountFactor, strikes.data(), exerciseSigns.data(), americanMasks.data());
+				for (int o = 0; o < n; o++)
+				{
+					if (values[o] != expectedValues[o])
+					{
+						testPass = false;
+						std::cout << "Kernel: " << (int)implementation << "\t Options: " << n << "\t Option: " << o 
+							<< "\t Value: " << values[o] << "\t Scalar Value: " << expectedValues[o] << std::endl;
+					}
+				}
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests the Philox generator against the known answers of the Random123 library for Philox 4x32-10, with the counter words in the order
+	//// of the lower and upper halves of the block index followed by those of the substream, and that the generator draws the same words
+	//// as the blocks, including after discarding words
+	bool BlackScholesModelTest24()
+	{
+		// Counters of zeros, ones, and the digits of pi, as { key, substream, block index }, along with the expected blocks
+		vector<tuple<uint64_t, uint64_t, uint64_t>> counters{ make_tuple(0x0000000000000000, 0x0000000000000000, 0x0000000000000000),
+			make_tuple(0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff), 
+			make_tuple(0x299f31d0a4093822, 0x0370734413198a2e, 0x85a308d3243f6a88) };
+		vector<utilities::Philox::Block> expectedBlocks{ { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+			{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } };
+
+		auto testPass = true;
+		for (int i = 0; i < counters.size(); i++)
+		{
+			auto block = utilities::Philox::block(get<0>(counters[i]), get<1>(counters[i]), get<2>(counters[i]));
+			if (block != expectedBlocks[i])
+			{
+				testPass = false;
+				std::cout << "Counter: " << i << std::hex << "\t Block: " << block[0] << " " << block[1] << " " << block[2] << " " << block[3] 
+					<< std::dec << std::endl;
+			}
+		}
+
+		// The generator against the blocks
+		auto key = 0x299f31d0a4093822;
+		auto substream = 7;
+		utilities::Philox generator(key, substream);
+		for (uint64_t blockIndex = 0; blockIndex < 3; blockIndex++)
+		{
+			auto block = utilities::Philox::block(key, substream, blockIndex);
+			for (int w = 0; w < 4; w++)
+				testPass = testPass && generator() == block[w];
+		}
+		generator.discard(5);
+		testPass = testPass && generator.getPosition() == 17 && generator() == utilities::Philox::block(key, substream, 4)[1];
+		if (!testPass)
+			std::cout << "The words drawn from the generator do not match the blocks." << std::endl;
+		return testPass;
+	}
+
 	//// Black Scholes Model : convergence comparison of Monte Carlo, CRR Tree and Tian Tree 
 	bool BlackScholesModelPerformanceTest()
 	{
@@ -337,5 +1577,115 @@ namespace tests
 		auto testPass = true;
 		return testPass;
 	}
+
+	//// Black Scholes Model : compares the time to calculate the underlying prices at all of the nodes of a tree, by exp at each node, by 
+	//// multiplying the price of the previous node, and in closed form from the precomputed prices of the top nodes and powers of d / u
+	bool BlackScholesModelNodeValuesPerformanceTest()
+	{
+		auto initialUnderlyingPrice = 100.0;
+		for (auto nTimeSteps : { 1000, 5000, 20000 })
+		{
+			shared_ptr<vector<double>> diffusionStatesPtr, diffusionProbabilitiesPtr;
+			tie(diffusionStatesPtr, diffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateDiffusionStatesAndProbabilities(
+				1.0 / (double)nTimeSteps, 0.3, 0.06, 0.03, Implementation::One);
+			auto upState = diffusionStatesPtr->at(0);
+			auto downState = diffusionStatesPtr->at(1);
+			vector<double> values(nTimeSteps + 1);
+			vector<double> previousValues(nTimeSteps + 1);
+
+			high_resolution_clock::time_point tStart = high_resolution_clock::now();
+			auto checksum = 0.0;
+			for (int i = 0; i < nTimeSteps + 1; i++)
+			{
+				for (int k = 0; k < i + 1; k++)
+					values[k] = initialUnderlyingPrice * exp((double)(i - k) * upState + (double)k * downState);
+				checksum += values[i / 2];
+			}
+			high_resolution_clock::time_point tEnd = high_resolution_clock::now();
+			std::cout << "Exp;" << nTimeSteps << ";checksum;" << checksum 
+				<< ";time;" << duration_cast<milliseconds>(tEnd - tStart).count() << std::endl;
+
+			tStart = high_resolution_clock::now();
+			checksum = 0.0;
+			auto upMultiplier = exp(upState);
+			auto downMultiplier = exp(downState);
+			previousValues[0] = initialUnderlyingPrice;
+			for (int i = 0; i < nTimeSteps + 1; i++)
+			{
+				values[0] = i == 0 ? initialUnderlyingPrice : previousValues[0] * upMultiplier;
+				for (int k = 1; k < i + 1; k++)
+					values[k] = previousValues[k - 1] * downMultiplier;
+				checksum += values[i / 2];
+				swap(values, previousValues);
+			}
+			tEnd = high_resolution_clock::now();
+			std::cout << "Multiplied;" << nTimeSteps << ";checksum;" << checksum
+				<< ";time;" << duration_cast<milliseconds>(tEnd - tStart).count() << std::endl;
+
+			tStart = high_resolution_clock::now();
+			checksum = 0.0;
+			RecombiningNodeValues nodeValues(initialUnderlyingPrice, upState, downState, nTimeSteps, 0, nTimeSteps);
+			for (int i = 0; i < nTimeSteps + 1; i++)
+			{
+				nodeValues.getValues(i, 0, i + 1, values.data());
+				checksum += values[i / 2];
+			}
+			tEnd = high_resolution_clock::now();
+			std::cout << "Closed Form;" << nTimeSteps << ";checksum;" << checksum
+				<< ";time;" << duration_cast<milliseconds>(tEnd - tStart).count() << std::endl;
+		}
+
+		auto testPass = true;
+		return testPass;
+	}
+	//// Black Scholes Model : throughput of the batch analytic prices of a million quotes, against the analytic pricer
+	bool BlackScholesModelBatchAnalyticPerformanceTest()
+	{
+		// Generate quotes
+		auto nOptions = 1000000;
+		mt19937 generator(11);
+		uniform_real_distribution<> uniform(0.0, 1.0);
+		vector<double> underlyingPrices, strikes, timesToExpiry, discountRates, costsOfCarry, impliedVolatilities, prices(nOptions);
+		vector<OptionRight> optionRights;
+		for (int i = 0; i < nOptions; i++)
+		{
+			underlyingPrices.push_back(50.0 + 100.0 * uniform(generator));
+			strikes.push_back(50.0 + 100.0 * uniform(generator));
+			timesToExpiry.push_back(0.01 + 5.0 * uniform(generator));
+			discountRates.push_back(0.1 * uniform(generator));
+			costsOfCarry.push_back(0.05 * uniform(generator));
+			impliedVolatilities.push_back(0.05 + 0.6 * uniform(generator));
+			optionRights.push_back(i % 2 == 0 ? OptionRight::call : OptionRight::put);
+		}
+
+		for (auto normalDistributionImplementation : { NormalDistributionImplementation::boost, NormalDistributionImplementation::fast })
+		{
+			high_resolution_clock::time_point tStart = high_resolution_clock::now();
+			BlackScholesBatchPricer::price(nOptions, underlyingPrices.data(), strikes.data(), timesToExpiry.data(), discountRates.data(),
+				costsOfCarry.data(), impliedVolatilities.data(), optionRights.data(), prices.data(), normalDistributionImplementation);
+			high_resolution_clock::time_point tEnd = high_resolution_clock::now();
+			std::cout << "Batch;" << (normalDistributionImplementation == NormalDistributionImplementation::fast ? "fast" : "boost") 
+				<< ";nOptions;" << nOptions << ";checksum;" << accumulate(prices.begin(), prices.end(), 0.0) 
+				<< ";time;" << duration_cast<milliseconds>(tEnd - tStart).count() << std::endl;
+		}
+
+		// One model and one vanilla option per quote, priced by the analytic pricer
+		high_resolution_clock::time_point tStart = high_resolution_clock::now();
+		AnalyticPricer analyticPricer;
+		auto checksum = 0.0;
+		for (int i = 0; i < nOptions; i++)
+		{
+			analyticPricer.setModel(make_shared<models::BlackScholes>(costsOfCarry[i], discountRates[i], impliedVolatilities[i], 
+				underlyingPrices[i], UnderlyingCode::BHP));
+			checksum += *analyticPricer.price(make_shared<VanillaOption>(strikes[i], timesToExpiry[i], ExerciseType::european, 
+				optionRights[i], UnderlyingCode::BHP));
+		}
+		high_resolution_clock::time_point tEnd = high_resolution_clock::now();
+		std::cout << "AnalyticPricer;boost;nOptions;" << nOptions << ";checksum;" << checksum
+			<< ";time;" << duration_cast<milliseconds>(tEnd - tStart).count() << std::endl;
+
+		auto testPass = true;
+		return testPass;
+	}
 }
 #endif // !__BLACKSCHOLESMODELTESTS_H__
@@ -11,8 +11,11 @@
 #include "../Enumerations/Implementation.h"
 #include "../Instruments/VanillaOption.h"
 #include "../Models/BlackScholesSingleNormalJump.h"
+#include "../Models/TreeModelUtilities/LogNormalDiffusionTreeHelper.h"
 #include "../Pricers/MonteCarloPricer.h"
+#include "../Pricers/AnalyticPricer.h"
 #include "../Pricers/TreePricer.h"
+#include "../Pricers/BranchingKernel.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -101,5 +104,432 @@ namespace tests
 		}
 		return testPass;
 	}
+
+	//// Black Scholes with Single Normal Jump Model : trees of models with different volatilities share a single cached topology, which is 
+	//// the same as a newly constructed topology, and the topology cache is bounded in size and can be cleared
+	bool BlackScholesSingleNormalJumpTest2()
+	{
+		// Construct Models, which share a topology cache
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto dividendAmount = 1.0;
+		auto dividendTime = 0.2;
+		auto jumpTime = 0.35;
+		auto jumpMean = 0.05;
+
+		auto treeTopologyCache = make_shared<TreeTopologyCache>(64 * 1024 * 1024);
+		auto blackScholesSingleNormalJumpModel1 = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, 0.1,
+			initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount, jumpTime, jumpMean, 0.2);
+		auto blackScholesSingleNormalJumpModel2 = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, 0.3,
+			initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount, jumpTime, jumpMean, 0.1);
+		blackScholesSingleNormalJumpModel1->setTreeTopologyCache(treeTopologyCache);
+		blackScholesSingleNormalJumpModel2->setTreeTopologyCache(treeTopologyCache);
+
+		// Construct Trees
+		auto nTimeSteps = 12;
+		auto timeToExpiry = 0.5;
+		auto tree1 = blackScholesSingleNormalJumpModel1->constructTree(nTimeSteps, timeToExpiry, Implementation::One, 6.0, -6.0);
+		auto tree2 = blackScholesSingleNormalJumpModel2->constructTree(nTimeSteps, timeToExpiry, Implementation::One, 6.0, -6.0);
+		auto topology = LogNormalDiffusionTreeHelper::constructJumpDiffusionTreeTopology(nTimeSteps, timeToExpiry, jumpTime, 10);
+
+		// Check values
+		auto testPass = tree1->getTopology() == tree2->getTopology() && tree1->getValues() != tree2->getValues()
+			&& tree2->getLevelOffsets() == topology->getLevelOffsets() && tree2->getFirstForwardIndex() == topology->getFirstForwardIndex()
+			&& tree2->getNodeBranchingIndex() == topology->getNodeBranchingIndex();
+		if (!testPass)
+			std::cout << "The trees do not share the same topology as a newly constructed topology." << std::endl;
+
+		// Check the cache counts and size, and that the topology is constructed again once the cache has been cleared
+		auto isCacheValid = treeTopologyCache->getNTopologies() == 1 && treeTopologyCache->getNHits() == 1 
+			&& treeTopologyCache->getNMisses() == 1 && treeTopologyCache->getNBytes() == topology->getNBytes();
+		treeTopologyCache->clear();
+		auto tree3 = blackScholesSingleNormalJumpModel1->constructTree(nTimeSteps, timeToExpiry, Implementation::One, 6.0, -6.0);
+		isCacheValid = isCacheValid && tree3->getTopology() != tree1->getTopology() && treeTopologyCache->getNMisses() == 2;
+
+		// A cache which is too small for the topology does not keep it, and a model without a cache constructs its own topology
+		treeTopologyCache->setMaxBytes(topology->getNBytes() - 1);
+		auto tree4 = blackScholesSingleNormalJumpModel1->constructTree(nTimeSteps, timeToExpiry, Implementation::One, 6.0, -6.0);
+		blackScholesSingleNormalJumpModel2->setTreeTopologyCache(nullptr);
+		auto tree5 = blackScholesSingleNormalJumpModel2->constructTree(nTimeSteps, timeToExpiry, Implementation::One, 6.0, -6.0);
+		isCacheValid = isCacheValid && treeTopologyCache->getNTopologies() == 0 && treeTopologyCache->getNBytes() == 0 
+			&& tree5->getTopology() != tree4->getTopology() && tree5->getLevelOffsets() == topology->getLevelOffsets();
+		if (!isCacheValid)
+		{
+			testPass = false;
+			std::cout << "Topologies: " << treeTopologyCache->getNTopologies() << "\t Hits: " << treeTopologyCache->getNHits()
+				<< "\t Misses: " << treeTopologyCache->getNMisses() << "\t Bytes: " << treeTopologyCache->getNBytes() << std::endl;
+		}
+		return testPass;
+	}
+
+	//// Black Scholes with Single Normal Jump Model : a tree which recombines after the jump prices European options close to the semi analytic 
+	//// price, i.e. the average of the Black Scholes prices after each of the discretised jumps, and close to the tree which branches out after 
+	//// the jump, whilst only growing linearly in size after the jump
+	bool BlackScholesSingleNormalJumpTest3()
+	{
+		// Construct Models
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto dividendAmount = 1.0;
+		auto dividendTime = 2.0; // after the expiry of the options
+		auto jumpTime = 0.98;
+		auto jumpMean = 0.02;
+		auto jumpVolatility = 0.1;
+
+		auto blackScholesSingleNormalJumpModel = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, impliedVolatility, 
+			initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount, jumpTime, jumpMean, jumpVolatility);
+		auto recombiningBlackScholesSingleNormalJumpModel = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, 
+			impliedVolatility, initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount, jumpTime, jumpMean, jumpVolatility);
+		recombiningBlackScholesSingleNormalJumpModel->setRecombineAfterJump(true);
+
+		// Construct Vanilla Options
+		auto vanillaOption1 = make_shared<VanillaOption>(90.0, 1.0, ExerciseType::european, OptionRight::put, UnderlyingCode::BHP);
+		auto vanillaOption2 = make_shared<VanillaOption>(100.0, 1.0, ExerciseType::european, OptionRight::call, UnderlyingCode::BHP);
+		auto vanillaOption3 = make_shared<VanillaOption>(110.0, 1.0, ExerciseType::european, OptionRight::put, UnderlyingCode::BHP);
+		vector<shared_ptr<VanillaOption>> vanillaOptions{ vanillaOption1, vanillaOption2, vanillaOption3 };
+		auto vanillaOptionsPtr = make_shared < vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Semi analytic prices
+		shared_ptr<vector<double>> jumpStatesPtr, jumpProbabilitiesPtr;
+		tie(jumpStatesPtr, jumpProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateNormalJumpStatesAndProbabilities(jumpMean,
+			jumpVolatility, jumpTime, 1.0);
+		vector<double> analyticPrices(vanillaOptionsPtr->size(), 0.0);
+		for (int s = 0; s < jumpStatesPtr->size(); s++)
+		{
+			auto blackScholes = make_shared<models::BlackScholes>(costOfCarry, discountRate, impliedVolatility, 
+				initialUnderlyingPrice * exp(jumpStatesPtr->at(s)), underlyingCode);
+			AnalyticPricer analyticPricer(blackScholes);
+			auto prices = analyticPricer.price(vanillaOptionsPtr);
+			for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+				analyticPrices[i] += jumpProbabilitiesPtr->at(s) * *prices->at(i);
+		}
+
+		// Tree prices. The jump falls 2 time steps before expiry for the tree which branches out after the jump.
+		TreePricer treePricer(blackScholesSingleNormalJumpModel);
+		TreePricer recombiningTreePricer(recombiningBlackScholesSingleNormalJumpModel);
+		auto treePrices = treePricer.price(100, vanillaOptionsPtr, false, Implementation::One, 6.0, -6.0);
+		auto recombiningTreePrices = recombiningTreePricer.price(100, vanillaOptionsPtr, false, Implementation::One, 6.0, -6.0);
+		auto convergedTreePrices = recombiningTreePricer.price(2000, vanillaOptionsPtr, false, Implementation::One, 6.0, -6.0);
+		auto recombiningTree = recombiningBlackScholesSingleNormalJumpModel->constructTree(2000, 1.0, Implementation::One, 6.0, -6.0);
+
+		// Check values
+		auto testPass = recombiningTree->getNNodes(2000) < 2100;
+		for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+		{
+			auto absRelDiff = abs(100.0 * (*recombiningTreePrices->at(i) - *treePrices->at(i)) / *treePrices->at(i));
+			auto absRelDiffAnalytic = abs(100.0 * (*convergedTreePrices->at(i) - analyticPrices[i]) / analyticPrices[i]);
+			std::cout << "Analytic Price: " << analyticPrices[i]
+				<< "\t Tree Price:" << *treePrices->at(i)
+				<< "\t Recombining Tree Price:" << *recombiningTreePrices->at(i)
+				<< "\t Converged Recombining Tree Price:" << *convergedTreePrices->at(i)
+				<< std::endl;
+
+			// Check for 0.5% error against the tree which branches out, and 0.1% error against the semi analytic price
+			if (absRelDiff > 0.5 || absRelDiffAnalytic > 0.1)
+				testPass = false;
+		}
+		return testPass;
+	}
+
+	//// Black Scholes with Single Normal Jump Model : the estimated size of the tree matches the constructed tree, both for the tree which
+	//// branches out after the jump and for the tree which recombines after the jump
+	bool BlackScholesSingleNormalJumpTest4()
+	{
+		// Construct Models
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto dividendAmount = 1.0;
+		auto dividendTime = 0.2;
+		auto jumpTime = 0.35;
+		auto jumpMean = 0.02;
+		auto jumpVolatility = 0.1;
+
+		auto blackScholesSingleNormalJumpModel = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, impliedVolatility, 
+			initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount, jumpTime, jumpMean, jumpVolatility);
+
+		// Compare the estimated and constructed trees
+		auto testPass = true;
+		vector<bool> recombineAfterJump{ false, true };
+		for (auto recombine : recombineAfterJump)
+		{
+			blackScholesSingleNormalJumpModel->setRecombineAfterJump(recombine);
+			auto tree = blackScholesSingleNormalJumpModel->constructTree(16, 0.5, Implementation::One, 6.0, -6.0);
+			auto estimate = blackScholesSingleNormalJumpModel->estimateTreeSize(16, 0.5, Implementation::One, 6.0, -6.0);
+			if (estimate.nNodes != tree->getNNodes() || estimate.nBranches != tree->getNBranches() 
+				|| estimate.nMaxLevelNodes != tree->getNNodes(16) || estimate.nBytes > tree->getNBytes())
+			{
+				testPass = false;
+				std::cout << "Recombine After Jump: " << recombine
+					<< "\t Estimated Nodes: " << estimate.nNodes << "\t Tree Nodes: " << tree->getNNodes()
+					<< "\t Estimated Branches: " << estimate.nBranches << "\t Tree Branches: " << tree->getNBranches()
+					<< "\t Estimated Bytes: " << estimate.nBytes << "\t Tree Bytes: " << tree->getNBytes()
+					<< std::endl;
+			}
+		}
+
+		// The size of a tree far too large to construct is still estimated
+		blackScholesSingleNormalJumpModel->setRecombineAfterJump(false);
+		auto estimate = blackScholesSingleNormalJumpModel->estimateTreeSize(2000, 0.5, Implementation::One, 6.0, -6.0);
+		return testPass && estimate.nBytes > 1.0e100;
+	}
+
+	//// Tests that the branching of the nodes of a jump diffusion tree is held in a few shared branchings, so that each node only stores its
+	//// first forward index and the index of its branching, rather than a forward index and probability for each of its branches
+	bool BlackScholesSingleNormalJumpTest5()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto dividendAmount = 1.0;
+		auto dividendTime = 0.2;
+		auto jumpTime = 0.35;
+		auto jumpMean = 0.02;
+		auto jumpVolatility = 0.1;
+
+		auto blackScholesSingleNormalJumpModel = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, impliedVolatility, 
+			initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount, jumpTime, jumpMean, jumpVolatility);
+		auto tree = blackScholesSingleNormalJumpModel->constructTree(16, 0.5, Implementation::One, 6.0, -6.0);
+
+		// Memory of the branching, i.e. everything except for the values, compared with a forward index and probability for every branch
+		auto nNodes = (double)tree->getNNodes();
+		auto nBranches = (double)tree->getNBranches();
+		auto branchingBytes = (double)tree->getNBytes() - nNodes * sizeof(double);
+		auto compressedRowBytes = (nNodes + 1.0) * sizeof(int) + nBranches * (sizeof(int) + sizeof(double));
+		std::cout << "Nodes: " << nNodes << "\t Branches: " << nBranches << "\t Branching Bytes: " << branchingBytes 
+			<< "\t Compressed Row Bytes: " << compressedRowBytes << std::endl;
+
+		// The 10 branches at the jump are described by a single branching
+		auto testPass = tree->getBranchings().size() == 3 && tree->getBranchProbabilities().size() == 2
+			&& tree->getBranchings()[2].nBranches == 10 && branchingBytes * 3.0 < compressedRowBytes;
+		for (int n = 0; n < tree->getNNodes() - tree->getNNodes(16); n++)
+			testPass = testPass && tree->getBranching(n).nBranches > 0;
+		return testPass;
+	}
+
+	//// Tests that the backward induction kernels specialised on the number of branches of the jump tree levels return the same values as a 
+	//// loop over the branches of each node, for a single option and for a set of options. The values are compared to a relative tolerance, as
+	//// the compiler may contract the multiplications and additions of either loop into fused multiply adds.
+	bool BlackScholesSingleNormalJumpTest6()
+	{
+		// Branch probabilities of the jump step of the single normal jump model, i.e. the diffusion probabilities times the jump probabilities
+		vector<double> probabilities;
+		for (int k = 0; k < LogNormalDiffusionTreeHelper::nNormalJumpStates; k++)
+			for (auto& diffusionProbability : { 0.52, 0.48 })
+				probabilities.push_back(diffusionProbability * LogNormalDiffusionTreeHelper::normalJumpProbabilities[k]);
+
+		auto testPass = true;
+		auto nNodes = 7;
+		auto discountFactor = 0.999;
+		for (auto nOptions : { 1, 3 })
+		{
+			vector<double> strikes{ 95.0, 100.0, 105.0 };
+			vector<double> exerciseSigns{ -1.0, 1.0, -1.0 };
+			vector<double> americanMasks{ 1.0, 0.0, 1.0 };
+			vector<double> underlyingPrices;
+			vector<int> firstForwardIndex;
+			for (int j = 0; j < nNodes; j++)
+			{
+				underlyingPrices.push_back(90.0 + 3.0 * j);
+				firstForwardIndex.push_back(j * 10);
+			}
+			vector<double> futureValues;
+			for (int j = 0; j < nNodes * 10 * nOptions; j++)
+				futureValues.push_back(fabs(sin(0.7 * j)) * 20.0);
+
+			// Expected values, from a loop over the branches
+			vector<double> expectedValues(nNodes * nOptions, 0.0);
+			for (int j = 0; j < nNodes; j++)
+				for (int o = 0; o < nOptions; o++)
+				{
+					auto value = 0.0;
+					for (int k = 0; k < 10; k++)
+						value += probabilities[k] * futureValues[(firstForwardIndex[j] + k) * nOptions + o];
+					expectedValues[j * nOptions + o] = fmax(value * discountFactor, 
+						americanMasks[o] * fmax(0.0, exerciseSigns[o] * (underlyingPrices[j] - strikes[o])));
+				}
+
+			vector<double> currentValues(nNodes * nOptions);
+			BranchingKernel<10>::stepOverNodes(currentValues.data(), futureValues.data(), underlyingPrices.data(), firstForwardIndex.data(), 
+				nNodes, nOptions, probabilities.data(), discountFactor, strikes.data(), exerciseSigns.data(), americanMasks.data());
+			auto isMatch = true;
+			for (int j = 0; j < nNodes * nOptions; j++)
+				isMatch = isMatch && abs(currentValues[j] - expectedValues[j]) <= 1.0e-13 * abs(expectedValues[j]);
+			if (!isMatch)
+			{
+				testPass = false;
+				std::cout << "The specialised kernel does not match the loop over the branches for " << nOptions << " options." << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests the delta, gamma and theta read off the tree of the single normal jump model against bumping and pricing on new trees
+	bool BlackScholesSingleNormalJumpTest7()
+	{
+		// Model parameters
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto dividendAmount = 1.0;
+		auto dividendTime = 2.0; // after the expiry of the options
+		auto jumpTime = 0.5;
+		auto jumpMean = 0.02;
+		auto jumpVolatility = 0.1;
+		auto nTimeSteps = 300;
+		auto upperLimitStandardDeviation = 50.0; // wide enough that the first time steps are not truncated
+		auto lowerLimitStandardDeviation = -50.0;
+		auto constructModel = [&](const double underlyingPrice, const double elapsedTime)
+		{
+			auto model = make_shared<models::BlackScholesSingleNormalJump>(costOfCarry, discountRate, impliedVolatility, underlyingPrice, 
+				underlyingCode, dividendTime - elapsedTime, dividendAmount, jumpTime - elapsedTime, jumpMean, jumpVolatility);
+			model->setRecombineAfterJump(true);
+			return model;
+		};
+
+		// Construct Vanilla Options
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>();
+		vanillaOptionsPtr->push_back(make_shared<VanillaOption>(100.0, 1.0, ExerciseType::american, OptionRight::put, underlyingCode));
+		vanillaOptionsPtr->push_back(make_shared<VanillaOption>(95.0, 1.0, ExerciseType::european, OptionRight::call, underlyingCode));
+
+		// Greeks from the tree
+		TreePricer treePricer(constructModel(initialUnderlyingPrice, 0.0));
+		auto prices = treePricer.price(nTimeSteps, vanillaOptionsPtr, false, Implementation::One, upperLimitStandardDeviation,
+			lowerLimitStandardDeviation);
+		auto treeGreeks = treePricer.priceWithGreeks(nTimeSteps, vanillaOptionsPtr, false, Implementation::One, upperLimitStandardDeviation,
+			lowerLimitStandardDeviation);
+
+		// Bumped prices, averaged over trees with n and n + 1 time steps to remove the odd-even oscillation of the tree prices. Theta is the
+		// change in the price as calendar time passes, so both the expiry and the jump draw closer.
+		auto bumpedPrice = [&](const double underlyingPrice, const double elapsedTime, const shared_ptr<VanillaOption>& vanillaOption)
+		{
+			TreePricer bumpedTreePricer(constructModel(underlyingPrice, elapsedTime));
+			auto bumpedOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>(1, make_shared<VanillaOption>(vanillaOption->getStrike(), 
+				1.0 - elapsedTime, vanillaOption->getExerciseType(), vanillaOption->getOptionRight(), underlyingCode));
+			return 0.5 * (*bumpedTreePricer.price(nTimeSteps, bumpedOptionsPtr, false, Implementation::One, upperLimitStandardDeviation, 
+				lowerLimitStandardDeviation)->at(0) + *bumpedTreePricer.price(nTimeSteps + 1, bumpedOptionsPtr, false, Implementation::One, 
+				upperLimitStandardDeviation, lowerLimitStandardDeviation)->at(0));
+		};
+
+		auto testPass = true;
+		for (int o = 0; o < vanillaOptionsPtr->size(); o++)
+		{
+			auto& vanillaOption = vanillaOptionsPtr->at(o);
+			auto& greeks = treeGreeks[o];
+			auto h = 2.0;
+			auto price = bumpedPrice(initialUnderlyingPrice, 0.0, vanillaOption);
+			auto upPrice = bumpedPrice(initialUnderlyingPrice + h, 0.0, vanillaOption);
+			auto downPrice = bumpedPrice(initialUnderlyingPrice - h, 0.0, vanillaOption);
+			auto delta = (upPrice - downPrice) / (2.0 * h);
+			auto gamma = (upPrice - 2.0 * price + downPrice) / (h * h);
+			auto theta = (bumpedPrice(initialUnderlyingPrice, 0.01, vanillaOption) - bumpedPrice(initialUnderlyingPrice, -0.01, vanillaOption)) 
+				/ 0.02;
+			if (greeks.price != *prices->at(o) || abs(greeks.delta - delta) > 5.0e-3 || abs(greeks.gamma - gamma) > 2.0e-3 
+				|| abs(greeks.theta - theta) > 1.0e-1)
+			{
+				testPass = false;
+				std::cout << "Option: " << o << "\t Delta: " << greeks.delta << " vs " << delta << "\t Gamma: " << greeks.gamma << " vs " 
+					<< gamma << "\t Theta: " << greeks.theta << " vs " << theta << std::endl;
+			}
+		}
+		return testPass;
+	}
+
+	//// Tests that snapping the jump diffusion states onto the grid keeps their mean and variance when the jump volatility is small relative to
+	//// the spacing of the grid, and that the snapping is refused when the grid is too coarse for the variance to be matched
+	bool BlackScholesSingleNormalJumpTest8()
+	{
+		// Model parameters
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto jumpTime = 0.5;
+		auto jumpMean = 0.02;
+		auto timeToExpiry = 1.0;
+		auto nTimeSteps = 100;
+		auto timeStepSize = timeToExpiry / (double)nTimeSteps;
+
+		// Mean and variance of the states, along with those after they are snapped onto the grid
+		auto moments = [](const vector<double>& states, const vector<double>& probabilities)
+		{
+			auto mean = 0.0;
+			auto variance = 0.0;
+			for (int s = 0; s < states.size(); s++)
+				mean += probabilities[s] * states[s];
+			for (int s = 0; s < states.size(); s++)
+				variance += probabilities[s] * pow(states[s] - mean, 2);
+			return make_tuple(mean, variance);
+		};
+		auto snappedStates = [](const vector<double>& diffusionStates, const int firstDownMoves, const int nGridPoints)
+		{
+			auto gridSpacing = diffusionStates[0] - diffusionStates[1];
+			vector<double> states(nGridPoints);
+			for (int k = 0; k < nGridPoints; k++)
+				states[k] = diffusionStates[0] - (double)(firstDownMoves + k) * gridSpacing;
+			return states;
+		};
+
+		auto testPass = true;
+		auto implementations = { Implementation::One, Implementation::Two };
+		auto jumpVolatilities = { 0.05, 0.01, 0.001 };
+		for (auto& implementation : implementations)
+		{
+			for (auto& jumpVolatility : jumpVolatilities)
+			{
+				shared_ptr<vector<double>> diffusionStatesPtr, diffusionProbabilitiesPtr, jumpStatesPtr, jumpProbabilitiesPtr, 
+					jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr;
+				tie(diffusionStatesPtr, diffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateDiffusionStatesAndProbabilities(
+					timeStepSize, impliedVolatility, discountRate, costOfCarry, implementation);
+				tie(jumpStatesPtr, jumpProbabilitiesPtr) = LogNormalDiffusionTreeHelper::calculateNormalJumpStatesAndProbabilities(jumpMean,
+					jumpVolatility, jumpTime, timeToExpiry);
+				tie(jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr) = LogNormalDiffusionTreeHelper::
+					calculateJumpDiffusionStatesAndProbabilities(jumpStatesPtr, diffusionStatesPtr, jumpProbabilitiesPtr, diffusionProbabilitiesPtr);
+
+				int firstDownMoves;
+				shared_ptr<vector<double>> snappedProbabilitiesPtr;
+				tie(firstDownMoves, snappedProbabilitiesPtr) = LogNormalDiffusionTreeHelper::snapJumpDiffusionStatesToGrid(jumpDiffusionStatesPtr,
+					jumpDiffusionProbabilitiesPtr, diffusionStatesPtr);
+
+				double mean, variance, snappedMean, snappedVariance;
+				tie(mean, variance) = moments(*jumpDiffusionStatesPtr, *jumpDiffusionProbabilitiesPtr);
+				tie(snappedMean, snappedVariance) = moments(snappedStates(*diffusionStatesPtr, firstDownMoves, 
+					(int)snappedProbabilitiesPtr->size()), *snappedProbabilitiesPtr);
+				if (abs(snappedMean - mean) > 1.0e-12 || abs(snappedVariance / variance - 1.0) > 1.0e-10)
+				{
+					testPass = false;
+					std::cout << "Jump Volatility: " << jumpVolatility << "\t Mean: " << snappedMean << " vs " << mean << "\t Variance: " 
+						<< snappedVariance << " vs " << variance << std::endl;
+				}
+			}
+		}
+
+		// Two states either side of the midpoint of the grid spacing, whose variance is below that added by splitting their mean between
+		// the grid points
+		auto diffusionStatesPtr = make_shared<vector<double>>(vector<double>{ 0.02, -0.02 });
+		auto jumpDiffusionStatesPtr = make_shared<vector<double>>(vector<double>{ -0.001, 0.001 });
+		auto jumpDiffusionProbabilitiesPtr = make_shared<vector<double>>(vector<double>{ 0.5, 0.5 });
+		auto isRefused = false;
+		try
+		{
+			LogNormalDiffusionTreeHelper::snapJumpDiffusionStatesToGrid(jumpDiffusionStatesPtr, jumpDiffusionProbabilitiesPtr, diffusionStatesPtr);
+		}
+		catch (const invalid_argument&)
+		{
+			isRefused = true;
+		}
+		return testPass && isRefused;
+	}
 }
 #endif // !__BLACKSCHOLESSINGLENORMALJUMPTESTS_H__
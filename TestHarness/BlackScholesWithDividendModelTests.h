@@ -119,5 +119,115 @@ namespace tests
 		}
 		return testPass;
 	}
+
+	//// Black Scholes with Dividend Model : compare pricing on the implicit recombining lattice against the materialised tree.
+	//// Both the lattice and the tree calculate the underlying price at each node from the closed form in RecombiningNodeValues, so the prices
+	//// should match up to rounding. The test therefore checks that the range of nodes on the lattice, with and without truncation, is 
+	//// consistent with the tree.
+	bool BlackScholesWithDividendModelTest2()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto dividendAmount = 10.0;
+		auto dividendTime = 0.51;
+
+		auto blackScholesWithDividendModel = make_shared<models::BlackScholesWithDividend>(costOfCarry, discountRate, impliedVolatility,
+			initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount);
+
+		// Construct Vanilla Options
+		vector<shared_ptr<VanillaOption>> vanillaOptions;
+		for (auto exerciseType : { ExerciseType::european, ExerciseType::american })
+			for (auto optionRight : { OptionRight::put, OptionRight::call })
+			{
+				vanillaOptions.push_back(make_shared<VanillaOption>(80.0, 0.5, exerciseType, optionRight, UnderlyingCode::BHP));
+				vanillaOptions.push_back(make_shared<VanillaOption>(100.0, 1.0, exerciseType, optionRight, UnderlyingCode::BHP));
+				vanillaOptions.push_back(make_shared<VanillaOption>(120.0, 2.0, exerciseType, optionRight, UnderlyingCode::BHP));
+			}
+		auto vanillaOptionsPtr = make_shared < vector<shared_ptr<VanillaOption>>>(move(vanillaOptions));
+
+		// Construct Pricers
+		TreePricer treePricer(blackScholesWithDividendModel);
+		TreePricer latticePricer(blackScholesWithDividendModel);
+		latticePricer.setUseRecombiningLattice(true);
+
+		// Price options, with and without truncation of the tree, and with and without smoothing
+		auto testPass = true;
+		for (auto implementation : { Implementation::One, Implementation::Two })
+			for (auto standardDeviation : { 6.0, 2.0 })
+				for (auto useVanillaOptionSmoothing : { false, true })
+				{
+					auto treePrices = treePricer.price(200, vanillaOptionsPtr, useVanillaOptionSmoothing, implementation, standardDeviation,
+						-standardDeviation);
+					auto latticePrices = latticePricer.price(200, vanillaOptionsPtr, useVanillaOptionSmoothing, implementation, standardDeviation,
+						-standardDeviation);
+
+					// Check values
+					for (int i = 0; i < vanillaOptionsPtr->size(); i++)
+					{
+						auto absDiff = abs(*latticePrices->at(i) - *treePrices->at(i));
+						if (absDiff > 0.0000001) {
+							testPass = false;
+							std::cout << "Lattice Price: " << *latticePrices->at(i)
+								<< "\t Tree Price:" << *treePrices->at(i)
+								<< "\t Absolute Difference:" << absDiff
+								<< std::endl;
+						}
+					}
+				}
+		return testPass;
+	}
+
+	//// Black Scholes with Dividend Model : tests that the Greeks are refused on the tree and the lattice when the dividend is deducted within
+	//// the first two time steps, as the levels they are read off are then shifted to ex-dividend prices, and that they are read off otherwise
+	bool BlackScholesWithDividendModelTest3()
+	{
+		// Construct Model
+		auto costOfCarry = 0.03;
+		auto discountRate = 0.06;
+		auto impliedVolatility = 0.2;
+		auto initialUnderlyingPrice = 100.0;
+		auto underlyingCode = UnderlyingCode::BHP;
+		auto dividendAmount = 2.0;
+		auto nTimeSteps = 200; // time steps of 0.005
+
+		// Construct Vanilla Options
+		auto vanillaOptionsPtr = make_shared<vector<shared_ptr<VanillaOption>>>(1, make_shared<VanillaOption>(100.0, 1.0, 
+			ExerciseType::american, OptionRight::put, underlyingCode));
+
+		auto testPass = true;
+		for (auto dividendTime : { 0.004, 0.009, 0.011, 0.5 })
+		{
+			auto blackScholesWithDividendModel = make_shared<models::BlackScholesWithDividend>(costOfCarry, discountRate, impliedVolatility,
+				initialUnderlyingPrice, underlyingCode, dividendTime, dividendAmount);
+			auto isRefused = dividendTime < 0.01;
+			for (auto useRecombiningLattice : { false, true })
+			{
+				TreePricer treePricer(blackScholesWithDividendModel);
+				treePricer.setUseRecombiningLattice(useRecombiningLattice);
+				auto isThrown = false;
+				try
+				{
+					auto greeks = treePricer.priceWithGreeks(nTimeSteps, vanillaOptionsPtr, false, Implementation::One, 50.0, -50.0);
+					isThrown = isThrown || std::isnan(greeks[0].delta) || !std::isnan(greeks[0].vega) || !std::isnan(greeks[0].rho);
+				}
+				catch (const invalid_argument&)
+				{
+					isThrown = true;
+				}
+				if (isThrown != isRefused)
+				{
+					testPass = false;
+					std::cout << "Dividend Time: " << dividendTime << "\t Lattice: " << useRecombiningLattice << "\t Refused: " << isThrown 
+						<< std::endl;
+				}
+			}
+		}
+		return testPass;
+	}
+
 }
 #endif // !__BLACKSCHOLESWITHDIVIDENDMODELTESTS_H__
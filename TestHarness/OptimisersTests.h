@@ -49,5 +49,25 @@ namespace tests
 		return testPass;
 	}
 
+	// Check that the optimiser is reproducible for a given seed, i.e. that the seed is used by the random number generation
+	bool OptimisersTest2()
+	{
+		function<double (const shared_ptr<vector<double>>&, const int&)> ackelysFunctionPtr = AckelysFunction;
+		auto lowerBoundsPtr = make_shared<vector<double>>(vector<double>{-5.0, -5.0});
+		auto upperBoundsPtr = make_shared<vector<double>>(vector<double>{5.0, 5.0});
+
+		DifferentialEvolution optimiser1(2, 0.5, 0.1, lowerBoundsPtr, upperBoundsPtr, ackelysFunctionPtr, Implementation::One, 1000, 7);
+		DifferentialEvolution optimiser2(2, 0.5, 0.1, lowerBoundsPtr, upperBoundsPtr, ackelysFunctionPtr, Implementation::One, 1000, 7);
+		auto solution1 = optimiser1.solve(0.05);
+		auto solution2 = optimiser2.solve(0.05);
+
+		// Check values
+		auto testPass = *solution1 == *solution2;
+		if (!testPass)
+			std::cout << "Solution 1 = (" << solution1->at(0) << ", " << solution1->at(1) << ")\t Solution 2 = (" << solution2->at(0) << ", " 
+				<< solution2->at(1) << ")" << std::endl;
+		return testPass;
+	}
+
 }
 #endif // !__OPTIMISERSTESTS_H__
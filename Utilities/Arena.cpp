@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include "Arena.h"
+
+using namespace std;
+
+utilities::Arena::Arena(const size_t& blockBytes)
+{
+	setBlockBytes(blockBytes);
+}
+
+const size_t utilities::Arena::getNReservedBytes() const
+{
+	size_t nReservedBytes = 0;
+	for (auto& block : m_blocks)
+		nReservedBytes += block.nBytes;
+	return nReservedBytes;
+}
+
+//// Returns nBytes of memory aligned to alignment (a power of 2). If the current block is full, the allocation moves on to the next block,
+//// which may have been kept from previous calls. If the allocation does not fit in an empty block, a larger block is inserted in front of
+//// it. The unused end of a block that is moved on from counts as allocated, so that rewinding to a mark restores the count exactly.
+void* utilities::Arena::allocate(const size_t& nBytes, const size_t& alignment)
+{
+	while (true)
+	{
+		if (m_blockIndex < m_blocks.size())
+		{
+			auto& block = m_blocks[m_blockIndex];
+			auto address = reinterpret_cast<uintptr_t>(block.data.get()) + m_offset;
+			auto padding = (alignment - address % alignment) % alignment;
+			if (m_offset + padding + nBytes <= block.nBytes)
+			{
+				m_offset += padding + nBytes;
+				m_nBytes += padding + nBytes;
+				m_peakBytes = max(m_peakBytes, m_nBytes);
+				return block.data.get() + (m_offset - nBytes);
+			}
+			if (m_offset > 0)
+			{
+				m_nBytes += block.nBytes - m_offset; // skip the rest of the block
+				m_blockIndex++;
+				m_offset = 0;
+				continue;
+			}
+		}
+
+		auto blockBytes = max(m_blockBytes, nBytes + alignment);
+		Block block{ unique_ptr<char[]>(new char[blockBytes]), blockBytes };
+		if (m_blockIndex < m_blocks.size())
+			m_blocks.insert(m_blocks.begin() + m_blockIndex, move(block));
+		else
+			m_blocks.push_back(move(block));
+	}
+}
+
+void utilities::Arena::release(const Mark& mark)
+{
+	if (mark.blockIndex > m_blockIndex || (mark.blockIndex == m_blockIndex && mark.offset > m_offset))
+		throw invalid_argument("The arena can only be released to a mark taken before its current allocations.");
+	m_blockIndex = mark.blockIndex;
+	m_offset = mark.offset;
+	m_nBytes = mark.nBytes;
+}
+
+void utilities::Arena::setBlockBytes(const size_t& value)
+{
+	if (value < 1)
+		throw invalid_argument("The size of the blocks of the arena must be greater than 0.");
+	m_blockBytes = value;
+}
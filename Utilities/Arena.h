@@ -0,0 +1,78 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace utilities
+{
+	//// A bump allocator for the scratch memory of a pricing call. Memory is handed out from large blocks by advancing an offset, and is never
+	//// freed individually. Instead, the arena is rewound to a mark taken before the allocations, which releases all of them in O(1) whilst 
+	//// keeping the blocks for reuse by the next call. Hence, repeated pricing (e.g. during a calibration) does not go back to the heap once
+	//// the blocks have grown to the size of the largest call. The peak number of bytes in use is recorded. The arena is not thread safe, so
+	//// each thread should allocate from its own arena.
+	class Arena
+	{
+	public:
+		struct Mark
+		{
+			size_t blockIndex;
+			size_t offset;
+			size_t nBytes;
+		};
+
+		Arena(const size_t& blockBytes);
+		Arena() = default;
+		~Arena() = default;
+
+		// Getters
+		const size_t& getBlockBytes() const { return m_blockBytes; }
+		const size_t& getNBytes() const { return m_nBytes; } // the bytes currently allocated
+		const size_t& getPeakBytes() const { return m_peakBytes; } // the most bytes allocated at once since construction or resetPeakBytes
+		const size_t getNReservedBytes() const; // the bytes held in blocks
+
+		void* allocate(const size_t& nBytes, const size_t& alignment);
+		const Mark getMark() const { return Mark{ m_blockIndex, m_offset, m_nBytes }; }
+		void release(const Mark& mark); // releases everything allocated since the mark was taken
+		void reset() { release(Mark{ 0, 0, 0 }); }
+		void resetPeakBytes() { m_peakBytes = m_nBytes; }
+
+		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
+		Arena& operator = (Arena const&) = delete;
+		Arena(Arena const&) = delete;
+
+	private:
+		struct Block
+		{
+			std::unique_ptr<char[]> data;
+			size_t nBytes;
+		};
+
+		size_t m_blockBytes = 1024 * 1024; // the size of each block, unless a larger allocation requires a larger block
+		std::vector<Block> m_blocks;
+		size_t m_blockIndex = 0; // the block currently being allocated from
+		size_t m_offset = 0; // the offset of the next allocation in the current block
+		size_t m_nBytes = 0;
+		size_t m_peakBytes = 0;
+
+		void setBlockBytes(const size_t& value);
+	};
+
+	//// Releases the allocations made from an arena within a scope, including when an exception is thrown. A null arena is ignored.
+	class ArenaScope
+	{
+	public:
+		ArenaScope(Arena* arena) : m_arena(arena), m_mark(arena != nullptr ? arena->getMark() : Arena::Mark{ 0, 0, 0 }) {}
+		~ArenaScope() { if (m_arena != nullptr) m_arena->release(m_mark); }
+
+		ArenaScope& operator = (ArenaScope const&) = delete;
+		ArenaScope(ArenaScope const&) = delete;
+
+	private:
+		Arena* m_arena;
+		Arena::Mark m_mark;
+	};
+}
+
+#endif // !__ARENA_H__
@@ -0,0 +1,48 @@
+#ifndef __ARENAALLOCATOR_H__
+#define __ARENAALLOCATOR_H__
+
+#include <cstddef>
+#include <new>
+#include "Arena.h"
+
+namespace utilities
+{
+	//// A standard library allocator which allocates from an Arena, so that containers such as std::vector can hold scratch memory from the
+	//// arena. Deallocation does nothing, as the memory is released by rewinding the arena. Without an arena, the allocator falls back to the
+	//// heap, so that the same container type can be used whether or not an arena has been provided.
+	template <typename T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+
+		ArenaAllocator(Arena* arena = nullptr) noexcept : m_arena(arena) {}
+		template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.getArena()) {}
+
+		Arena* getArena() const noexcept { return m_arena; }
+
+		T* allocate(const std::size_t n)
+		{
+			if (m_arena == nullptr)
+				return static_cast<T*>(::operator new(n * sizeof(T)));
+			return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* pointer, const std::size_t n) noexcept
+		{
+			if (m_arena == nullptr)
+				::operator delete(pointer);
+		}
+
+	private:
+		Arena* m_arena;
+	};
+
+	template <typename T, typename U>
+	bool operator == (const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return lhs.getArena() == rhs.getArena(); }
+
+	template <typename T, typename U>
+	bool operator != (const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return lhs.getArena() != rhs.getArena(); }
+}
+
+#endif // !__ARENAALLOCATOR_H__
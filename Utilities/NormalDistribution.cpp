@@ -0,0 +1,223 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "NormalDistribution.h"
+
+using namespace std;
+
+namespace
+{
+	//// e^y for y <= 0, without branches. y is split into k ln(2) + r with |r| <= ln(2) / 2, e^r is a Taylor polynomial which is accurate to
+	//// double precision on this range, and 2^k is assembled directly in the exponent bits. e^y is flushed to 0 below -708, where it is no
+	//// longer a normal double.
+	inline double expNonPositive(const double y)
+	{
+		const double log2e = 1.4426950408889634;
+		const double ln2Hi = 6.93147180369123816490e-01; // ln(2) split into a part with trailing zero bits, so that k * ln2Hi is exact
+		const double ln2Lo = 1.90821492927058770002e-10;
+		const double roundingShift = 6755399441055744.0; // 1.5 2^52, adding and subtracting which rounds to the nearest integer
+		const double exponentShift = 4503599627370496.0 + 1023.0; // 2^52 places k + 1023 in the low bits of the mantissa
+
+		auto clamped = y > -708.0 ? y : -708.0;
+		auto k = (clamped * log2e + roundingShift) - roundingShift; // rather than floor, which the compiler does not vectorise
+		auto r = (clamped - k * ln2Hi) - k * ln2Lo;
+
+		auto p = 1.0 / 6227020800.0; // 1 / 13!
+		p = p * r + 1.0 / 479001600.0;
+		p = p * r + 1.0 / 39916800.0;
+		p = p * r + 1.0 / 3628800.0;
+		p = p * r + 1.0 / 362880.0;
+		p = p * r + 1.0 / 40320.0;
+		p = p * r + 1.0 / 5040.0;
+		p = p * r + 1.0 / 720.0;
+		p = p * r + 1.0 / 120.0;
+		p = p * r + 1.0 / 24.0;
+		p = p * r + 1.0 / 6.0;
+		p = p * r + 0.5;
+		p = p * r + 1.0;
+		p = p * r + 1.0;
+
+		auto shifted = k + exponentShift;
+		int64_t bits;
+		memcpy(&bits, &shifted, sizeof(bits));
+		bits <<= 52;
+		double scale;
+		memcpy(&scale, &bits, sizeof(scale));
+		return y > -708.0 ? p * scale : 0.0;
+	}
+
+	inline double normalCdf(const double x)
+	{
+		const double oneOverSqrtTwoPi = 0.3989422804014327;
+		auto absX = fabs(x);
+		auto exponential = expNonPositive(-0.5 * absX * absX);
+
+		// Rational approximation, for |x| < 10 / sqrt(2)
+		auto numerator = 3.52624965998911e-02 * absX + 0.700383064443688;
+		numerator = numerator * absX + 6.37396220353165;
+		numerator = numerator * absX + 33.912866078383;
+		numerator = numerator * absX + 112.079291497871;
+		numerator = numerator * absX + 221.213596169931;
+		numerator = numerator * absX + 220.206867912376;
+		auto denominator = 8.83883476483184e-02 * absX + 1.75566716318264;
+		denominator = denominator * absX + 16.064177579207;
+		denominator = denominator * absX + 86.7807322029461;
+		denominator = denominator * absX + 296.564248779674;
+		denominator = denominator * absX + 637.333633378831;
+		denominator = denominator * absX + 793.826512519948;
+		denominator = denominator * absX + 440.413735824752;
+		auto rational = exponential * numerator / denominator;
+
+		// Continued fraction, for the tails
+		auto fraction = absX + 0.65;
+		fraction = absX + 4.0 / fraction;
+		fraction = absX + 3.0 / fraction;
+		fraction = absX + 2.0 / fraction;
+		fraction = absX + 1.0 / fraction;
+		auto tail = exponential * oneOverSqrtTwoPi / fraction;
+
+		auto lowerTail = absX < 7.07106781186547 ? rational : (absX <= 37.0 ? tail : 0.0); // Phi(-|x|)
+		return x > 0.0 ? 1.0 - lowerTail : lowerTail;
+	}
+
+	inline double normalPdf(const double x)
+	{
+		const double oneOverSqrtTwoPi = 0.3989422804014327;
+		return oneOverSqrtTwoPi * expNonPositive(-0.5 * x * x);
+	}
+
+	//// log(x) for normal doubles x > 0, without branches. x is split into m 2^k with sqrt(1/2) <= m < sqrt(2), and log(m) = 2 atanh(s) with
+	//// s = (m - 1) / (m + 1) is a series in s^2 which is accurate to double precision for |s| <= 0.172.
+	inline double logPositive(const double x)
+	{
+		const double ln2Hi = 6.93147180369123816490e-01;
+		const double ln2Lo = 1.90821492927058770002e-10;
+		const int64_t mantissaMask = 0x000FFFFFFFFFFFFFLL;
+		const int64_t exponentOfOne = 0x3FF0000000000000LL;
+
+		int64_t bits;
+		memcpy(&bits, &x, sizeof(bits));
+		auto k = (double)((bits >> 52) - 1023);
+		auto mantissaBits = (bits & mantissaMask) | exponentOfOne;
+		double m;
+		memcpy(&m, &mantissaBits, sizeof(m));
+		auto isAboveSqrtTwo = m > 1.4142135623730951;
+		m = isAboveSqrtTwo ? 0.5 * m : m;
+		k = isAboveSqrtTwo ? k + 1.0 : k;
+
+		auto s = (m - 1.0) / (m + 1.0);
+		auto s2 = s * s;
+		auto p = 1.0 / 23.0;
+		p = p * s2 + 1.0 / 21.0;
+		p = p * s2 + 1.0 / 19.0;
+		p = p * s2 + 1.0 / 17.0;
+		p = p * s2 + 1.0 / 15.0;
+		p = p * s2 + 1.0 / 13.0;
+		p = p * s2 + 1.0 / 11.0;
+		p = p * s2 + 1.0 / 9.0;
+		p = p * s2 + 1.0 / 7.0;
+		p = p * s2 + 1.0 / 5.0;
+		p = p * s2 + 1.0 / 3.0;
+		auto logM = 2.0 * s + 2.0 * s * s2 * p;
+		return k * ln2Hi + (logM + k * ln2Lo);
+	}
+
+	//// Wichura's algorithm AS 241 (PPND16), with the central and both tail approximations evaluated and then selected
+	inline double normalInverseCdf(const double p)
+	{
+		auto q = p - 0.5;
+
+		// Central region, for |q| <= 0.425
+		auto r = 0.180625 - q * q;
+		auto numerator = 2.5090809287301226727e+3 * r + 3.3430575583588128105e+4;
+		numerator = numerator * r + 6.7265770927008700853e+4;
+		numerator = numerator * r + 4.5921953931549871457e+4;
+		numerator = numerator * r + 1.3731693765509461125e+4;
+		numerator = numerator * r + 1.9715909503065514427e+3;
+		numerator = numerator * r + 1.3314166789178437745e+2;
+		numerator = numerator * r + 3.3871328727963666080e+0;
+		auto denominator = 5.2264952788528545610e+3 * r + 2.8729085735721942674e+4;
+		denominator = denominator * r + 3.9307895800092710610e+4;
+		denominator = denominator * r + 2.1213794301586595867e+4;
+		denominator = denominator * r + 5.3941960214247511077e+3;
+		denominator = denominator * r + 6.8718700749205790830e+2;
+		denominator = denominator * r + 4.2313330701600911252e+1;
+		denominator = denominator * r + 1.0;
+		auto central = q * numerator / denominator;
+
+		// Tails, in terms of sqrt(-log(min(p, 1 - p)))
+		auto tailProbability = q < 0.0 ? p : 1.0 - p;
+		auto t = sqrt(-logPositive(tailProbability > 1.0e-300 ? tailProbability : 1.0e-300));
+
+		auto u = t - 1.6; // for t <= 5
+		numerator = 7.74545014278341407640e-4 * u + 2.27238449892691845833e-2;
+		numerator = numerator * u + 2.41780725177450611770e-1;
+		numerator = numerator * u + 1.27045825245236838258e+0;
+		numerator = numerator * u + 3.64784832476320460504e+0;
+		numerator = numerator * u + 5.76949722146069140550e+0;
+		numerator = numerator * u + 4.63033784615654529590e+0;
+		numerator = numerator * u + 1.42343711074968357734e+0;
+		denominator = 1.05075007164441684324e-9 * u + 5.47593808499534494600e-4;
+		denominator = denominator * u + 1.51986665636164571966e-2;
+		denominator = denominator * u + 1.48103976427480074590e-1;
+		denominator = denominator * u + 6.89767334985100004550e-1;
+		denominator = denominator * u + 1.67638483018380384940e+0;
+		denominator = denominator * u + 2.05319162663775882187e+0;
+		denominator = denominator * u + 1.0;
+		auto nearTail = numerator / denominator;
+
+		auto v = t - 5.0; // for t > 5
+		numerator = 2.01033439929228813265e-7 * v + 2.71155556874348757815e-5;
+		numerator = numerator * v + 1.24266094738807843860e-3;
+		numerator = numerator * v + 2.65321895265761230930e-2;
+		numerator = numerator * v + 2.96560571828504891230e-1;
+		numerator = numerator * v + 1.78482653991729133580e+0;
+		numerator = numerator * v + 5.46378491116411436990e+0;
+		numerator = numerator * v + 6.65790464350110377720e+0;
+		denominator = 2.04426310338993978564e-15 * v + 1.42151175831644588870e-7;
+		denominator = denominator * v + 1.84631831751005468180e-5;
+		denominator = denominator * v + 7.86869131145613259100e-4;
+		denominator = denominator * v + 1.48753612908506148525e-2;
+		denominator = denominator * v + 1.36929880922735805310e-1;
+		denominator = denominator * v + 5.99832206555887937690e-1;
+		denominator = denominator * v + 1.0;
+		auto farTail = numerator / denominator;
+
+		auto tail = t <= 5.0 ? nearTail : farTail;
+		tail = q < 0.0 ? -tail : tail;
+		return fabs(q) <= 0.425 ? central : tail;
+	}
+}
+
+double utilities::NormalDistribution::cdf(const double x)
+{
+	return normalCdf(x);
+}
+
+double utilities::NormalDistribution::pdf(const double x)
+{
+	return normalPdf(x);
+}
+
+void utilities::NormalDistribution::cdf(const double* x, const int n, double* values)
+{
+	for (int i = 0; i < n; i++)
+		values[i] = normalCdf(x[i]);
+}
+
+void utilities::NormalDistribution::pdf(const double* x, const int n, double* values)
+{
+	for (int i = 0; i < n; i++)
+		values[i] = normalPdf(x[i]);
+}
+
+double utilities::NormalDistribution::inverseCdf(const double p)
+{
+	return normalInverseCdf(p);
+}
+
+void utilities::NormalDistribution::inverseCdf(const double* p, const int n, double* values)
+{
+	for (int i = 0; i < n; i++)
+		values[i] = normalInverseCdf(p[i]);
+}
@@ -0,0 +1,36 @@
+#ifndef __NORMALDISTRIBUTION_H__
+#define __NORMALDISTRIBUTION_H__
+
+namespace utilities
+{
+	//// The cumulative distribution function Phi(x) and the density phi(x) of the standard normal distribution. Phi is Hart's double precision
+	//// rational approximation (algorithm 5666, as given by West, "Better approximations to cumulative normal functions"), with a continued
+	//// fraction in the tails. The exponential is calculated with a branch free polynomial, and both sides of each branch are evaluated and
+	//// then selected, so that the loops over arrays of arguments can be vectorised by the compiler.
+	//// The absolute error of Phi against Boost over [-40, 40] is at most maxCdfAbsoluteError, and Phi(x) is exactly 0 below -37 and exactly 1
+	//// above 37. The relative error of phi is at most maxPdfRelativeError while phi(x) is a normal double, i.e. for |x| < 37.6, and phi(x) is
+	//// 0 beyond.
+	//// The inverse of Phi is Wichura's algorithm AS 241, with a branch free logarithm in the tails. Its relative error against Boost is at 
+	//// most maxInverseCdfRelativeError for 2^-54 <= p < 1.
+	class NormalDistribution
+	{
+	public:
+		static constexpr double maxCdfAbsoluteError = 1.0e-15;
+		static constexpr double maxPdfRelativeError = 2.0e-15;
+		static constexpr double maxInverseCdfRelativeError = 1.0e-15;
+
+		static double cdf(const double x);
+		static double pdf(const double x);
+		static double inverseCdf(const double p); // for 0 < p < 1
+
+		// Values of the function at the n arguments, written to values
+		static void cdf(const double* x, const int n, double* values);
+		static void pdf(const double* x, const int n, double* values);
+		static void inverseCdf(const double* p, const int n, double* values);
+
+	private:
+		NormalDistribution() {};
+	};
+}
+
+#endif // !__NORMALDISTRIBUTION_H__
@@ -0,0 +1,64 @@
+#include <stdexcept>
+#include <algorithm>
+#include "NormalVariateGenerator.h"
+#include "NormalDistribution.h"
+#include "Philox.h"
+
+using namespace std;
+
+constexpr int utilities::NormalVariateGenerator::chunkSize;
+
+utilities::NormalVariateGenerator::NormalVariateGenerator(const uint64_t& key) : m_key(key), m_firstPath(0), m_nPaths(0)
+{
+}
+
+void utilities::NormalVariateGenerator::setChunk(const uint64_t& firstPath, const int& nPaths)
+{
+	if (nPaths < 0 || nPaths > chunkSize)
+		throw invalid_argument("The number of paths in a chunk must be between 0 and the chunk size.");
+	m_firstPath = firstPath;
+	m_nPaths = nPaths;
+	fill(m_isNormalRowGenerated.begin(), m_isNormalRowGenerated.end(), false);
+	fill(m_isUniformRowGenerated.begin(), m_isUniformRowGenerated.end(), false);
+}
+
+const double* utilities::NormalVariateGenerator::normals(const int& variateIndex)
+{
+	return row(variateIndex, true);
+}
+
+const double* utilities::NormalVariateGenerator::uniforms(const int& variateIndex)
+{
+	return row(variateIndex, false);
+}
+
+const double* utilities::NormalVariateGenerator::row(const int& variateIndex, const bool isNormal)
+{
+	if (variateIndex < 0)
+		throw invalid_argument("The variate index must not be negative.");
+	auto& rows = isNormal ? m_normals : m_uniforms;
+	auto& isRowGenerated = isNormal ? m_isNormalRowGenerated : m_isUniformRowGenerated;
+	if (variateIndex >= (int)rows.size())
+	{
+		rows.resize(variateIndex + 1, vector<double>(chunkSize));
+		isRowGenerated.resize(variateIndex + 1, false);
+	}
+
+	auto values = rows[variateIndex].data();
+	if (!isRowGenerated[variateIndex])
+	{
+		if (isNormal)
+			generateNormals(m_key, m_firstPath, m_nPaths, variateIndex, values);
+		else
+			Philox::uniforms(m_key, m_firstPath, m_nPaths, variateIndex, values);
+		isRowGenerated[variateIndex] = true;
+	}
+	return values;
+}
+
+void utilities::NormalVariateGenerator::generateNormals(const uint64_t& key, const uint64_t& firstPath, const int& nPaths, 
+	const int& variateIndex, double* values)
+{
+	Philox::uniforms(key, firstPath, nPaths, variateIndex, values);
+	NormalDistribution::inverseCdf(values, nPaths, values);
+}
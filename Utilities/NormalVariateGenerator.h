@@ -0,0 +1,55 @@
+#ifndef __NORMALVARIATEGENERATOR_H__
+#define __NORMALVARIATEGENERATOR_H__
+
+#include <cstdint>
+#include <vector>
+
+namespace utilities
+{
+	//// Random variates for the Monte Carlo simulation of a chunk of paths. Variate v of path p is made from the uniform of block v of the 
+	//// Philox substream p of the key (see Philox::uniforms), so that any variate of any path can be generated on its own. The normal variates
+	//// are the inverse normal distribution function of the uniforms. The variates are generated a row at a time, i.e. variate v of every path
+	//// in the chunk, with loops which can be vectorised by the compiler, and each row is generated on its first request in the chunk.
+	//// As the normal and uniform variates with the same index are made from the same block, each index of a path should be used for either a
+	//// normal or a uniform variate, but not both.
+	class NormalVariateGenerator
+	{
+	public:
+		static constexpr int chunkSize = 256; // the maximum number of paths in a chunk, chosen so that the rows of a chunk stay in cache
+
+		NormalVariateGenerator(const uint64_t& key);
+		~NormalVariateGenerator() = default;
+
+		// Getters
+		const uint64_t& getKey() const { return m_key; }
+		const uint64_t& getFirstPath() const { return m_firstPath; }
+		const int& getNPaths() const { return m_nPaths; }
+
+		// Starts the chunk of nPaths paths from firstPath, discarding the variates of the previous chunk
+		void setChunk(const uint64_t& firstPath, const int& nPaths);
+
+		// Variate v of each of the paths of the chunk
+		const double* normals(const int& variateIndex);
+		const double* uniforms(const int& variateIndex);
+
+		// Normal variate v of the n paths from firstPath, written to values
+		static void generateNormals(const uint64_t& key, const uint64_t& firstPath, const int& nPaths, const int& variateIndex, double* values);
+
+		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
+		NormalVariateGenerator& operator = (NormalVariateGenerator const&) = delete;
+		NormalVariateGenerator(NormalVariateGenerator const&) = delete;
+
+	private:
+		uint64_t m_key;
+		uint64_t m_firstPath;
+		int m_nPaths;
+		std::vector<std::vector<double>> m_normals; // rows of variates, by variate index
+		std::vector<std::vector<double>> m_uniforms;
+		std::vector<bool> m_isNormalRowGenerated;
+		std::vector<bool> m_isUniformRowGenerated;
+
+		const double* row(const int& variateIndex, const bool isNormal);
+	};
+}
+
+#endif // !__NORMALVARIATEGENERATOR_H__
@@ -0,0 +1,67 @@
+#include "Philox.h"
+
+using namespace std;
+
+namespace
+{
+	const uint32_t multiplier0 = 0xD2511F53;
+	const uint32_t multiplier1 = 0xCD9E8D57;
+	const uint32_t weyl0 = 0x9E3779B9; // the golden ratio
+	const uint32_t weyl1 = 0xBB67AE85; // sqrt(3) - 1
+	const int nRounds = 10;
+}
+
+utilities::Philox::Philox(const uint64_t& key, const uint64_t& substream) : m_key(key), m_substream(substream), m_blockIndex(0),
+	m_wordIndex(4), m_block()
+{
+}
+
+void utilities::Philox::discard(const unsigned long long nWords)
+{
+	auto position = getPosition() + nWords;
+	m_blockIndex = position / 4;
+	m_wordIndex = 4;
+	if (position % 4 != 0)
+	{
+		nextBlock();
+		m_wordIndex = (int)(position % 4);
+	}
+}
+
+void utilities::Philox::nextBlock()
+{
+	m_block = block(m_key, m_substream, m_blockIndex);
+	m_blockIndex++;
+	m_wordIndex = 0;
+}
+
+//// Each round multiplies two of the words of the counter into 64 bit products, and mixes the high and low halves of the products with the
+//// other two words and the round key. The round key is bumped by the Weyl sequence constants between rounds.
+utilities::Philox::Block utilities::Philox::block(const uint64_t& key, const uint64_t& substream, const uint64_t& blockIndex)
+{
+	Block counter = { (uint32_t)blockIndex, (uint32_t)(blockIndex >> 32), (uint32_t)substream, (uint32_t)(substream >> 32) };
+	auto key0 = (uint32_t)key;
+	auto key1 = (uint32_t)(key >> 32);
+	for (int round = 0; round < nRounds; round++)
+	{
+		auto product0 = (uint64_t)multiplier0 * counter[0];
+		auto product1 = (uint64_t)multiplier1 * counter[2];
+		counter = { (uint32_t)(product1 >> 32) ^ counter[1] ^ key0, (uint32_t)product1, (uint32_t)(product0 >> 32) ^ counter[3] ^ key1,
+			(uint32_t)product0 };
+		key0 += weyl0;
+		key1 += weyl1;
+	}
+	return counter;
+}
+
+//// The uniform is (2^26 a + b + 1/2) / 2^52, with a and b the upper 26 bits of the first and second words. It is between 2^-53 and 
+//// 1 - 2^-53, which are exact in double precision, so that it is never 0 or 1 and can be passed to the inverse of a distribution function.
+void utilities::Philox::uniforms(const uint64_t& key, const uint64_t& firstSubstream, const int n, const uint64_t& blockIndex, double* values)
+{
+	const double twoToMinus52 = 1.0 / 4503599627370496.0;
+	for (int i = 0; i < n; i++)
+	{
+		auto words = block(key, firstSubstream + i, blockIndex);
+		values[i] = ((double)(words[0] >> 6) * 67108864.0 + (double)(words[1] >> 6) + 0.5) * twoToMinus52;
+	}
+}
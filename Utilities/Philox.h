@@ -0,0 +1,60 @@
+#ifndef __PHILOX_H__
+#define __PHILOX_H__
+
+#include <cstdint>
+#include <array>
+
+namespace utilities
+{
+	//// Philox 4x32-10 counter based random number generator (Salmon, Moraes, Dror and Shaw, "Parallel Random Numbers: As Easy as 1, 2, 3", 
+	//// 2011). Each 128 bit counter is encrypted with a 64 bit key by ten rounds of multiplications and xors, to give a block of four 32 bit
+	//// words. The key and a 64 bit substream index identify a stream, with the substream in the upper half of the counter and the index of
+	//// the block within the substream in the lower half. Any substream, at any position, can therefore be generated independently of all of
+	//// the others, without skipping ahead. This is what allows e.g. a Monte Carlo path or a Differential Evolution candidate to be generated
+	//// from its index alone, so that parallel runs are reproducible however the work is scheduled.
+	//// The generator meets the requirements of a uniform random bit generator, so it can be used with the standard library distributions.
+	class Philox
+	{
+	public:
+		typedef uint32_t result_type;
+		typedef std::array<uint32_t, 4> Block;
+
+		Philox(const uint64_t& key, const uint64_t& substream);
+		Philox() : Philox(0, 0) {};
+		~Philox() = default;
+
+		// Getters
+		const uint64_t& getKey() const { return m_key; }
+		const uint64_t& getSubstream() const { return m_substream; }
+		uint64_t getPosition() const { return 4 * m_blockIndex + m_wordIndex - 4; } // the number of words drawn from the substream
+
+		// Uniform random bit generator
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT32_MAX; }
+		result_type operator()()
+		{
+			if (m_wordIndex == 4)
+				nextBlock();
+			return m_block[m_wordIndex++];
+		}
+		void discard(const unsigned long long nWords); // moves the position, without generating the words in between
+
+		// The block of four words at the index within the substream of the key
+		static Block block(const uint64_t& key, const uint64_t& substream, const uint64_t& blockIndex);
+
+		// Uniforms in (0, 1), with 52 random bits, from the first two words of the block at the index within each of the n substreams from 
+		// firstSubstream, written to values
+		static void uniforms(const uint64_t& key, const uint64_t& firstSubstream, const int n, const uint64_t& blockIndex, double* values);
+
+	private:
+		uint64_t m_key;
+		uint64_t m_substream;
+		uint64_t m_blockIndex; // the index of the next block to be generated
+		int m_wordIndex; // the index within m_block of the next word, with 4 once the block is used up
+		Block m_block;
+
+		void nextBlock();
+	};
+}
+
+#endif // !__PHILOX_H__
@@ -0,0 +1,125 @@
+#include <stdexcept>
+#include "ThreadPool.h"
+
+using namespace std;
+
+utilities::ThreadPool::ThreadPool(const int& nThreads)
+{
+	setNThreads(nThreads);
+	m_workers.reserve(m_nThreads - 1);
+	for (int t = 1; t < m_nThreads; t++)
+		m_workers.emplace_back(&ThreadPool::workerLoop, this, t);
+}
+
+utilities::ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+	m_startCondition.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+void utilities::ThreadPool::setNThreads(const int& value)
+{
+	if (value < 1)
+		throw invalid_argument("The thread pool must have at least one thread.");
+	m_nThreads = value;
+}
+
+//// Runs the body over the chunk of the range belonging to the thread
+void utilities::ThreadPool::runChunk(const int threadIndex, const int begin, const int end, 
+	const std::function<void(const int, const int)>& body)
+{
+	auto n = (long long)(end - begin);
+	auto chunkBegin = begin + (int)(n * threadIndex / m_nThreads);
+	auto chunkEnd = begin + (int)(n * (threadIndex + 1) / m_nThreads);
+	if (chunkBegin < chunkEnd)
+		body(chunkBegin, chunkEnd);
+}
+
+void utilities::ThreadPool::parallelFor(const int begin, const int end, const std::function<void(const int, const int)>& body)
+{
+	if (end <= begin)
+		return;
+	if (m_nThreads == 1)
+	{
+		body(begin, end);
+		return;
+	}
+
+	lock_guard<mutex> parallelForLock(m_parallelForMutex);
+
+	// Hand the loop to the workers
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_body = &body;
+		m_begin = begin;
+		m_end = end;
+		m_nPendingWorkers = m_nThreads - 1;
+		m_exception = nullptr;
+		m_generation++;
+	}
+	m_startCondition.notify_all();
+
+	// The calling thread processes the first chunk
+	exception_ptr exception = nullptr;
+	try
+	{
+		runChunk(0, begin, end, body);
+	}
+	catch (...)
+	{
+		exception = current_exception();
+	}
+
+	// Wait for the workers to finish
+	unique_lock<mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this] { return m_nPendingWorkers == 0; });
+	m_body = nullptr;
+	if (exception == nullptr)
+		exception = m_exception;
+	lock.unlock();
+	if (exception != nullptr)
+		rethrow_exception(exception);
+}
+
+void utilities::ThreadPool::workerLoop(const int threadIndex)
+{
+	auto generation = 0;
+	while (true)
+	{
+		const std::function<void(const int, const int)>* body;
+		int begin, end;
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, generation] { return m_isStopping || m_generation != generation; });
+			if (m_isStopping)
+				return;
+			generation = m_generation;
+			body = m_body;
+			begin = m_begin;
+			end = m_end;
+		}
+
+		exception_ptr exception = nullptr;
+		try
+		{
+			runChunk(threadIndex, begin, end, *body);
+		}
+		catch (...)
+		{
+			exception = current_exception();
+		}
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			if (exception != nullptr && m_exception == nullptr)
+				m_exception = exception;
+			m_nPendingWorkers--;
+		}
+		m_doneCondition.notify_one();
+	}
+}
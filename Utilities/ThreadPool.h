@@ -0,0 +1,55 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace utilities
+{
+	//// A fixed size pool of worker threads for data parallel loops. parallelFor splits a range of indices into one contiguous chunk per thread,
+	//// so that the split only depends on the range and the number of threads, and blocks until all chunks are done. The calling thread
+	//// processes the first chunk itself. Exceptions thrown by the body are rethrown on the calling thread.
+	class ThreadPool
+	{
+	public:
+		ThreadPool(const int& nThreads); // the total number of threads, including the calling thread
+		ThreadPool() : ThreadPool(std::max(1, (int)std::thread::hardware_concurrency())) {}; // one thread per core
+		~ThreadPool();
+
+		// Getters
+		const int& getNThreads() const { return m_nThreads; }
+
+		// Calls body(chunkBegin, chunkEnd) for each chunk of [begin, end)
+		void parallelFor(const int begin, const int end, const std::function<void(const int, const int)>& body);
+
+		// Delete the = operator and the copy constructor to ensure that copies are not inadvertently made
+		ThreadPool& operator = (ThreadPool const&) = delete;
+		ThreadPool(ThreadPool const&) = delete;
+
+	private:
+		int m_nThreads;
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::mutex m_parallelForMutex; // only one loop may be run on the pool at a time
+		std::condition_variable m_startCondition;
+		std::condition_variable m_doneCondition;
+		const std::function<void(const int, const int)>* m_body = nullptr;
+		int m_begin = 0;
+		int m_end = 0;
+		int m_generation = 0; // incremented for each loop, so that the workers can identify new work
+		int m_nPendingWorkers = 0;
+		bool m_isStopping = false;
+		std::exception_ptr m_exception;
+
+		void setNThreads(const int& value);
+		void workerLoop(const int threadIndex);
+		void runChunk(const int threadIndex, const int begin, const int end, const std::function<void(const int, const int)>& body);
+	};
+}
+
+#endif // !__THREADPOOL_H__